@@ -0,0 +1,129 @@
+// Copyright © 2025 Intel Corporation
+// SPDX-License-Identifier: Apache 2.0
+// LEGAL NOTICE: Your use of this software and any required dependent software (the “Software Package”)
+// is subject to the terms and conditions of the software license agreements for the Software Package,
+// which may also include notices, disclaimers, or license terms for third party or open source software
+// included in or with the Software Package, and your use indicates your acceptance of all such terms.
+// Please refer to the “third-party-programs.txt” or other similarly-named text file included with the
+// Software Package for additional details.
+
+#ifndef VPUNN_BOUNDED_SHARDED_MEMO_H
+#define VPUNN_BOUNDED_SHARDED_MEMO_H
+
+#include <algorithm>
+#include <mutex>
+#include <shared_mutex>
+#include <utility>
+#include <vector>
+
+#include "core/cache.h"
+
+namespace VPUNN {
+
+/**
+ * @brief A thread safe table of bounded size, remembers results so that a repeated computation is not done again.
+ *
+ * The table is split in shards, selected by shard_index() of the key hash, each shard with its own lock. A full shard
+ * is emptied before a new entry is added: the keys that repeat come back quickly, and no bookkeeping is done at hits.
+ *
+ * @tparam Table the map of one shard, from key_type to mapped_type
+ * @tparam ShardHash functor giving the hash of a key used to select its shard
+ */
+template <typename Table, typename ShardHash>
+class BoundedShardedMemo {
+public:
+    using Key = typename Table::key_type;
+    using Value = typename Table::mapped_type;
+
+    /**
+     * @brief Construct a new BoundedShardedMemo
+     *
+     * @param max_size maximum number of entries, zero disables the memo
+     * @param shards_count number of independently locked parts, limited to max_size
+     */
+    explicit BoundedShardedMemo(size_t max_size, size_t shards_count = DEFAULT_CACHE_SHARDS)
+            : shards(std::max<size_t>(1, std::min(std::max<size_t>(1, shards_count), max_size))),
+              shard_capacity{(max_size + shards.size() - 1) / shards.size()} {
+    }
+
+    /// @returns false if the memo was created with no room, nothing is remembered then
+    bool is_enabled() const {
+        return shard_capacity != 0;
+    }
+
+    /**
+     * @brief finds the entry of a key and lets the caller read it in place, under the lock of its shard
+     *
+     * @param key the key to look for
+     * @param reader called with the const value if the key is present
+     * @returns true if the key is present
+     */
+    template <typename Reader>
+    bool visit(const Key& key, Reader&& reader) const {
+        if (!is_enabled()) {
+            return false;
+        }
+        const Shard& shard{shard_of(key)};
+        std::shared_lock<std::shared_mutex> lock(shard.mtx);
+        const auto it{shard.table.find(key)};
+        if (it == shard.table.cend()) {
+            return false;
+        }
+        reader(it->second);
+        return true;
+    }
+
+    /**
+     * @brief remembers a value, replaces the previous one of the same key
+     *
+     * @param key the key
+     * @param value the value to remember
+     */
+    void add(Key key, Value value) {
+        if (!is_enabled()) {
+            return;
+        }
+        Shard& shard{shard_of(key)};
+        std::unique_lock<std::shared_mutex> lock(shard.mtx);
+        const auto it{shard.table.find(key)};
+        if (it != shard.table.end()) {
+            it->second = std::move(value);
+            return;
+        }
+        if (shard.table.size() >= shard_capacity) {
+            shard.table.clear();
+        }
+        shard.table.emplace(std::move(key), std::move(value));
+    }
+
+    /// @returns the number of remembered entries
+    size_t size() const {
+        size_t total{0};
+        for (const auto& shard : shards) {
+            std::shared_lock<std::shared_mutex> lock(shard.mtx);
+            total += shard.table.size();
+        }
+        return total;
+    }
+
+private:
+    /// an independent part of the memo, with its own lock
+    struct Shard {
+        Table table;                    ///< key to value
+        mutable std::shared_mutex mtx;  ///< protects table
+    };
+
+    std::vector<Shard> shards;    ///< never resized after construction
+    const size_t shard_capacity;  ///< max entries in one shard
+
+    const Shard& shard_of(const Key& key) const {
+        return shards[(shards.size() == 1) ? 0 : shard_index(ShardHash{}(key), shards.size())];
+    }
+    Shard& shard_of(const Key& key) {
+        return const_cast<Shard&>(std::as_const(*this).shard_of(key));
+    }
+};
+
+}  // namespace VPUNN
+
+#endif  // VPUNN_BOUNDED_SHARDED_MEMO_H
@@ -10,7 +10,9 @@
 #ifndef VPUNN_CACHE
 #define VPUNN_CACHE
 
-#include <list>
+#include <algorithm>
+#include <atomic>
+#include <deque>
 #include <map>
 #include <unordered_map>
 #include <optional>
@@ -19,14 +21,59 @@
 #include <thread>
 #include <filesystem>
 #include <shared_mutex>
+#include <utility>
 
 #include <cassert>
+#include <cctype>
 
 #include "core/persistent_cache.h"
 #include "core/utils.h"
 
 namespace VPUNN {
 
+/// default number of shards of the dynamic caches owned by the cost models/providers
+inline constexpr unsigned int DEFAULT_CACHE_SHARDS{16};
+
+/**
+ * @brief selects the shard of a key from its hash, for the caches/memos split in shards
+ *
+ * Multiplicative mixing, the shard is taken from the high bits of the product: the low bits of the product depend only
+ * on the low bits of the hash, that are the same for many workloads (FNV of floats). A 64 bit hash is folded first.
+ *
+ * @param hash the hash of the key
+ * @param shards_count number of shards, not zero
+ * @returns the shard index, in [0, shards_count)
+ */
+inline size_t shard_index(const uint64_t hash, const size_t shards_count) {
+    const uint32_t mixed{static_cast<uint32_t>(hash ^ (hash >> 32)) * 0x9E3779B1u};
+    return static_cast<size_t>((static_cast<uint64_t>(mixed) * shards_count) >> 32);
+}
+
+/**
+ * @brief the file used to keep the content of a dynamic cache between runs (warm start), if enabled.
+ *
+ * Enabled by the environment variable VPUNN_WARM_CACHE_DIR, the folder of the files. The file name contains the model
+ * nickname, the content of a file is also marked with it.
+ *
+ * @param model_nickname the model that produces the cached values, nothing is kept if empty
+ * @param cache_name distinguishes the caches of the same model
+ * @returns the file, or empty if not enabled
+ */
+inline std::string warm_cache_filename(const std::string& model_nickname, const std::string& cache_name) {
+    const auto folder{get_env_vars({"VPUNN_WARM_CACHE_DIR"}).at("VPUNN_WARM_CACHE_DIR")};
+    if (folder.empty() || model_nickname.empty()) {
+        return {};
+    }
+    std::string name{model_nickname + "." + cache_name};
+    std::replace_if(
+            name.begin(), name.end(),
+            [](const char c) {
+                return !(std::isalnum(static_cast<unsigned char>(c)) || (c == '_') || (c == '-') || (c == '.'));
+            },
+            '_');
+    return (std::filesystem::path{folder} / (name + ".cachebin")).string();
+}
+
 template <typename K, typename V>
 class FixedCacheAddON {
 protected:
@@ -36,9 +83,10 @@ protected:
             : deserialized_table{[&]() {
                   auto env_override = check_if_env_path_override();
                   if (!env_override.empty()) {
-                      return FixedCache(env_override);
+                      return FixedCache(env_override, FixedCacheStorage::FLAT);
                   }
-                  return FixedCache(decideCacheFilename(filename, prio2_loadIfPairedCacheExists));
+                  return FixedCache(decideCacheFilename(filename, prio2_loadIfPairedCacheExists),
+                                    FixedCacheStorage::FLAT);
               }()} {
     }
 
@@ -46,41 +94,70 @@ protected:
             : deserialized_table{[&]() {
                   auto env_override = check_if_env_path_override();
                   if (!env_override.empty()) {
-                      return FixedCache(env_override);
+                      return FixedCache(env_override, FixedCacheStorage::FLAT);
                   }
-                  return FixedCache(file_data, file_data_length);
+                  return FixedCache(file_data, file_data_length, FixedCacheStorage::FLAT);
               }()} {
     }
 
 protected:
-    bool contains(const K& wl) const {
+    /// the key used in the preloaded table, 32 bit entries. The fingerprint of the 64 bit entries
+    static uint32_t key_hash(const K& wl) {
         if constexpr (has_hash_v<K>) {
-            if (deserialized_table.contains(wl.hash()))
-                return true;
+            return wl.hash();
         } else {
-            if (deserialized_table.contains(NNDescriptor<float>(wl).hash()))
-                return true;
+            return NNDescriptor<float>(wl).hash();
         }
-        return false;
     }
 
-    std::optional<V> get(const K& wl) const {
-        // Check if the workload is in the deserialized table
-        uint32_t wlhash{0};
-        if constexpr (has_hash_v<K>) {
-            wlhash = wl.hash();
+    /// the key used in the preloaded table, 64 bit entries
+    static uint64_t key_hash64(const K& wl) {
+        if constexpr (has_hash64_v<K>) {
+            return wl.hash64();
         } else {
-            wlhash = NNDescriptor<float>(wl).hash();
+            return NNDescriptor<float>(wl).hash64();
+        }
+    }
+
+    bool contains(const K& wl) const {
+        return contains_preloaded(wl, key_hash(wl));
+    }
+
+    /// @param wlhash key_hash(wl), already known by the caller
+    bool contains_preloaded(const K& wl, const uint32_t wlhash) const {
+        if (deserialized_table.has_wide_keys()) {
+            return deserialized_table.contains(key_hash64(wl), wlhash);
         }
+        return deserialized_table.contains(wlhash);
+    }
+
+    std::optional<V> get(const K& wl) const {
+        // Check if the workload is in the deserialized table
+        return get_preloaded(wl, key_hash(wl));
+    }
 
+    /// @param wlhash key_hash(wl), already known by the caller. The 64 bit key is computed only if the preloaded
+    /// table has such entries
+    std::optional<V> get_preloaded(const K& wl, const uint32_t wlhash) const {
+        if (deserialized_table.has_wide_keys()) {
+            return deserialized_table.get(key_hash64(wl), wlhash);
+        }
         return deserialized_table.get(wlhash);
     }
 
+    /// @brief adds the entries of a snapshot made for the same model to the preloaded ones. Not thread safe
+    /// @returns the number of entries added
+    size_t merge_snapshot(const std::string& filename, const std::string& model_nickname,
+                          const int32_t descriptor_version) {
+        return deserialized_table.merge_cache_flat(filename, model_nickname, descriptor_version);
+    }
+
 private:
     /// loaded from file, must be loaded from a file with the same descriptor signature
     /// @note this is a draft implementation
-    /// This datatype knows it is a float Value and uint32 key. this beats the K, V template
-    const FixedCache deserialized_table;  // maybe send it as template, OR reuse V and hashable K?
+    /// This datatype knows it is a float Value and uint32/uint64 key. this beats the K, V template
+    /// Changes only at snapshot merge, before concurrent use
+    FixedCache deserialized_table;  // maybe send it as template, OR reuse V and hashable K?
 
     /// @brief Decide which cache file to load  (DRAFT
     /// @param filenamePrio1 the first filename to try to load. must be a valid name and extension.Must be empty to go
@@ -139,46 +216,68 @@ struct MapTypeSelector<std::vector<float>> {
 };
 
 /**
- * @brief a workload cache using LRU (least recent used) replacement policy
+ * @brief a workload cache with approximated LRU (least recent used) replacement policy
  * @tparam K is the Key type
  * @tparam V is the Value type
- * 
+ *
+ * The dynamic content is split in shards, selected by the key hash, each shard with its own lock.
+ * Recency is tracked with the CLOCK algorithm: a hit only sets a reference bit under a shared lock, so hits never
+ * serialize. At insertion, when the shard is full, the clock hand evicts the first entry not referenced since its last
+ * pass. With one shard and max_size 1 the behavior is the one of a plain LRU.
+ *
  * Uses std::unordered_map for O(1) average lookup when specialized (e.g., DPUWorkload, std::vector<float>)
  * Falls back to std::map for other types (O(log n) lookup)
  */
 template <typename K, typename V>
 class LRUCache : public FixedCacheAddON<K, V> {
 private:
-    typedef std::list<std::pair<K, V>> List;
-    typedef typename List::const_iterator List_Iter_cnst;
+    /// one cached element
+    struct Slot {
+        Slot(const K& k, const V& v): key{k}, value{v} {
+        }
+        std::optional<K> key;  ///< always set, optional only to allow replacing keys that are not assignable
+        V value;
+        mutable std::atomic<bool> referenced{false};  ///< set at each hit, cleared when the clock hand passes
+    };
 
     // Select map type based on key type
     // Uses unordered_map with custom hasher when MapTypeSelector is specialized (O(1) lookup)
     // Falls back to std::map for other types (O(log n) lookup)
-    typedef typename MapTypeSelector<K>::template type<List_Iter_cnst> Map;
-    typedef typename Map::const_iterator Map_Iter_cnst;
+    typedef typename MapTypeSelector<K>::template type<size_t> Map;  ///< key to position in slots
 
-    mutable List workloads;  ///< list with first being the most recently used key.
-    Map m_table;             ///< table for fast searching of keys  (contains pointers to list objects, as iterators)
+    /// an independent part of the cache, with its own lock
+    struct Shard {
+        std::deque<Slot> slots;  ///< grows up to capacity, then the slots are reused. Elements are never relocated
+        Map m_table;             ///< table for fast searching of keys (contains positions in slots)
+        size_t hand{0};          ///< clock hand, next eviction candidate
+        size_t capacity{0};      ///< max elements in this shard
 
-    const size_t max_size;
+        mutable std::shared_mutex mtx;  ///< Mutex to protect shared resources.
+    };
 
-    mutable std::shared_mutex mtx;  ///< Mutex to protect shared resources.
+    const size_t max_size;
+    std::vector<Shard> shards;  ///< never resized after construction
 
 public:
     /**
      * @brief Construct a new LRUCache object
      *
      * @param max_size the maximum size of the LRUCache
+     * @param shards_count number of independently locked parts. Limited to max_size, each shard gets an equal part of
+     * max_size
      */
     explicit LRUCache(size_t max_size, const std::string& filename = "",
-                      const std::string& prio2_loadIfPairedCacheExists = "")
-            : FixedCacheAddON<K, V>(filename, prio2_loadIfPairedCacheExists), max_size(max_size) {
+                      const std::string& prio2_loadIfPairedCacheExists = "", size_t shards_count = 1)
+            : FixedCacheAddON<K, V>(filename, prio2_loadIfPairedCacheExists),
+              max_size(max_size),
+              shards(make_shards(max_size, shards_count)) {
     }
 
     // const char* model_data, size_t model_data_length, bool copy_model_data
-    explicit LRUCache(size_t max_size, const char* file_data, size_t file_data_length)
-            : FixedCacheAddON<K, V>(file_data, file_data_length), max_size(max_size) {
+    explicit LRUCache(size_t max_size, const char* file_data, size_t file_data_length, size_t shards_count = 1)
+            : FixedCacheAddON<K, V>(file_data, file_data_length),
+              max_size(max_size),
+              shards(make_shards(max_size, shards_count)) {
     }
 
     /**
@@ -193,25 +292,36 @@ public:
         if (max_size == 0)
             return;
 
-        std::unique_lock<std::shared_mutex> lock(mtx);  // Exclusive lock for write
-
+        const uint32_t wlhash{FixedCacheAddON<K, V>::key_hash(wl)};
         // Check if the workload is already in the deserialized table
-        if (FixedCacheAddON<K, V>::contains(wl))
+        if (FixedCacheAddON<K, V>::contains_preloaded(wl, wlhash))
             return;
 
-        const Map_Iter_cnst& map_it{m_table.find(wl)};
-        if (map_it == m_table.cend()) {
-            // Insert items in the list and map
-            workloads.push_front({wl, value});         // adds a new element
-            m_table.insert({wl, workloads.cbegin()});  // would not add a new element if wl is already inside
+        Shard& shard{shard_of(wlhash)};
+        std::unique_lock<std::shared_mutex> lock(shard.mtx);  // Exclusive lock for write
 
-            clean_up_excess_elements();  // if size is exceeded
+        const auto map_it{shard.m_table.find(wl)};
+        if (map_it != shard.m_table.cend()) {
+            // wl already in table, keep old value, mark as recently used
+            shard.slots[map_it->second].referenced.store(true, std::memory_order_relaxed);
+            return;
+        }
+
+        if (shard.slots.size() < shard.capacity) {
+            shard.slots.emplace_back(wl, value);
+            shard.m_table.emplace(wl, shard.slots.size() - 1);
         } else {
-            // wl already in table, keep old value, move to first position
-            mark_as_most_recently_used(map_it);
+            const size_t victim{advance_to_victim(shard)};
+            Slot& slot{shard.slots[victim]};
+            shard.m_table.erase(*slot.key);
+            slot.key.emplace(wl);
+            slot.value = value;
+            slot.referenced.store(false, std::memory_order_relaxed);
+            shard.m_table.emplace(wl, victim);
+            shard.hand = (victim + 1) % shard.capacity;
         }
 
-        if (!check_consistency()) {
+        if (!check_consistency(shard)) {
             throw std::runtime_error("Cache consistency check failed after adding workload");
         }
     }
@@ -224,79 +334,125 @@ public:
      * @return std::optional<V> the value stored in the cache, or nothing if not available
      */
     std::optional<V> get(const K& wl, std::string* source = nullptr) const {
+        const uint32_t wlhash{FixedCacheAddON<K, V>::key_hash(wl)};
         // Check if the workload is in the deserialized table
         {
-            const std::optional<V> found{FixedCacheAddON<K, V>::get(wl)};
+            const std::optional<V> found{FixedCacheAddON<K, V>::get_preloaded(wl, wlhash)};
             if (found) {
                 if (source) *source = "fixed_cache";
                 return found;
             }
         }
 
-        // First, try to find the key with a shared lock
-        {
-            std::shared_lock<std::shared_mutex> lock(mtx);
-            auto map_it = m_table.find(wl);
-            if (map_it == m_table.cend()) {
-                return std::nullopt;
-            }
+        if (max_size == 0) {
+            return std::nullopt;
         }
 
-        // If found, acquire a unique lock and do the mutation
-        std::unique_lock<std::shared_mutex> lock(mtx);
-        auto map_it = m_table.find(wl);
-        if (map_it != m_table.cend()) {
-            mark_as_most_recently_used(map_it);
-            if (source) *source = "dyn_cache";
-            return (map_it->second->second);
-        } else {
+        const Shard& shard{shard_of(wlhash)};
+        std::shared_lock<std::shared_mutex> lock(shard.mtx);  // hits only mark the reference bit
+        const auto map_it{shard.m_table.find(wl)};
+        if (map_it == shard.m_table.cend()) {
             return std::nullopt;
         }
+        const Slot& slot{shard.slots[map_it->second]};
+        slot.referenced.store(true, std::memory_order_relaxed);
+        if (source) *source = "dyn_cache";
+        return slot.value;
     }
 
-private:
     /**
-     * @brief Remove a workload from the cache
+     * @brief writes the dynamic content in a cache file marked with the model nickname. The entries of a snapshot
+     * already in the file for the same model and descriptor version are kept, the dynamic values win. The file is
+     * replaced only once completely written. The entries are written with 64 bit keys and fingerprints.
      *
-     * @param wl the workload descriptor
+     * @param filename the snapshot file
+     * @param model_nickname the model that produced the values
+     * @param descriptor_version the version of the descriptors (keys), 0 if not relevant
+     * @returns true if written
      */
-    void remove(const K& wl) {
-        const Map_Iter_cnst& it{m_table.find(wl)};
-
-        if (it != m_table.cend()) {
-            m_table.erase(it->first);  // key is first
-        } else {
-            throw std::out_of_range("VPUNN Cache out of range, an element was not in table");
+    bool save_snapshot(const std::string& filename, const std::string& model_nickname,
+                       const int32_t descriptor_version = 0) const {
+        std::vector<SortedCacheTable::Element> entries;
+        std::vector<SortedCacheTable64::Element> entries64;
+        FixedCache previous{""};  // read back from the file, nothing of it is kept in memory between snapshots
+        previous.merge_cache_flat(filename, model_nickname, descriptor_version, &entries, &entries64);
+        for (const auto& shard : shards) {
+            std::shared_lock<std::shared_mutex> lock(shard.mtx);
+            for (const auto& slot : shard.slots) {
+                entries64.emplace_back(FixedCacheAddON<K, V>::key_hash64(*slot.key),
+                                       FixedCacheAddON<K, V>::key_hash(*slot.key), static_cast<float>(slot.value));
+            }
         }
+        CacheFileInfo file_info;
+        file_info.model_nickname = model_nickname;
+        file_info.descriptor_version = descriptor_version;
+        file_info.has_fingerprints = true;
+
+        // written in a temporary file with a name unique to this process and thread, then renamed: processes saving
+        // to the same file concurrently never publish a mixed or truncated snapshot
+        return FixedCache::write_entries(filename, std::move(entries), std::move(entries64), false, file_info);
+    }
 
-        workloads.pop_back();  // Remove the last element from the list
+    /**
+     * @brief adds the content of a snapshot to the preloaded entries, the values already preloaded are kept.
+     * A snapshot of another model or descriptor version is rejected. Must be done before the cache is used
+     * concurrently.
+     *
+     * @param filename the snapshot file
+     * @param model_nickname the model that produces the values now
+     * @param descriptor_version the version of the descriptors (keys) now, 0 if not relevant
+     * @returns the number of entries added
+     */
+    size_t load_snapshot(const std::string& filename, const std::string& model_nickname,
+                         const int32_t descriptor_version = 0) {
+        return FixedCacheAddON<K, V>::merge_snapshot(filename, model_nickname, descriptor_version);
+    }
+
+    /// @returns the number of shards used
+    size_t get_shards_count() const {
+        return shards.size();
+    }
 
-        if (!check_consistency()) {
-            throw std::runtime_error("Cache consistency check failed after removing workload");
+    /// @returns the number of elements in the dynamic part (not counting the preloaded ones)
+    size_t size() const {
+        size_t total{0};
+        for (const auto& shard : shards) {
+            std::shared_lock<std::shared_mutex> lock(shard.mtx);
+            total += shard.m_table.size();
         }
+        return total;
     }
 
-    /// deletes what exceeds the size
-    void clean_up_excess_elements() {
-        // delete the oldest ones that occupy more space than allowed
-        while (m_table.size() > max_size) {
-            const auto& oldest_item{workloads.back()};  // last
-            remove(oldest_item.first);                  // key is first in pair
+private:
+    static std::vector<Shard> make_shards(size_t max_size, size_t shards_count) {
+        const size_t n{std::max<size_t>(1, std::min(shards_count, max_size))};
+        std::vector<Shard> created(n);
+        for (size_t i = 0; i < n; ++i) {
+            created[i].capacity = max_size / n + ((i < (max_size % n)) ? 1 : 0);  // total is max_size
         }
+        return created;
+    }
+
+    const Shard& shard_of(const uint32_t wlhash) const {
+        return shards[(shards.size() == 1) ? 0 : shard_index(wlhash, shards.size())];
     }
-    
-    void mark_as_most_recently_used(const Map_Iter_cnst& map_it) const {
-        if (map_it != m_table.cend()) {                      // Move the workload to the beginning of the list
-            const List_Iter_cnst& list_it = map_it->second;  // second is the list iterator
-            workloads.splice(workloads.cbegin(), workloads, list_it);
+
+    Shard& shard_of(const uint32_t wlhash) {
+        return const_cast<Shard&>(std::as_const(*this).shard_of(wlhash));
+    }
+
+    /// moves the clock hand to the first slot not referenced, clearing the reference bits on the way.
+    static size_t advance_to_victim(Shard& shard) {
+        while (shard.slots[shard.hand].referenced.exchange(false, std::memory_order_relaxed)) {
+            shard.hand = (shard.hand + 1) % shard.capacity;
         }
+        return shard.hand;
     }
 
 protected:
-
-    /// @brief Check if the cache is consistent, i.e., the number of workloads matches the size of the table
-    bool check_consistency() const {
-        if (workloads.size() != m_table.size()) {
+    /// @brief Check if the shard is consistent, i.e., the number of workloads matches the size of the table
+    static bool check_consistency(const Shard& shard) {
+        if (shard.slots.size() != shard.m_table.size()) {
             return false;
         }
 
@@ -0,0 +1,494 @@
+// Copyright © 2025 Intel Corporation
+// SPDX-License-Identifier: Apache 2.0
+// LEGAL NOTICE: Your use of this software and any required dependent software (the “Software Package”)
+// is subject to the terms and conditions of the software license agreements for the Software Package,
+// which may also include notices, disclaimers, or license terms for third party or open source software
+// included in or with the Software Package, and your use indicates your acceptance of all such terms.
+// Please refer to the “third-party-programs.txt” or other similarly-named text file included with the
+// Software Package for additional details.
+
+#ifndef VPUNN_COMPACT_CACHE_TABLE_H
+#define VPUNN_COMPACT_CACHE_TABLE_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <vector>
+
+#include "core/logger.h"
+#include "cycles_cache_generated.h"
+
+namespace VPUNN {
+
+/// How the values of a compact cache section are encoded, and the error allowed
+struct CompactEncoding {
+    /// the requested encoding. If a value cannot be encoded within the error bound the section is written with
+    /// Float32 (exact)
+    VPUNN_SCHEMA::CompactValueEncoding values{VPUNN_SCHEMA::CompactValueEncoding::Log16};
+    float max_relative_error{0.001f};  ///< max |decoded - value| / |value| for all the values
+    uint32_t block_size{64};           ///< entries per block of keys, the cost of a lookup after the index search
+};
+
+/**
+ * @brief Read only table of entries sorted ascending by key, stored in the compact form (CompactEntries).
+ *
+ * The keys are delta coded (LEB128) in blocks, the first key of each block is in a sparse index. A lookup is a binary
+ * search in the index followed by the decoding of one block. The values are float, half precision, or codes of a
+ * logarithmic scale.
+ * The table references the section in place (e.g. in a memory mapped file) or owns a copy of it.
+ */
+class CompactCacheTable {
+public:
+    using Encoding = VPUNN_SCHEMA::CompactValueEncoding;
+
+    CompactCacheTable() = default;
+    CompactCacheTable(const CompactCacheTable&) = delete;
+    CompactCacheTable& operator=(const CompactCacheTable&) = delete;
+
+    /**
+     * @brief uses a section of a cache file
+     *
+     * @param section the section, can be null (empty table)
+     * @param copy if true the content is copied, otherwise the section must outlive this object
+     * @returns false (and the table is empty) if the section is not consistent
+     */
+    bool load(const VPUNN_SCHEMA::CompactEntries* section, bool copy) {
+        content = Content{};
+        if (section == nullptr) {
+            return true;
+        }
+        Content loaded;
+        if (!read_section(section, loaded)) {
+            Logger::warning() << "\n Compact cache section is not consistent, not used\n";
+            return false;
+        }
+        if (copy) {
+            loaded.own_copy();
+        }
+        content = std::move(loaded);
+        return true;
+    }
+
+    size_t size() const {
+        return content.count;
+    }
+
+    /// true if the section is used in place, it must outlive the table
+    bool is_referenced() const {
+        return (content.count > 0) && content.owned_values.empty();
+    }
+
+    bool has_fingerprints() const {
+        return content.fingerprints != nullptr;
+    }
+
+    /// @returns the position of the key, or nothing if not present
+    std::optional<size_t> index_of(const uint64_t key) const {
+        if ((content.count == 0) || (key < content.first_keys[0])) {
+            return std::nullopt;
+        }
+        // the last block that starts with a key <= searched key
+        const uint64_t* block_it{std::upper_bound(content.first_keys, content.first_keys + content.blocks, key) - 1};
+        const size_t block{static_cast<size_t>(block_it - content.first_keys)};
+        const size_t first_index{block * content.block_size};
+        const size_t entries_in_block{std::min<size_t>(content.block_size, content.count - first_index)};
+
+        uint64_t current{*block_it};
+        size_t pos{content.block_offsets[block]};
+        const size_t end{block_end(block)};
+        for (size_t i = 0; i < entries_in_block; ++i) {
+            if (i > 0) {
+                uint64_t delta{0};
+                if (!read_varint(pos, end, delta)) {
+                    return std::nullopt;
+                }
+                current += delta;
+            }
+            if (current == key) {
+                return first_index + i;
+            }
+            if (current > key) {
+                break;
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::optional<float> find(const uint64_t key) const {
+        const auto index{index_of(key)};
+        if (!index) {
+            return std::nullopt;
+        }
+        return value_at(*index);
+    }
+
+    bool contains(const uint64_t key) const {
+        return index_of(key).has_value();
+    }
+
+    /// @returns the decoded value of the entry at this position
+    float value_at(const size_t index) const {
+        switch (content.encoding) {
+        case Encoding::Float16:
+            return half_to_float(read_u16(content.values + 2 * index));
+        case Encoding::Log16:
+            return decode_log16(read_u16(content.values + 2 * index), content.log_min, content.log_step);
+        default: {
+            const uint32_t bits{read_u32(content.values + 4 * index)};
+            float value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+        }
+    }
+
+    /// @returns the fingerprint of the entry at this position, 0 if the table has none
+    uint32_t fingerprint_at(const size_t index) const {
+        return content.fingerprints ? content.fingerprints[index] : 0;
+    }
+
+    /// @brief calls f(key, fingerprint, value) for all the entries, ascending by key
+    template <typename F>
+    void for_each(F&& f) const {
+        for (size_t block = 0; block < content.blocks; ++block) {
+            const size_t first_index{block * content.block_size};
+            const size_t entries_in_block{std::min<size_t>(content.block_size, content.count - first_index)};
+            uint64_t current{content.first_keys[block]};
+            size_t pos{content.block_offsets[block]};
+            const size_t end{block_end(block)};
+            for (size_t i = 0; i < entries_in_block; ++i) {
+                if (i > 0) {
+                    uint64_t delta{0};
+                    if (!read_varint(pos, end, delta)) {
+                        return;
+                    }
+                    current += delta;
+                }
+                f(current, fingerprint_at(first_index + i), value_at(first_index + i));
+            }
+        }
+    }
+
+    /**
+     * @brief builds a compact section
+     *
+     * @param fbb the builder of the cache file
+     * @param keys strictly ascending keys
+     * @param fingerprints one per key, or empty
+     * @param values one per key
+     * @param encoding the requested encoding of the values and the error bound
+     * @returns the section
+     */
+    static flatbuffers::Offset<VPUNN_SCHEMA::CompactEntries> build(flatbuffers::FlatBufferBuilder& fbb,
+                                                                    const std::vector<uint64_t>& keys,
+                                                                    const std::vector<uint32_t>& fingerprints,
+                                                                    const std::vector<float>& values,
+                                                                    const CompactEncoding& encoding) {
+        const uint32_t block_size{std::max<uint32_t>(1, encoding.block_size)};
+        std::vector<uint64_t> first_keys;
+        std::vector<uint32_t> block_offsets;
+        std::vector<uint8_t> key_deltas;
+        for (size_t i = 0; i < keys.size(); ++i) {
+            if ((i % block_size) == 0) {
+                first_keys.push_back(keys[i]);
+                block_offsets.push_back(static_cast<uint32_t>(key_deltas.size()));
+            } else {
+                write_varint(keys[i] - keys[i - 1], key_deltas);
+            }
+        }
+
+        Encoding used{encoding.values};
+        float log_min{0.0f};
+        float log_step{0.0f};
+        std::vector<uint8_t> encoded;
+        if (!encode_values(values, encoding.values, encoding.max_relative_error, encoded, log_min, log_step)) {
+            Logger::warning() << "\n Compact cache: the values cannot be encoded within the relative error "
+                              << encoding.max_relative_error << ", written as Float32\n";
+            used = Encoding::Float32;
+            encode_values(values, used, encoding.max_relative_error, encoded, log_min, log_step);
+        }
+
+        const auto first_keys_offset = fbb.CreateVector(first_keys);
+        const auto block_offsets_offset = fbb.CreateVector(block_offsets);
+        const auto key_deltas_offset = fbb.CreateVector(key_deltas);
+        flatbuffers::Offset<flatbuffers::Vector<uint32_t>> fingerprints_offset{0};
+        if (!fingerprints.empty()) {
+            fingerprints_offset = fbb.CreateVector(fingerprints);
+        }
+        const auto values_offset = fbb.CreateVector(encoded);
+        return VPUNN_SCHEMA::CreateCompactEntries(fbb, keys.size(), block_size, first_keys_offset, block_offsets_offset,
+                                                  key_deltas_offset, fingerprints_offset, used, values_offset, log_min,
+                                                  log_step, (used == Encoding::Float32) ? 0.0f
+                                                                                        : encoding.max_relative_error);
+    }
+
+    /// IEEE half precision to float
+    static float half_to_float(const uint16_t half) {
+        const uint32_t sign{(static_cast<uint32_t>(half) & 0x8000u) << 16};
+        const uint32_t exponent{(static_cast<uint32_t>(half) >> 10) & 0x1Fu};
+        uint32_t mantissa{static_cast<uint32_t>(half) & 0x3FFu};
+        uint32_t bits{sign};
+        if (exponent == 0x1Fu) {  // inf, nan
+            bits |= 0x7F800000u | (mantissa << 13);
+        } else if (exponent != 0) {  // normal
+            bits |= ((exponent + 112u) << 23) | (mantissa << 13);
+        } else if (mantissa != 0) {  // subnormal, normalized in float
+            uint32_t float_exponent{113};
+            while ((mantissa & 0x400u) == 0) {
+                mantissa <<= 1;
+                --float_exponent;
+            }
+            bits |= (float_exponent << 23) | ((mantissa & 0x3FFu) << 13);
+        }
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    /// float to IEEE half precision, rounded to nearest even. Too large values become infinite
+    static uint16_t float_to_half(const float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        const uint32_t sign{(bits >> 16) & 0x8000u};
+        bits &= 0x7FFFFFFFu;
+        if (bits >= 0x7F800000u) {  // inf, nan
+            return static_cast<uint16_t>(sign | 0x7C00u | ((bits > 0x7F800000u) ? 0x200u : 0u));
+        }
+        if (bits >= 0x477FF000u) {  // rounds above 65504
+            return static_cast<uint16_t>(sign | 0x7C00u);
+        }
+        if (bits < 0x38800000u) {  // below the smallest normal half
+            if (bits < 0x33000000u) {
+                return static_cast<uint16_t>(sign);
+            }
+            const uint32_t shift{126u - (bits >> 23)};
+            const uint32_t mantissa{(bits & 0x7FFFFFu) | 0x800000u};
+            uint32_t half{mantissa >> shift};
+            const uint32_t rest{mantissa & ((1u << shift) - 1u)};
+            const uint32_t midpoint{1u << (shift - 1u)};
+            if ((rest > midpoint) || ((rest == midpoint) && ((half & 1u) != 0))) {
+                ++half;
+            }
+            return static_cast<uint16_t>(sign | half);
+        }
+        uint32_t half{(bits >> 13) - (112u << 10)};
+        const uint32_t rest{bits & 0x1FFFu};
+        if ((rest > 0x1000u) || ((rest == 0x1000u) && ((half & 1u) != 0))) {
+            ++half;
+        }
+        return static_cast<uint16_t>(sign | half);
+    }
+
+private:
+    /// the parts of a section, pointing in the section or in owned
+    struct Content {
+        size_t count{0};
+        uint32_t block_size{1};
+        size_t blocks{0};
+        const uint64_t* first_keys{nullptr};
+        const uint32_t* block_offsets{nullptr};
+        const uint8_t* key_deltas{nullptr};
+        size_t key_deltas_size{0};
+        const uint32_t* fingerprints{nullptr};
+        Encoding encoding{Encoding::Float32};
+        const uint8_t* values{nullptr};
+        float log_min{0.0f};
+        float log_step{0.0f};
+
+        std::vector<uint64_t> owned_first_keys;
+        std::vector<uint32_t> owned_block_offsets;
+        std::vector<uint8_t> owned_key_deltas;
+        std::vector<uint32_t> owned_fingerprints;
+        std::vector<uint8_t> owned_values;
+
+        /// copies the referenced parts and points to the copies
+        void own_copy() {
+            owned_first_keys.assign(first_keys, first_keys + blocks);
+            owned_block_offsets.assign(block_offsets, block_offsets + blocks);
+            owned_key_deltas.assign(key_deltas, key_deltas + key_deltas_size);
+            if (fingerprints) {
+                owned_fingerprints.assign(fingerprints, fingerprints + count);
+                fingerprints = owned_fingerprints.data();
+            }
+            owned_values.assign(values, values + count * bytes_per_value(encoding));
+            first_keys = owned_first_keys.data();
+            block_offsets = owned_block_offsets.data();
+            key_deltas = owned_key_deltas.data();
+            values = owned_values.data();
+        }
+    };
+
+    Content content;
+
+    static size_t bytes_per_value(const Encoding encoding) {
+        return (encoding == Encoding::Float32) ? 4 : 2;
+    }
+
+    size_t block_end(const size_t block) const {
+        return (block + 1 < content.blocks) ? content.block_offsets[block + 1] : content.key_deltas_size;
+    }
+
+    /// checks the sizes and the sparse index of a section
+    static bool read_section(const VPUNN_SCHEMA::CompactEntries* section, Content& parts) {
+        const uint64_t count{section->count()};
+        if (count == 0) {
+            return true;
+        }
+        const uint32_t block_size{section->block_size()};
+        const auto* first_keys = section->first_keys();
+        const auto* block_offsets = section->block_offsets();
+        const auto* key_deltas = section->key_deltas();
+        const auto* values = section->values();
+        const auto* fingerprints = section->fingerprints();
+        const Encoding encoding{section->value_encoding()};
+        if ((block_size == 0) || !first_keys || !block_offsets || !key_deltas || !values ||
+            (encoding > Encoding::MAX)) {
+            return false;
+        }
+        const uint64_t blocks{(count + block_size - 1) / block_size};
+        if ((first_keys->size() != blocks) || (block_offsets->size() != blocks) ||
+            (values->size() != count * bytes_per_value(encoding)) ||
+            (fingerprints && (fingerprints->size() != count))) {
+            return false;
+        }
+        for (size_t b = 0; b < blocks; ++b) {
+            if ((block_offsets->Get(static_cast<flatbuffers::uoffset_t>(b)) > key_deltas->size()) ||
+                ((b > 0) && ((block_offsets->Get(static_cast<flatbuffers::uoffset_t>(b)) <
+                              block_offsets->Get(static_cast<flatbuffers::uoffset_t>(b - 1))) ||
+                             (first_keys->Get(static_cast<flatbuffers::uoffset_t>(b)) <=
+                              first_keys->Get(static_cast<flatbuffers::uoffset_t>(b - 1)))))) {
+                return false;
+            }
+        }
+        parts.count = static_cast<size_t>(count);
+        parts.block_size = block_size;
+        parts.blocks = static_cast<size_t>(blocks);
+        parts.first_keys = first_keys->data();
+        parts.block_offsets = block_offsets->data();
+        parts.key_deltas = key_deltas->data();
+        parts.key_deltas_size = key_deltas->size();
+        parts.fingerprints = fingerprints ? fingerprints->data() : nullptr;
+        parts.encoding = encoding;
+        parts.values = values->data();
+        parts.log_min = section->log_min();
+        parts.log_step = section->log_step();
+        return true;
+    }
+
+    /// reads a LEB128 number at pos, not beyond end. Advances pos
+    bool read_varint(size_t& pos, const size_t end, uint64_t& value) const {
+        value = 0;
+        for (unsigned int shift = 0; (pos < end) && (shift < 64); shift += 7) {
+            const uint8_t byte{content.key_deltas[pos++]};
+            value |= static_cast<uint64_t>(byte & 0x7Fu) << shift;
+            if ((byte & 0x80u) == 0) {
+                return true;
+            }
+        }
+        return false;  // truncated
+    }
+
+    static void write_varint(uint64_t value, std::vector<uint8_t>& out) {
+        while (value >= 0x80u) {
+            out.push_back(static_cast<uint8_t>((value & 0x7Fu) | 0x80u));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    static uint16_t read_u16(const uint8_t* where) {
+        return static_cast<uint16_t>(where[0] | (where[1] << 8));
+    }
+
+    static uint32_t read_u32(const uint8_t* where) {
+        return static_cast<uint32_t>(where[0]) | (static_cast<uint32_t>(where[1]) << 8) |
+               (static_cast<uint32_t>(where[2]) << 16) | (static_cast<uint32_t>(where[3]) << 24);
+    }
+
+    static float decode_log16(const uint16_t code, const float log_min, const float log_step) {
+        if (code == 0) {
+            return 0.0f;
+        }
+        return std::exp(log_min + static_cast<float>(code - 1) * log_step);
+    }
+
+    /**
+     * @brief encodes the values, checking each decoded value against the error bound
+     *
+     * @returns false if a value cannot be encoded within the bound (not possible for Float32)
+     */
+    static bool encode_values(const std::vector<float>& values, const Encoding encoding, const float max_relative_error,
+                              std::vector<uint8_t>& encoded, float& log_min, float& log_step) {
+        encoded.clear();
+        encoded.reserve(values.size() * bytes_per_value(encoding));
+        const auto within_bound = [max_relative_error](const float value, const float decoded) {
+            return std::fabs(decoded - value) <= max_relative_error * std::fabs(value);
+        };
+        const auto put_u16 = [&encoded](const uint16_t v) {
+            encoded.push_back(static_cast<uint8_t>(v & 0xFFu));
+            encoded.push_back(static_cast<uint8_t>(v >> 8));
+        };
+
+        switch (encoding) {
+        case Encoding::Float16:
+            for (const float value : values) {
+                const uint16_t half{float_to_half(value)};
+                if (!within_bound(value, half_to_float(half))) {
+                    return false;
+                }
+                put_u16(half);
+            }
+            return true;
+
+        case Encoding::Log16: {
+            float min_positive{std::numeric_limits<float>::max()};
+            for (const float value : values) {
+                if (!std::isfinite(value) || (value < 0.0f)) {
+                    return false;
+                }
+                if (value > 0.0f) {
+                    min_positive = std::min(min_positive, value);
+                }
+            }
+            // rounding in the log domain errs by at most half a step, a bit of margin for the float arithmetic
+            log_min = std::log(min_positive);
+            log_step = 1.98f * std::log1p(max_relative_error);
+            if (!(log_step > 0.0f)) {
+                return false;
+            }
+            for (const float value : values) {
+                uint16_t code{0};
+                if (value > 0.0f) {
+                    const float position{std::round((std::log(value) - log_min) / log_step)};
+                    if (!(position < 65535.0f)) {
+                        return false;  // range too wide for this error bound
+                    }
+                    code = static_cast<uint16_t>(position + 1.0f);
+                }
+                if (!within_bound(value, decode_log16(code, log_min, log_step))) {
+                    return false;
+                }
+                put_u16(code);
+            }
+            return true;
+        }
+
+        default:
+            for (const float value : values) {
+                uint32_t bits;
+                std::memcpy(&bits, &value, sizeof(bits));
+                for (int i = 0; i < 4; ++i) {
+                    encoded.push_back(static_cast<uint8_t>((bits >> (8 * i)) & 0xFFu));
+                }
+            }
+            return true;
+        }
+    }
+};
+
+}  // namespace VPUNN
+
+#endif  // VPUNN_COMPACT_CACHE_TABLE_H
@@ -0,0 +1,186 @@
+// Copyright © 2025 Intel Corporation
+// SPDX-License-Identifier: Apache 2.0
+// LEGAL NOTICE: Your use of this software and any required dependent software (the “Software Package”)
+// is subject to the terms and conditions of the software license agreements for the Software Package,
+// which may also include notices, disclaimers, or license terms for third party or open source software
+// included in or with the Software Package, and your use indicates your acceptance of all such terms.
+// Please refer to the “third-party-programs.txt” or other similarly-named text file included with the
+// Software Package for additional details.
+
+#ifndef VPUNN_EXECUTION_CONTEXT_POOL_H
+#define VPUNN_EXECUTION_CONTEXT_POOL_H
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace VPUNN {
+
+/**
+ * @brief Pool of execution contexts (mutable per thread memory), one context bound to each thread using the pool.
+ *
+ * A thread gets its context through a thread_local binding, without any lock after the first call.
+ * When the thread exits its context is returned to the pool, to be reused by other threads. At most max_idle
+ * returned contexts are kept, the others are released, so short lived threads do not make the memory grow.
+ * All contexts are owned by the pool and are released when the pool is destroyed.
+ *
+ * The contexts in use are not limited: a context stays bound to its thread until the thread exits, so refusing or
+ * sharing one would block or serialize the callers. The pool holds at most (live threads that used it) + max_idle
+ * contexts; the memory is bounded by the number of threads the user runs, e.g. a thread pool.
+ *
+ * @tparam Ctx the context type
+ */
+template <class Ctx>
+class ExecutionContextPool {
+public:
+    static inline constexpr size_t default_max_idle{16};  ///< default number of returned contexts kept for reuse
+
+    explicit ExecutionContextPool(size_t max_idle = default_max_idle): state{std::make_shared<State>(max_idle)} {
+    }
+
+    ExecutionContextPool(const ExecutionContextPool&) = delete;
+    ExecutionContextPool& operator=(const ExecutionContextPool&) = delete;
+
+    /**
+     * @brief provides the context of the calling thread, creating it (or reusing an idle one) at first call.
+     * The reference is valid while the thread is alive and the pool exists. Never blocks: every live thread gets its
+     * own context, see the class description for the resulting memory bound.
+     *
+     * @param create callable returning a std::unique_ptr<Ctx>, used only if no idle context is available
+     */
+    template <class Factory>
+    Ctx& get(Factory&& create) const {
+        ThreadBindings& bindings{this_thread_bindings()};
+        for (const auto& b : bindings.list) {  // fast path, no lock
+            if ((b.owner == state.get()) && !b.pool.expired()) {
+                return *b.ctx;
+            }
+        }
+        bindings.purge_expired();
+
+        Ctx* ctx{state->checkout()};
+        if (ctx == nullptr) {
+            ctx = state->adopt(create());
+        }
+        bindings.list.push_back({state, state.get(), ctx});
+        return *ctx;
+    }
+
+    /// @brief sets how many returned contexts are kept for reuse. The ones above the limit are released
+    void set_max_idle(size_t max_idle) {
+        state->set_max_idle(max_idle);
+    }
+
+    /// @returns the number of contexts bound to threads
+    size_t in_use_count() const {
+        std::lock_guard<std::mutex> lock(state->mtx);
+        return state->in_use.size();
+    }
+
+    /// @returns the number of contexts waiting to be reused
+    size_t idle_count() const {
+        std::lock_guard<std::mutex> lock(state->mtx);
+        return state->idle.size();
+    }
+
+private:
+    /// the part that can outlive the pool while a thread is returning its context
+    struct State {
+        explicit State(size_t max_idle_): max_idle{max_idle_} {
+        }
+
+        std::mutex mtx;                                         ///< protects all the members
+        std::vector<std::unique_ptr<Ctx>> idle;                 ///< returned, ready for reuse
+        std::unordered_map<Ctx*, std::unique_ptr<Ctx>> in_use;  ///< bound to live threads
+        size_t max_idle;                                        ///< limit for idle
+
+        Ctx* checkout() {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (idle.empty()) {
+                return nullptr;
+            }
+            std::unique_ptr<Ctx> ctx{std::move(idle.back())};
+            idle.pop_back();
+            Ctx* raw{ctx.get()};
+            in_use.emplace(raw, std::move(ctx));
+            return raw;
+        }
+
+        Ctx* adopt(std::unique_ptr<Ctx> ctx) {
+            std::lock_guard<std::mutex> lock(mtx);
+            Ctx* raw{ctx.get()};
+            in_use.emplace(raw, std::move(ctx));
+            return raw;
+        }
+
+        void release(Ctx* raw) {
+            std::unique_ptr<Ctx> to_delete;  // destroyed outside of the lock
+            std::lock_guard<std::mutex> lock(mtx);
+            auto it{in_use.find(raw)};
+            if (it == in_use.end()) {
+                return;
+            }
+            if (idle.size() < max_idle) {
+                idle.push_back(std::move(it->second));
+            } else {
+                to_delete = std::move(it->second);
+            }
+            in_use.erase(it);
+        }
+
+        void set_max_idle(size_t max_idle_) {
+            std::vector<std::unique_ptr<Ctx>> to_delete;  // destroyed outside of the lock
+            std::lock_guard<std::mutex> lock(mtx);
+            max_idle = max_idle_;
+            while (idle.size() > max_idle) {
+                to_delete.push_back(std::move(idle.back()));
+                idle.pop_back();
+            }
+        }
+    };
+
+    /// the association of a thread with a context of a pool
+    struct Binding {
+        std::weak_ptr<State> pool;  ///< expired if the pool was destroyed
+        const State* owner;         ///< identifies the pool, valid only if pool is not expired
+        Ctx* ctx;                   ///< the bound context, owned by the pool
+    };
+
+    /// all bindings of a thread, the contexts are returned to their pools at thread exit
+    struct ThreadBindings {
+        std::vector<Binding> list;
+
+        ThreadBindings() = default;
+        ThreadBindings(const ThreadBindings&) = delete;
+        ThreadBindings& operator=(const ThreadBindings&) = delete;
+
+        ~ThreadBindings() {
+            for (const auto& b : list) {
+                if (auto pool = b.pool.lock()) {
+                    pool->release(b.ctx);
+                }
+            }
+        }
+
+        void purge_expired() {
+            list.erase(std::remove_if(list.begin(), list.end(),
+                                      [](const Binding& b) {
+                                          return b.pool.expired();
+                                      }),
+                       list.end());
+        }
+    };
+
+    static ThreadBindings& this_thread_bindings() {
+        thread_local ThreadBindings bindings;
+        return bindings;
+    }
+
+    std::shared_ptr<State> state;  ///< never null
+};
+
+}  // namespace VPUNN
+
+#endif  // VPUNN_EXECUTION_CONTEXT_POOL_H
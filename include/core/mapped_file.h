@@ -0,0 +1,207 @@
+// Copyright © 2025 Intel Corporation
+// SPDX-License-Identifier: Apache 2.0
+// LEGAL NOTICE: Your use of this software and any required dependent software (the “Software Package”)
+// is subject to the terms and conditions of the software license agreements for the Software Package,
+// which may also include notices, disclaimers, or license terms for third party or open source software
+// included in or with the Software Package, and your use indicates your acceptance of all such terms.
+// Please refer to the “third-party-programs.txt” or other similarly-named text file included with the
+// Software Package for additional details.
+
+#ifndef VPUNN_MAPPED_FILE_H
+#define VPUNN_MAPPED_FILE_H
+
+#include <atomic>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace VPUNN {
+
+/// @brief Read only memory mapping of a whole file.
+///
+/// The content is paged in on demand by the OS and the physical pages are shared between all the processes that map
+/// the same file. The mapping lives as long as this object. Not copyable, movable.
+/// If the file cannot be opened/mapped the object is empty (is_mapped() is false), no exception is thrown.
+class MappedFile {
+public:
+    MappedFile() = default;
+
+    explicit MappedFile(const std::string& filename) {
+        map(filename);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept {
+        swap(other);
+    }
+
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            unmap();
+            swap(other);
+        }
+        return *this;
+    }
+
+    ~MappedFile() {
+        unmap();
+    }
+
+    bool is_mapped() const noexcept {
+        return data_ptr != nullptr;
+    }
+
+    const char* data() const noexcept {
+        return data_ptr;
+    }
+
+    size_t size() const noexcept {
+        return data_size;
+    }
+
+private:
+    const char* data_ptr{nullptr};  ///< start of the mapped content
+    size_t data_size{0};            ///< size in bytes of the mapped content
+#ifdef _WIN32
+    HANDLE mapping_handle{nullptr};  ///< file mapping object, the file handle is closed right after mapping
+#endif
+
+    void swap(MappedFile& other) noexcept {
+        std::swap(data_ptr, other.data_ptr);
+        std::swap(data_size, other.data_size);
+#ifdef _WIN32
+        std::swap(mapping_handle, other.mapping_handle);
+#endif
+    }
+
+    void map(const std::string& filename) {
+        if (filename.empty()) {
+            return;
+        }
+#ifdef _WIN32
+        HANDLE file_handle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                         FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file_handle == INVALID_HANDLE_VALUE) {
+            return;
+        }
+        LARGE_INTEGER file_size{};
+        if (!GetFileSizeEx(file_handle, &file_size) || file_size.QuadPart == 0) {
+            CloseHandle(file_handle);
+            return;
+        }
+        mapping_handle = CreateFileMappingA(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file_handle);  // the mapping keeps its own reference
+        if (mapping_handle == nullptr) {
+            return;
+        }
+        void* view = MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+        if (view == nullptr) {
+            CloseHandle(mapping_handle);
+            mapping_handle = nullptr;
+            return;
+        }
+        data_ptr = static_cast<const char*>(view);
+        data_size = static_cast<size_t>(file_size.QuadPart);
+#else
+        const int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return;
+        }
+        struct stat file_info {};
+        if ((::fstat(fd, &file_info) != 0) || (file_info.st_size <= 0)) {
+            ::close(fd);
+            return;
+        }
+        const size_t length{static_cast<size_t>(file_info.st_size)};
+        void* view = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);  // the mapping keeps its own reference
+        if (view == MAP_FAILED) {
+            return;
+        }
+        data_ptr = static_cast<const char*>(view);
+        data_size = length;
+#endif
+    }
+
+    void unmap() noexcept {
+        if (data_ptr == nullptr) {
+            return;
+        }
+#ifdef _WIN32
+        UnmapViewOfFile(data_ptr);
+        CloseHandle(mapping_handle);
+        mapping_handle = nullptr;
+#else
+        ::munmap(const_cast<char*>(data_ptr), data_size);
+#endif
+        data_ptr = nullptr;
+        data_size = 0;
+    }
+};
+
+/// @brief a name for a temporary file next to filename, unique among the processes and threads writing there
+inline std::string unique_temporary_filename(const std::string& filename) {
+    static std::atomic<unsigned long> counter{0};
+#ifdef _WIN32
+    const unsigned long pid{static_cast<unsigned long>(GetCurrentProcessId())};
+#else
+    const unsigned long pid{static_cast<unsigned long>(::getpid())};
+#endif
+    return filename + ".tmp." + std::to_string(pid) + "." +
+           std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + "." +
+           std::to_string(counter.fetch_add(1, std::memory_order_relaxed));
+}
+
+/**
+ * @brief replaces the content of a file: writes a temporary file in the same directory and renames it over the
+ * target. A file that is memory mapped (by any process) is never changed in place, its mappings keep the old content
+ * and the new readers see only a complete file.
+ *
+ * @returns true if the file was replaced. On Windows a file that is mapped cannot be replaced, false then.
+ */
+inline bool write_file_replacing(const std::string& filename, const char* data, size_t size) {
+    const std::string temporary{unique_temporary_filename(filename)};
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::out);
+        if (file.fail()) {
+            return false;
+        }
+        file.write(data, static_cast<std::streamsize>(size));
+        file.close();
+        if (file.fail()) {
+            std::error_code ec;
+            std::filesystem::remove(temporary, ec);
+            return false;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(temporary, filename, ec);
+    if (ec) {
+        std::filesystem::remove(temporary, ec);
+        return false;
+    }
+    return true;
+}
+
+}  // namespace VPUNN
+
+#endif  // VPUNN_MAPPED_FILE_H
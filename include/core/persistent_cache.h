@@ -11,6 +11,7 @@
 #define VPUNN_PERSISTENT_CACHE
 
 #include <atomic>
+#include <cstdint>
 #include <cstring>
 #include <filesystem>
 #include <fstream>
@@ -20,8 +21,15 @@
 #include <stdexcept>
 #include <vector>
 #include <mutex>
+#include <shared_mutex>
+#include <algorithm>
+#include <array>
+#include <string>
+#include <type_traits>
 
+#include "core/compact_cache_table.h"
 #include "core/logger.h"
+#include "core/mapped_file.h"
 #include "core/utils.h"
 #include "cycles_cache_generated.h"
 
@@ -32,15 +40,28 @@ namespace VPUNN {
 /* coverity[rule_of_three_violation:FALSE] */
 class AccessCounter {
 private:
+    /// hits and misses of the threads assigned to this slot. One cache line per slot, so threads counting on
+    /// different slots do not invalidate each other's caches
+    struct alignas(64) CounterSlot {
+        std::atomic<size_t> hits{0};
+        std::atomic<size_t> misses{0};
+    };
+    static constexpr size_t slots_count{64};  ///< threads above this number share slots
+
     // mutable because the reset is const
-    // atomic to make it thread safe (very small perf hit)
-    mutable std::atomic<size_t> accesses{0};
-    mutable std::atomic<size_t> hits{0};
-    mutable std::atomic<size_t> misses{0};
+    // counted per thread (slot), aggregated only when read
+    mutable std::array<CounterSlot, slots_count> slots{};
 
     std::string name{"unnamed"};
     mutable std::mutex mtx;
 
+    /// the slot of the calling thread, assigned round robin at the first use in that thread
+    static size_t this_thread_slot() {
+        static std::atomic<size_t> next_slot{0};
+        thread_local const size_t slot{next_slot.fetch_add(1, std::memory_order_relaxed) % slots_count};
+        return slot;
+    }
+
 public:
     AccessCounter() = default;
     AccessCounter(std::string desiredName): name{std::move(desiredName)} {
@@ -66,12 +87,12 @@ public:
     // copy assignment operator
     AccessCounter& operator=(const AccessCounter&) = delete;
 
-    void access(bool hit = true) {  // not really thread safe
-        accesses.fetch_add(1, std::memory_order_relaxed);
+    void access(bool hit = true) {
+        CounterSlot& slot{slots[this_thread_slot()]};
         if (hit) {
-            hits.fetch_add(1, std::memory_order_relaxed);
+            slot.hits.fetch_add(1, std::memory_order_relaxed);
         } else {
-            misses.fetch_add(1, std::memory_order_relaxed);
+            slot.misses.fetch_add(1, std::memory_order_relaxed);
         }
     }
 
@@ -85,9 +106,10 @@ public:
 
     void reset() const {
         std::lock_guard<std::mutex> lock(mtx);
-        accesses.store(0, std::memory_order_relaxed);
-        hits.store(0, std::memory_order_relaxed);
-        misses.store(0, std::memory_order_relaxed);
+        for (auto& slot : slots) {
+            slot.hits.store(0, std::memory_order_relaxed);
+            slot.misses.store(0, std::memory_order_relaxed);
+        }
     }
 
     void printToLog(const std::string prefix = "") const {
@@ -101,67 +123,209 @@ public:
     // print to a string all the details, including the hit and miss ratios in percentage
     std::string printString() const {
         std::lock_guard<std::mutex> lock(mtx);
-        size_t a = accesses.load(std::memory_order_relaxed);
-        size_t h = hits.load(std::memory_order_relaxed);
-        size_t m = misses.load(std::memory_order_relaxed);
+        const size_t h = sum_hits();
+        const size_t m = sum_misses();
+        const size_t a = h + m;
         std::string result;
         result += "Cache Object: " + std::to_string((unsigned long long int)this) +
                   " stats: Accesses: " + std::to_string(a) + ", Hits: " + std::to_string(h) +
                   ", Misses: " + std::to_string(m);
-        result += "\t, Hit ratio: " + std::to_string(getHitRatioUnlocked() * 100) +
-                  "%, Miss ratio: " + std::to_string(getMissRatioUnlocked() * 100) + "%";
+        result += "\t, Hit ratio: " + std::to_string(ratio(h, a) * 100) +
+                  "%, Miss ratio: " + std::to_string(ratio(m, a) * 100) + "%";
         return result;
     }
 
     size_t getAccesses() const {
-        return accesses;
+        return sum_hits() + sum_misses();
     }
 
     size_t getHits() const {
-        return hits;
+        return sum_hits();
     }
 
     size_t getMisses() const {
-        return misses;
+        return sum_misses();
     }
 
     // calc hit ratio
     double getHitRatio() const {
         std::lock_guard<std::mutex> lock(mtx);
-        size_t a = accesses.load(std::memory_order_relaxed);
-        size_t h = hits.load(std::memory_order_relaxed);
-        return (a == 0) ? 0.0 : (static_cast<double>(h) / a);
+        const size_t h = sum_hits();
+        return ratio(h, h + sum_misses());
     }
     // calc miss ratio
     double getMissRatio() const {
         std::lock_guard<std::mutex> lock(mtx);
-        size_t a = accesses.load(std::memory_order_relaxed);
-        size_t m = misses.load(std::memory_order_relaxed);
-        return (a == 0) ? 0.0 : (static_cast<double>(m) / a);
+        const size_t m = sum_misses();
+        return ratio(m, sum_hits() + m);
     }
 
 private:
+    size_t sum_hits() const {
+        size_t total{0};
+        for (const auto& slot : slots) {
+            total += slot.hits.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    size_t sum_misses() const {
+        size_t total{0};
+        for (const auto& slot : slots) {
+            total += slot.misses.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    static double ratio(size_t part, size_t all) {
+        return (all == 0) ? 0.0 : (static_cast<double>(part) / static_cast<double>(all));
+    }
+};
+
+/// @brief Read only table of (key, value) pairs kept sorted ascending by key, with unique keys.
+/// The array is searched in place with a branch-free binary search. It can reference external memory (e.g. a memory
+/// mapped cache file) or own a sorted copy of the entries.
+/// @tparam ElementT the flatbuffers struct of an entry, with key() and value()
+template <typename ElementT>
+class BasicSortedCacheTable {
+public:
+    using Element = ElementT;
+    using Key = std::decay_t<decltype(std::declval<const ElementT&>().key())>;
+
+    BasicSortedCacheTable() = default;
+    BasicSortedCacheTable(const BasicSortedCacheTable&) = delete;
+    BasicSortedCacheTable& operator=(const BasicSortedCacheTable&) = delete;
+
+    /// @brief uses the external array in place, no copy. The array must outlive this object.
+    /// @returns false (and nothing is referenced) if the array is not aligned or not strictly ascending by key
+    bool reference(const Element* external, size_t count) {
+        if ((reinterpret_cast<std::uintptr_t>(external) % alignof(Element)) != 0) {
+            return false;
+        }
+        if (!std::is_sorted(external, external + count, [](const Element& a, const Element& b) {
+                return a.key() <= b.key();  // strict ordering, equal keys are not accepted
+            })) {
+            return false;
+        }
+        owned.clear();
+        entries = external;
+        entries_count = count;
+        return true;
+    }
+
+    /// @brief takes the content, sorts it and keeps it. For duplicated keys the last one wins (like a map insert)
+    void adopt(std::vector<Element>&& unsorted) {
+        owned = std::move(unsorted);
+        std::stable_sort(owned.begin(), owned.end(), [](const Element& a, const Element& b) {
+            return a.key() < b.key();
+        });
+        size_t kept{0};
+        for (size_t i = 0; i < owned.size(); ++i) {
+            if ((kept > 0) && (owned[kept - 1].key() == owned[i].key())) {
+                owned[kept - 1] = owned[i];  // same key, later value wins
+            } else {
+                owned[kept++] = owned[i];
+            }
+        }
+        owned.resize(kept);
+        owned.shrink_to_fit();
+        entries = owned.data();
+        entries_count = owned.size();
+    }
+
+    /// @returns the entry with this key, or null
+    const Element* locate(const Key key) const {
+        if (entries_count == 0) {
+            return nullptr;
+        }
+        // finds the last element with key <= searched key, without data dependent branches
+        const Element* base{entries};
+        size_t n{entries_count};
+        while (n > 1) {
+            const size_t half{n / 2};
+            base = (base[half].key() <= key) ? base + half : base;
+            n -= half;
+        }
+        return (base->key() == key) ? base : nullptr;
+    }
 
-    // these are unlocked versions, to be used only when the mutex is already locked
-    double getHitRatioUnlocked() const {
-        size_t a = accesses.load(std::memory_order_relaxed);
-        size_t h = hits.load(std::memory_order_relaxed);
-        return (a == 0) ? 0.0 : (static_cast<double>(h) / a);
+    std::optional<float> find(const Key key) const {
+        const Element* found{locate(key)};
+        if (found) {
+            return found->value();
+        }
+        return std::nullopt;
+    }
+
+    bool contains(const Key key) const {
+        return locate(key) != nullptr;
     }
 
-    // these are unlocked versions, to be used only when the mutex is already locked
-    double getMissRatioUnlocked() const {
-        size_t a = accesses.load(std::memory_order_relaxed);
-        size_t m = misses.load(std::memory_order_relaxed);
-        return (a == 0) ? 0.0 : (static_cast<double>(m) / a);
+    size_t size() const {
+        return entries_count;
     }
+
+    /// true if the entries are in external memory (see reference), that must outlive the table
+    bool is_referenced() const {
+        return (entries_count > 0) && owned.empty();
+    }
+
+    const Element* begin() const {
+        return entries;
+    }
+
+    const Element* end() const {
+        return entries + entries_count;
+    }
+
+private:
+    const Element* entries{nullptr};  ///< first element, points inside owned or inside external memory
+    size_t entries_count{0};          ///< number of elements
+    std::vector<Element> owned;       ///< storage used when the entries are not referenced in place
 };
 
-// for the moment is caching a key of type uint32_t and a value of type float
+using SortedCacheTable = BasicSortedCacheTable<VPUNN_SCHEMA::FlatEntry>;      ///< 32 bit keys (v1)
+using SortedCacheTable64 = BasicSortedCacheTable<VPUNN_SCHEMA::FlatEntry64>;  ///< 64 bit keys and fingerprints (v2)
+
+/// What a cache file tells about its content, the CacheHeader of the file
+struct CacheFileInfo {
+    uint32_t format_version{1};  ///< 1: only 32 bit keys, 2: has 64 bit keys, 3: compact sections
+    std::string model_nickname;  ///< the model that produced the values, empty if not model dependent
+    int32_t descriptor_version{0};  ///< version of the descriptors hashed into the keys, 0 if unknown
+    bool has_fingerprints{false};   ///< the 64 bit entries have fingerprints to be checked
+};
+
+/// How a FixedCache stores the preloaded entries
+enum class FixedCacheStorage {
+    MAP,   ///< all entries are copied in a map. Legacy, fully mutable.
+    FLAT,  ///< sorted flat array. A file is memory mapped and searched in place when its content allows it (sorted
+           ///< section present), otherwise a sorted copy is kept. No map is built.
+};
+
+// for the moment is caching a value of type float.
+// Keys are the 32 bit hashes of the workloads (v1) and, for files in the v2 format, 64 bit hashes verified with a
+// fingerprint (the 32 bit hash). A lookup with both keys searches the 64 bit entries first, then the 32 bit ones.
+// The preloaded FLAT entries are immutable after construction and are read without any lock. The maps (and their lock)
+// are used only if entries are inserted or loaded in MAP storage.
+// Files written by write_cache_compact keep the entries in compact sections (delta coded keys, values possibly
+// approximated within a relative error bound), searched in place like the sorted sections.
 class FixedCache : protected ThreadSafeMap<uint32_t, float> {
 private:
     mutable AccessCounter counter{};
 
+    MappedFile mapped_file;             ///< keeps alive the memory mapped file referenced by the sorted tables (FLAT)
+    SortedCacheTable sorted_table;      ///< read only preloaded entries, 32 bit keys (FLAT storage)
+    SortedCacheTable64 sorted_table64;  ///< read only preloaded entries, 64 bit keys (FLAT storage)
+    CompactCacheTable compact_table;    ///< read only preloaded entries of a compact file, 32 bit keys (FLAT storage)
+    CompactCacheTable compact_table64;  ///< read only preloaded entries of a compact file, 64 bit keys (FLAT storage)
+
+    std::map<uint64_t, SortedCacheTable64::Element> wide_map;  ///< inserted 64 bit entries, protected by _mutex
+
+    /// true once the maps received entries. While false (e.g. a FLAT cache used only for reading) lookups never lock
+    std::atomic<bool> map_in_use{false};
+
+    CacheFileInfo info;  ///< from the loaded file, written again by write_cache
+
 public:
     FixedCache(): FixedCache("") {
     }
@@ -174,34 +338,110 @@ public:
         read_cache(file_data, file_data_length);
     }
 
+    FixedCache(const std::string& filename, FixedCacheStorage storage) {
+        if (storage == FixedCacheStorage::FLAT) {
+            read_cache_flat(filename);
+        } else {
+            read_cache(filename);
+        }
+    }
+
+    FixedCache(const char* file_data, size_t file_data_length, FixedCacheStorage storage) {
+        if (storage == FixedCacheStorage::FLAT) {
+            read_cache_flat(file_data, file_data_length);
+        } else {
+            read_cache(file_data, file_data_length);
+        }
+    }
+
     // get debug access to the counter
     const AccessCounter& getCounter() const {
         return counter;
     }
 
-    /// special getter to increment access counter
+    /// special getter to increment access counter. Searches only the 32 bit entries
     std::optional<float> get(const uint32_t& wl) const {
-        float value = 0;
-        if (ThreadSafeMap::find(wl, value)) {
-            counter.hit();
-            return value;
-        } else {
-            counter.miss();
-            return std::nullopt;
+        const std::optional<float> value{find_narrow(wl)};
+        count(value.has_value());
+        return value;
+    }
+
+    /**
+     * @brief getter for the v2 entries, increments the access counter.
+     * Searches the 64 bit entries (with fingerprint check), then the 32 bit ones
+     *
+     * @param key64 the 64 bit hash of the workload
+     * @param key32 the 32 bit hash of the workload, the fingerprint
+     */
+    std::optional<float> get(const uint64_t key64, const uint32_t key32) const {
+        std::optional<float> value{find_wide(key64, key32)};
+        if (!value) {
+            value = find_narrow(key32);
         }
+        count(value.has_value());
+        return value;
     }
 
 protected:
 public:
-    // for debug mainly
+    // for debug mainly. Does not contain the entries of a FLAT storage, nor the 64 bit ones
     const MapType& getMap() const {
         return _map;
     }
 
+    /// true if the preloaded entries are answered directly from a memory mapped file
+    bool is_memory_mapped() const {
+        return mapped_file.is_mapped();
+    }
+
+    /// true if there are entries with 64 bit keys, the lookups should give them then
+    bool has_wide_keys() const {
+        return (sorted_table64.size() > 0) || (compact_table64.size() > 0) ||
+               map_in_use.load(std::memory_order_acquire);
+    }
+
+    /// what the loaded file tells about the content, or what was set by set_file_info
+    const CacheFileInfo& get_file_info() const {
+        return info;
+    }
+
+    /// @brief describes the content, written in the header by write_cache. The format version and has_fingerprints
+    /// are decided from the content at write
+    void set_file_info(const std::string& model_nickname, const int32_t descriptor_version) {
+        info.model_nickname = model_nickname;
+        info.descriptor_version = descriptor_version;
+    }
+
 public:
-    // expose public from base the following
-    using ThreadSafeMap::contains;  // read only
-    using ThreadSafeMap::insert;    // writes
+    bool contains(const uint32_t& key) const {
+        return find_narrow(key).has_value();
+    }
+
+    bool contains(const uint64_t key64, const uint32_t key32) const {
+        return find_wide(key64, key32).has_value() || find_narrow(key32).has_value();
+    }
+
+    /// adds/overwrites a value. Keys already present in a FLAT storage are read only, the preloaded value is kept
+    void insert(const uint32_t& key, const float& value) {
+        if (sorted_table.contains(key) || compact_table.contains(key)) {
+            return;
+        }
+        ThreadSafeMap::insert(key, value);
+        map_in_use.store(true, std::memory_order_release);
+    }
+
+    /// adds/overwrites a value with a 64 bit key and its fingerprint. Keys already present in a FLAT storage are read
+    /// only, the preloaded value is kept
+    void insert(const uint64_t key64, const uint32_t fingerprint, const float value) {
+        if (sorted_table64.contains(key64) || compact_table64.contains(key64)) {
+            return;
+        }
+        {
+            std::unique_lock lock(_mutex);
+            wide_map.insert_or_assign(key64, SortedCacheTable64::Element(key64, fingerprint, value));
+        }
+        map_in_use.store(true, std::memory_order_release);
+    }
 
     bool read_cache(const std::string& filename) {
         std::ifstream file;
@@ -221,60 +461,473 @@ public:
         file.read(buf.data(), length);
         file.close();
 
-        flatbuffers::Verifier verifier(reinterpret_cast<const uint8_t*>(buf.data()), buf.size());
-        if (!(VPUNN_SCHEMA::VerifyCyclesCacheBuffer(verifier))) {
-            return false;
-        }
+        return read_cache(buf.data(), buf.size());
+    }
 
-        auto* cache_content = VPUNN_SCHEMA::GetCyclesCache(buf.data());
+    bool read_cache(const char* file_data, size_t file_data_length) {
+        const auto* cache_content = get_verified_content(file_data, file_data_length);
         if (cache_content == nullptr) {
             return false;
         }
+        info = read_file_info(cache_content);
 
-        for (const auto& entry : *cache_content->cache_map()) {
-            insert(entry->key(), entry->value());
-        }
+        std::vector<SortedCacheTable::Element> entries{collect_entries(cache_content)};
+        std::vector<SortedCacheTable64::Element> entries64{collect_entries64(cache_content)};
+        collect_compact_entries(cache_content, entries, entries64);
 
+        std::unique_lock lock(_mutex);  // one lock for the whole load
+        for (const auto& entry : entries) {
+            if (!sorted_table.contains(entry.key()) && !compact_table.contains(entry.key())) {
+                _map[entry.key()] = entry.value();
+            }
+        }
+        for (const auto& entry : entries64) {
+            if (!sorted_table64.contains(entry.key()) && !compact_table64.contains(entry.key())) {
+                wide_map.insert_or_assign(entry.key(), entry);
+            }
+        }
+        map_in_use.store(!_map.empty() || !wide_map.empty(), std::memory_order_release);
         return true;
     }
 
-    bool read_cache(const char* file_data, size_t file_data_length) {
-        flatbuffers::Verifier verifier(reinterpret_cast<const uint8_t*>(file_data), file_data_length);
-        if (!(VPUNN_SCHEMA::VerifyCyclesCacheBuffer(verifier))) {
+    /// @brief loads the file in FLAT storage: memory mapped and searched in place if it has the sorted sections,
+    /// otherwise (older files) a sorted copy of the entries is kept
+    bool read_cache_flat(const std::string& filename) {
+        MappedFile file{filename};
+        if (!file.is_mapped()) {
             return false;
         }
-        auto* cache_content = VPUNN_SCHEMA::GetCyclesCache(file_data);
+
+        const auto* cache_content = get_verified_content(file.data(), file.size());
         if (cache_content == nullptr) {
             return false;
         }
-        for (const auto& entry : *cache_content->cache_map()) {
-            insert(entry->key(), entry->value());
+        info = read_file_info(cache_content);
+
+        bool referenced{false};
+        const auto* sorted = cache_content->sorted_map();
+        if ((sorted != nullptr) &&
+            sorted_table.reference(reinterpret_cast<const SortedCacheTable::Element*>(sorted->Data()),
+                                   sorted->size())) {
+            referenced = true;
+        } else {
+            sorted_table.adopt(collect_entries(cache_content));
+        }
+
+        const auto* sorted64 = cache_content->sorted_map64();
+        if ((sorted64 != nullptr) &&
+            sorted_table64.reference(reinterpret_cast<const SortedCacheTable64::Element*>(sorted64->Data()),
+                                     sorted64->size())) {
+            referenced = true;
+        } else {
+            sorted_table64.adopt(collect_entries64(cache_content));
+        }
+
+        // the compact sections are validated once here, then searched in place
+        if (compact_table.load(cache_content->compact_map(), false) && (compact_table.size() > 0)) {
+            referenced = true;
+        }
+        if (compact_table64.load(cache_content->compact_map64(), false) && (compact_table64.size() > 0)) {
+            referenced = true;
+        }
+
+        if (referenced) {
+            mapped_file = std::move(file);  // keep the mapping alive, it is referenced by the sorted tables
         }
+        return true;  // otherwise the mapping is released at exit
+    }
+
+    /// @brief loads the buffer in FLAT storage. The buffer is not referenced after the call, a sorted copy is kept
+    bool read_cache_flat(const char* file_data, size_t file_data_length) {
+        const auto* cache_content = get_verified_content(file_data, file_data_length);
+        if (cache_content == nullptr) {
+            return false;
+        }
+        info = read_file_info(cache_content);
+        sorted_table.adopt(collect_entries(cache_content));
+        sorted_table64.adopt(collect_entries64(cache_content));
+        compact_table.load(cache_content->compact_map(), true);
+        compact_table64.load(cache_content->compact_map64(), true);
         return true;
     }
 
-    bool write_cache(const std::string& filename) {
+    /// @brief writes all entries (FLAT and maps) in a file, with the file info of this cache.
+    /// @param with_legacy_entries if true the 32 bit entries are also written as tables (cache_map), readable by older
+    /// versions. Files without them are smaller and can be memory mapped without verifying each entry.
+    bool write_cache(const std::string& filename, bool with_legacy_entries = true) {
+        std::vector<SortedCacheTable::Element> all_entries;
+        std::vector<SortedCacheTable64::Element> all_entries64;
+        const CacheFileInfo to_write{collect_all_entries(all_entries, all_entries64)};
+        return write_entries(filename, std::move(all_entries), std::move(all_entries64), with_legacy_entries,
+                             to_write);
+    }
+
+    /**
+     * @brief writes all entries (FLAT and maps) in a compact file, with the file info of this cache. Not readable by
+     * versions older than the compact format.
+     *
+     * @param encoding the encoding of the values and the relative error allowed
+     */
+    bool write_cache_compact(const std::string& filename, const CompactEncoding& encoding = {}) {
+        std::vector<SortedCacheTable::Element> all_entries;
+        std::vector<SortedCacheTable64::Element> all_entries64;
+        const CacheFileInfo to_write{collect_all_entries(all_entries, all_entries64)};
+        return write_compact_entries(filename, std::move(all_entries), std::move(all_entries64), encoding, to_write);
+    }
+
+    /**
+     * @brief writes lists of entries in a cache file. For duplicated keys the last one wins
+     *
+     * @param entries_list the entries with 32 bit keys
+     * @param entries_list64 the entries with 64 bit keys, written with fingerprints
+     * @param with_legacy_entries if true the 32 bit entries are also written as tables (cache_map)
+     * @param file_info the model nickname, descriptor version and has_fingerprints written in the header. The format
+     * version is decided by the content
+     */
+    static bool write_entries(const std::string& filename, std::vector<SortedCacheTable::Element>&& entries_list,
+                              std::vector<SortedCacheTable64::Element>&& entries_list64, bool with_legacy_entries,
+                              const CacheFileInfo& file_info) {
+        SortedCacheTable sorted_all;
+        sorted_all.adopt(std::move(entries_list));
+        SortedCacheTable64 sorted_all64;
+        sorted_all64.adopt(std::move(entries_list64));
+
         flatbuffers::FlatBufferBuilder fbb;
-        std::vector<flatbuffers::Offset<VPUNN_SCHEMA::Entry>> entries;
-        for (const auto& [key, value] : _map) {
-            auto entry = VPUNN_SCHEMA::CreateEntry(fbb, key, value);
-            entries.push_back(entry);
+        flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<VPUNN_SCHEMA::Entry>>> cache_map{0};
+        if (with_legacy_entries) {
+            std::vector<flatbuffers::Offset<VPUNN_SCHEMA::Entry>> entries;
+            entries.reserve(sorted_all.size());
+            for (const auto& e : sorted_all) {
+                entries.push_back(VPUNN_SCHEMA::CreateEntry(fbb, e.key(), e.value()));
+            }
+            cache_map = fbb.CreateVector(entries);
+        }
+        auto sorted_map = fbb.CreateVectorOfStructs(sorted_all.begin(), sorted_all.size());
+        flatbuffers::Offset<flatbuffers::Vector<const SortedCacheTable64::Element*>> sorted_map64{0};
+        if (sorted_all64.size() > 0) {
+            sorted_map64 = fbb.CreateVectorOfStructs(sorted_all64.begin(), sorted_all64.size());
         }
-        auto cache_map = fbb.CreateVector(entries);
-        auto cache = VPUNN_SCHEMA::CreateCyclesCache(fbb, cache_map);
+        flatbuffers::Offset<flatbuffers::String> nickname{0};
+        if (!file_info.model_nickname.empty()) {
+            nickname = fbb.CreateString(file_info.model_nickname);
+        }
+        const bool wide{sorted_all64.size() > 0};
+        auto header = VPUNN_SCHEMA::CreateCacheHeader(fbb, wide ? 2 : 1, nickname, file_info.descriptor_version,
+                                                      wide && file_info.has_fingerprints);
+        auto cache = VPUNN_SCHEMA::CreateCyclesCache(fbb, cache_map, sorted_map, header, sorted_map64);
         VPUNN_SCHEMA::FinishCyclesCacheBuffer(fbb, cache);
-        std::ofstream file;
-        file.open(filename, std::ios::binary | std::ios::out);
-        if (file.fail()) {
-            return false;
+        return write_buffer(filename, fbb);
+    }
+
+    /**
+     * @brief writes lists of entries in a compact cache file (format version 3): keys sorted and delta coded in
+     * blocks, values encoded as asked. For duplicated keys the last one wins
+     *
+     * @param entries_list the entries with 32 bit keys
+     * @param entries_list64 the entries with 64 bit keys, written with fingerprints if the file info says so
+     * @param encoding the encoding of the values and the relative error allowed. If a section cannot respect the error
+     * its values are written exactly (Float32)
+     * @param file_info the model nickname, descriptor version and has_fingerprints written in the header
+     */
+    static bool write_compact_entries(const std::string& filename,
+                                      std::vector<SortedCacheTable::Element>&& entries_list,
+                                      std::vector<SortedCacheTable64::Element>&& entries_list64,
+                                      const CompactEncoding& encoding, const CacheFileInfo& file_info) {
+        SortedCacheTable sorted_all;
+        sorted_all.adopt(std::move(entries_list));
+        SortedCacheTable64 sorted_all64;
+        sorted_all64.adopt(std::move(entries_list64));
+        const bool fingerprints{(sorted_all64.size() > 0) && file_info.has_fingerprints};
+
+        flatbuffers::FlatBufferBuilder fbb;
+        const auto build_section = [&fbb, &encoding](const auto& table, bool with_fingerprints) {
+            std::vector<uint64_t> keys;
+            std::vector<uint32_t> fingerprints_list;
+            std::vector<float> values;
+            keys.reserve(table.size());
+            values.reserve(table.size());
+            for (const auto& e : table) {
+                keys.push_back(e.key());
+                values.push_back(e.value());
+                if (with_fingerprints) {
+                    fingerprints_list.push_back(fingerprint_of(e));
+                }
+            }
+            return CompactCacheTable::build(fbb, keys, fingerprints_list, values, encoding);
+        };
+        flatbuffers::Offset<VPUNN_SCHEMA::CompactEntries> compact_map{0};
+        if (sorted_all.size() > 0) {
+            compact_map = build_section(sorted_all, false);
         }
-        file.write(reinterpret_cast<const char*>(fbb.GetBufferPointer()), fbb.GetSize());
-        file.close();
-        return true;
+        flatbuffers::Offset<VPUNN_SCHEMA::CompactEntries> compact_map64{0};
+        if (sorted_all64.size() > 0) {
+            compact_map64 = build_section(sorted_all64, fingerprints);
+        }
+        flatbuffers::Offset<flatbuffers::String> nickname{0};
+        if (!file_info.model_nickname.empty()) {
+            nickname = fbb.CreateString(file_info.model_nickname);
+        }
+        auto header = VPUNN_SCHEMA::CreateCacheHeader(fbb, 3, nickname, file_info.descriptor_version, fingerprints);
+        auto cache = VPUNN_SCHEMA::CreateCyclesCache(fbb, 0, 0, header, 0, compact_map, compact_map64);
+        VPUNN_SCHEMA::FinishCyclesCacheBuffer(fbb, cache);
+        return write_buffer(filename, fbb);
+    }
+
+    /**
+     * @brief adds to the FLAT entries the ones of a cache file made for the same model (e.g. a snapshot of a dynamic
+     * cache). The entries already present keep their value. A file made for another model or descriptor version is
+     * ignored.
+     *
+     * Not thread safe, to be used before the cache is shared.
+     *
+     * @param filename the cache file to merge
+     * @param model_nickname the model expected in the file, must be the one written in it
+     * @param descriptor_version the descriptor version expected in the file, must be the one written in it
+     * @param merged [out] if not null, receives the 32 bit entries that were added
+     * @param merged64 [out] if not null, receives the 64 bit entries that were added
+     * @returns the number of entries added
+     */
+    size_t merge_cache_flat(const std::string& filename, const std::string& model_nickname,
+                            const int32_t descriptor_version,
+                            std::vector<SortedCacheTable::Element>* merged = nullptr,
+                            std::vector<SortedCacheTable64::Element>* merged64 = nullptr) {
+        MappedFile file{filename};
+        if (!file.is_mapped()) {
+            return 0;
+        }
+        const auto* cache_content = get_verified_content(file.data(), file.size());
+        if (cache_content == nullptr) {
+            Logger::warning() << "\n Cache file " << filename << " is not a valid cache, not merged\n";
+            return 0;
+        }
+        const CacheFileInfo file_info{read_file_info(cache_content)};
+        if ((file_info.model_nickname != model_nickname) || (file_info.descriptor_version != descriptor_version)) {
+            Logger::warning() << "\n Cache file " << filename << " was made for model [" << file_info.model_nickname
+                              << "] descriptor version " << file_info.descriptor_version << ", expected ["
+                              << model_nickname << "] descriptor version " << descriptor_version << ", not merged\n";
+            return 0;
+        }
+
+        std::vector<SortedCacheTable::Element> entries{collect_entries(cache_content)};
+        std::vector<SortedCacheTable64::Element> entries64{collect_entries64(cache_content)};
+        collect_compact_entries(cache_content, entries, entries64);
+        // the preloaded compact entries are kept
+        entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                     [this](const SortedCacheTable::Element& e) {
+                                         return compact_table.contains(e.key());
+                                     }),
+                      entries.end());
+        entries64.erase(std::remove_if(entries64.begin(), entries64.end(),
+                                       [this, &file_info](const SortedCacheTable64::Element& e) {
+                                           // the fingerprint is the 32 bit key, a preloaded 32 bit entry is kept
+                                           return compact_table64.contains(e.key()) ||
+                                                  (file_info.has_fingerprints &&
+                                                   (sorted_table.contains(e.fingerprint()) ||
+                                                    compact_table.contains(e.fingerprint())));
+                                       }),
+                        entries64.end());
+        const bool had_wide_entries{(sorted_table64.size() > 0) || (compact_table64.size() > 0)};
+        const size_t added64{merge_into(sorted_table64, std::move(entries64), merged64)};
+        if (added64 > 0) {  // fingerprints are checked only if all the entries have them
+            info.has_fingerprints = (info.has_fingerprints || !had_wide_entries) && file_info.has_fingerprints;
+        }
+        const size_t added{merge_into(sorted_table, std::move(entries), merged) + added64};
+        if ((added > 0) && !sorted_table.is_referenced() && !sorted_table64.is_referenced() &&
+            !compact_table.is_referenced() && !compact_table64.is_referenced()) {
+            mapped_file = MappedFile{};  // the entries are owned now, a previous mapping is not referenced anymore
+        }
+        return added;
     }
 
     size_t getCacheSize() const {
-        return _map.size();
+        size_t in_maps{0};
+        if (map_in_use.load(std::memory_order_acquire)) {
+            std::shared_lock lock(_mutex);
+            in_maps = _map.size() + wide_map.size();
+        }
+        return sorted_table.size() + sorted_table64.size() + compact_table.size() + compact_table64.size() + in_maps;
+    }
+
+private:
+    void count(const bool hit) const {
+        if (hit) {
+            counter.hit();
+        } else {
+            counter.miss();
+        }
+    }
+
+    std::optional<float> find_narrow(const uint32_t key) const {
+        std::optional<float> value{sorted_table.find(key)};
+        if (!value) {
+            value = compact_table.find(key);
+        }
+        if ((!value) && map_in_use.load(std::memory_order_acquire)) {
+            float found{0};
+            if (ThreadSafeMap::find(key, found)) {
+                value = found;
+            }
+        }
+        return value;
+    }
+
+    /// the 64 bit entry, if its fingerprint matches. A mismatch is a collision of the 64 bit keys, not a hit
+    std::optional<float> find_wide(const uint64_t key64, const uint32_t fingerprint) const {
+        const auto* entry{sorted_table64.locate(key64)};
+        if (entry) {
+            if (info.has_fingerprints && (entry->fingerprint() != fingerprint)) {
+                return std::nullopt;
+            }
+            return entry->value();
+        }
+        const auto index{compact_table64.index_of(key64)};
+        if (index) {
+            if (info.has_fingerprints && compact_table64.has_fingerprints() &&
+                (compact_table64.fingerprint_at(*index) != fingerprint)) {
+                return std::nullopt;
+            }
+            return compact_table64.value_at(*index);
+        }
+        if (map_in_use.load(std::memory_order_acquire)) {
+            std::shared_lock lock(_mutex);
+            const auto it{wide_map.find(key64)};
+            if ((it != wide_map.cend()) && (it->second.fingerprint() == fingerprint)) {
+                return it->second.value();
+            }
+        }
+        return std::nullopt;
+    }
+
+    /// all the entries, preloaded and inserted, and the file info describing them
+    CacheFileInfo collect_all_entries(std::vector<SortedCacheTable::Element>& all_entries,
+                                      std::vector<SortedCacheTable64::Element>& all_entries64) const {
+        all_entries.assign(sorted_table.begin(), sorted_table.end());
+        all_entries64.assign(sorted_table64.begin(), sorted_table64.end());
+        compact_table.for_each([&all_entries](uint64_t key, uint32_t, float value) {
+            all_entries.emplace_back(static_cast<uint32_t>(key), value);
+        });
+        compact_table64.for_each([&all_entries64](uint64_t key, uint32_t fingerprint, float value) {
+            all_entries64.emplace_back(key, fingerprint, value);
+        });
+        {
+            std::shared_lock lock(_mutex);
+            all_entries.reserve(all_entries.size() + _map.size());
+            for (const auto& [key, value] : _map) {
+                all_entries.emplace_back(key, value);
+            }
+            for (const auto& [key, entry] : wide_map) {
+                all_entries64.push_back(entry);
+            }
+        }
+        CacheFileInfo to_write{info};
+        // inserted ones have them
+        to_write.has_fingerprints = info.has_fingerprints || ((sorted_table64.size() == 0) &&
+                                                              (compact_table64.size() == 0));
+        // map entries have no duplicates in flat tables
+        return to_write;
+    }
+
+    static uint32_t fingerprint_of(const SortedCacheTable::Element&) {
+        return 0;
+    }
+    static uint32_t fingerprint_of(const SortedCacheTable64::Element& e) {
+        return e.fingerprint();
+    }
+
+    /// the file is replaced, never rewritten in place: it may be memory mapped by this or other processes
+    static bool write_buffer(const std::string& filename, const flatbuffers::FlatBufferBuilder& fbb) {
+        return write_file_replacing(filename, reinterpret_cast<const char*>(fbb.GetBufferPointer()), fbb.GetSize());
+    }
+
+    /// adds to the table the entries with new keys
+    /// @returns the number of entries added
+    template <typename Table>
+    static size_t merge_into(Table& table, std::vector<typename Table::Element>&& entries,
+                             std::vector<typename Table::Element>* merged) {
+        std::vector<typename Table::Element> added;
+        for (const auto& entry : entries) {
+            if (!table.contains(entry.key())) {
+                added.push_back(entry);
+            }
+        }
+        if (added.empty()) {
+            return 0;
+        }
+        std::vector<typename Table::Element> all_entries{added};  // duplicates in the file: last one wins
+        all_entries.insert(all_entries.end(), table.begin(), table.end());
+        table.adopt(std::move(all_entries));
+        if (merged) {
+            merged->insert(merged->end(), added.cbegin(), added.cend());
+        }
+        return added.size();
+    }
+
+    static const VPUNN_SCHEMA::CyclesCache* get_verified_content(const char* file_data, size_t file_data_length) {
+        if (file_data == nullptr) {
+            return nullptr;
+        }
+        flatbuffers::Verifier verifier(reinterpret_cast<const uint8_t*>(file_data), file_data_length);
+        if (!(VPUNN_SCHEMA::VerifyCyclesCacheBuffer(verifier))) {
+            return nullptr;
+        }
+        return VPUNN_SCHEMA::GetCyclesCache(file_data);
+    }
+
+    /// the header of a file, the defaults for older files without it
+    static CacheFileInfo read_file_info(const VPUNN_SCHEMA::CyclesCache* cache_content) {
+        CacheFileInfo file_info;
+        const auto* header = cache_content->header();
+        if (header != nullptr) {
+            file_info.format_version = header->format_version();
+            file_info.model_nickname = header->model_nickname() ? header->model_nickname()->str() : "";
+            file_info.descriptor_version = header->descriptor_version();
+            file_info.has_fingerprints = header->has_fingerprints();
+        }
+        return file_info;
+    }
+
+    /// all entries of a cache, in file order. The sorted section is preferred, is equivalent and cheaper to read
+    static std::vector<SortedCacheTable::Element> collect_entries(const VPUNN_SCHEMA::CyclesCache* cache_content) {
+        std::vector<SortedCacheTable::Element> entries;
+        if (cache_content->sorted_map() != nullptr) {
+            const auto* sorted = cache_content->sorted_map();
+            const auto* first = reinterpret_cast<const SortedCacheTable::Element*>(sorted->Data());
+            entries.assign(first, first + sorted->size());
+        } else if (cache_content->cache_map() != nullptr) {
+            entries.reserve(cache_content->cache_map()->size());
+            for (const auto& entry : *cache_content->cache_map()) {
+                entries.emplace_back(entry->key(), entry->value());
+            }
+        }
+        return entries;
+    }
+
+    /// appends the decoded entries of the compact sections of a cache. Nothing for files without them
+    static void collect_compact_entries(const VPUNN_SCHEMA::CyclesCache* cache_content,
+                                        std::vector<SortedCacheTable::Element>& entries,
+                                        std::vector<SortedCacheTable64::Element>& entries64) {
+        CompactCacheTable compact;
+        if (compact.load(cache_content->compact_map(), false)) {
+            compact.for_each([&entries](uint64_t key, uint32_t, float value) {
+                entries.emplace_back(static_cast<uint32_t>(key), value);
+            });
+        }
+        if (compact.load(cache_content->compact_map64(), false)) {
+            compact.for_each([&entries64](uint64_t key, uint32_t fingerprint, float value) {
+                entries64.emplace_back(key, fingerprint, value);
+            });
+        }
+    }
+
+    /// all 64 bit entries of a cache, in file order. Empty for v1 files
+    static std::vector<SortedCacheTable64::Element> collect_entries64(const VPUNN_SCHEMA::CyclesCache* cache_content) {
+        std::vector<SortedCacheTable64::Element> entries;
+        if (cache_content->sorted_map64() != nullptr) {
+            const auto* sorted = cache_content->sorted_map64();
+            const auto* first = reinterpret_cast<const SortedCacheTable64::Element*>(sorted->Data());
+            entries.assign(first, first + sorted->size());
+        }
+        return entries;
     }
 };
 
@@ -10,12 +10,15 @@
 #ifndef CORE_TENSORS_H
 #define CORE_TENSORS_H
 
+#include <cstdint>
 #include <cstring>
 #include <iostream>
+#include <new>
 #include <numeric>
 #include <random>
 #include <sstream>  // for error formating
 #include <stdexcept>
+#include <type_traits>
 #include <vector>
 
 #include "core/vpunn_api.h"
@@ -29,10 +32,57 @@ namespace VPUNN {
  */
 template <typename T>
 class VPUNN_API Tensor {
+    static_assert(std::is_trivially_copyable<T>::value && std::is_trivially_destructible<T>::value,
+                  "Tensor data is copied as raw memory and is never constructed/destroyed element by element");
+
+public:
+    /// alignment of the memory allocated by tensors, one cache line, enough for the widest (AVX-512) vector loads
+    static constexpr std::size_t data_alignment{64};
+
 private:
+    /// how the _data memory is owned, decides how it is released
+    enum class Ownership {
+        aligned,  ///< allocated by this class, aligned to data_alignment
+        array,    ///< allocated by the user with new[], ownership transferred to this instance
+        view,     ///< external memory, not owned, never deleted
+    };
+
     std::vector<unsigned int> _dimensions;  ///< describes the data  represented as a multidimensional tensor
     int _size;                              ///< number of elements in the _data array
     T* _data;                               ///< the data array. The instance is the owner of this heap allocated memory
+                                            ///< unless it is a view
+    Ownership _ownership{Ownership::aligned};  ///< how _data is released
+
+    /// view constructor, see view()
+    Tensor(const T* data, const std::vector<unsigned int>& dimensions, Ownership ownership)
+            : _dimensions(dimensions), _data(const_cast<T*>(data)), _ownership(ownership) {
+        _size = std::accumulate(begin(dimensions), end(dimensions), 1, std::multiplies<unsigned int>());
+    }
+
+    /// @returns uninitialized memory for size elements, aligned to data_alignment
+    static T* allocate(int size) {
+        return static_cast<T*>(::operator new[](sizeof(T) * static_cast<std::size_t>(size),
+                                                std::align_val_t{data_alignment}));
+    }
+
+    /// @throws runtime_error if the data is a read only view, called by every method giving mutable access
+    void check_writable() const {
+        if (_ownership == Ownership::view) {
+            throw std::runtime_error("Tensor: the data of a view is read only, make a copy to change it");
+        }
+    }
+
+    /// releases the owned memory according to its ownership kind
+    void release() noexcept {
+        if (_data == nullptr) {
+            return;
+        }
+        if (_ownership == Ownership::aligned) {
+            ::operator delete[](_data, std::align_val_t{data_alignment});
+        } else if (_ownership == Ownership::array) {
+            delete[] _data;
+        }
+    }
 
 public:
     /**
@@ -43,20 +93,43 @@ public:
      */
     explicit Tensor(const std::vector<unsigned int>& dimensions): _dimensions(dimensions) {
         _size = std::accumulate(begin(dimensions), end(dimensions), 1, std::multiplies<unsigned int>());
-        _data = new T[_size];
+        _data = allocate(_size);
     }
 
     /**
      * @brief Construct a new Tensor object from existing preallocated memory
      *
-     * @param data a pointer to the tensor initialization data, the ownership is transferred to this instance
+     * @param data a pointer to the tensor initialization data, the ownership is transferred to this instance.
+     * Must be allocated with new[], its alignment is the one given by the user
      * @param dimensions a vector of unsigned integers representing the Tensor's dimensions. Must be consistent with
      * what data holds
      */
-    Tensor(T* data, const std::vector<unsigned int>& dimensions): _dimensions(dimensions), _data(data) {
+    Tensor(T* data, const std::vector<unsigned int>& dimensions)
+            : _dimensions(dimensions), _data(data), _ownership(Ownership::array) {
         _size = std::accumulate(begin(dimensions), end(dimensions), 1, std::multiplies<unsigned int>());
     }
 
+    /// @returns true if the memory is aligned enough to be accessed as T elements, required by view()
+    static bool can_view(const void* data) {
+        return (reinterpret_cast<std::uintptr_t>(data) % alignof(T)) == 0;
+    }
+
+    /**
+     * @brief Creates a read only view over existing memory. No allocation, no copy, the memory is not owned.
+     * The memory must outlive the tensor. Only const access is allowed: data(), assign(), fill() and the non const
+     * operator[] throw. A copy of a view is a normal tensor owning its own copy of the data.
+     *
+     * @param data the external memory, must hold the number of elements described by dimensions
+     * @param dimensions a vector of unsigned integers representing the Tensor's dimensions
+     * @throws runtime_error if data is not aligned for T, see can_view()
+     */
+    static Tensor view(const T* data, const std::vector<unsigned int>& dimensions) {
+        if (!can_view(data)) {
+            throw std::runtime_error("Tensor::view(), the memory is not aligned for the tensor datatype");
+        }
+        return Tensor(data, dimensions, Ownership::view);
+    }
+
     /**
      * @brief Construct a new Tensor object and fills it with a value
      *
@@ -77,7 +150,7 @@ public:
         _size = tensor._size;
 
         // allocate new memory and then copy
-        _data = new T[_size];
+        _data = allocate(_size);
         assign(tensor._data, sizeof(T) * tensor._size);
     }
 
@@ -87,12 +160,14 @@ public:
      *
      * @param tensor to move the contents from
      */
-    Tensor(Tensor&& tensor) noexcept: _dimensions{std::move(tensor._dimensions)}, _size{tensor._size} {
+    Tensor(Tensor&& tensor) noexcept
+            : _dimensions{std::move(tensor._dimensions)}, _size{tensor._size}, _ownership{tensor._ownership} {
         _data = tensor._data;  // move the data, now we own it
 
         // leave the source tensor in a consistent state
         tensor._data = nullptr;  // remove the data from previous owner
         tensor._size = 0;
+        tensor._ownership = Ownership::aligned;
     }
 
     /**
@@ -107,15 +182,15 @@ public:
             return *this;  // self assignment
         }
 
-        if (_data != nullptr) {
-            delete[] _data;  // clean up already allocated memory
-        }
+        release();  // clean up already allocated memory
+        _data = nullptr;
 
         _dimensions = tensor._dimensions;
         _size = tensor._size;
+        _ownership = Ownership::aligned;
 
         // allocate new memory and then copy
-        _data = new T[_size];
+        _data = allocate(_size);
         assign(tensor._data, sizeof(T) * tensor._size);
         return *this;
     }
@@ -135,6 +210,7 @@ public:
         std::swap(this->_data, tensor._data);  // our data will be deallocated by the tensor's destruction
         std::swap(this->_dimensions, tensor._dimensions);
         std::swap(this->_size, tensor._size);
+        std::swap(this->_ownership, tensor._ownership);
 
         return *this;
     }
@@ -144,7 +220,12 @@ public:
      *
      */
     ~Tensor() {
-        delete[] _data;
+        release();
+    }
+
+    /// @returns true if the data is not owned, it is a view over external memory
+    bool is_view() const {
+        return _ownership == Ownership::view;
     }
 
     /**
@@ -152,9 +233,11 @@ public:
      * Ownership is not transferred, pointer is not guaranteed to be preserved by other Tensor operations, like
      * assignment
      *
+     * @throws runtime_error if the tensor is a read only view
      * @return T*
      */
     T* data() {
+        check_writable();
         return _data;
     }
 
@@ -187,9 +270,11 @@ public:
      * @param size_in_bytes the size of the data buffer in bytes
      * @throws runtime_error in case the input size is not aligned (not a int number of Ts)
      * @throws runtime_error in case the input size is NOT equal to available data
+     * @throws runtime_error if the tensor is a read only view
      * @return Tensor<T>& self reference
      */
     Tensor<T>& assign(const T* data, const unsigned int size_in_bytes) {
+        check_writable();
         // Check that size is a multiple of the datatype, integer number of Ts
         if (size_in_bytes % sizeof(T)) {
             throw std::runtime_error("Trying to assign a non-aligned buffer to a tensor");
@@ -214,9 +299,11 @@ public:
      * @brief Return a reference to an internal buffer element. No boundary check is performed
      *
      * @param idx the index
+     * @throws runtime_error if the tensor is a read only view
      * @return T& a reference to the internal buffer element
      */
     T& operator[](const int idx) {
+        check_writable();
         return _data[idx];
     }
 
@@ -252,9 +339,11 @@ public:
      * @brief Fill a tensor with a value
      *
      * @param value
+     * @throws runtime_error if the tensor is a read only view
      * @return Tensor&
      */
     Tensor& fill(T value) {
+        check_writable();
         for (int idx = 0; idx < _size; idx++) {
             _data[idx] = value;
         }
@@ -0,0 +1,172 @@
+// Copyright © 2025 Intel Corporation
+// SPDX-License-Identifier: Apache 2.0
+// LEGAL NOTICE: Your use of this software and any required dependent software (the “Software Package”)
+// is subject to the terms and conditions of the software license agreements for the Software Package,
+// which may also include notices, disclaimers, or license terms for third party or open source software
+// included in or with the Software Package, and your use indicates your acceptance of all such terms.
+// Please refer to the “third-party-programs.txt” or other similarly-named text file included with the
+// Software Package for additional details.
+
+#ifndef VPUNN_THREAD_POOL_H
+#define VPUNN_THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace VPUNN {
+
+/**
+ * @brief Fixed size pool of worker threads, used to run independent items of work in parallel.
+ *
+ * The calling thread also takes part in the work, so a pool with zero workers runs everything inline, and nested use
+ * (parallel_for called from inside a parallel_for item) cannot deadlock.
+ * The order in which items are executed is not defined; results must be stored by item index to be deterministic.
+ */
+class ThreadPool {
+public:
+    /// @param workers_count number of worker threads created, zero means all the work is done by the calling thread
+    explicit ThreadPool(size_t workers_count) {
+        workers.reserve(workers_count);
+        for (size_t i = 0; i < workers_count; ++i) {
+            workers.emplace_back([this]() {
+                worker_loop();
+            });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stopping = true;
+        }
+        cv.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    /// @returns the number of worker threads (not counting the calling thread)
+    size_t workers_count() const {
+        return workers.size();
+    }
+
+    /**
+     * @brief runs item(i) for every i in [0, items_count), in parallel. Returns when all items are done.
+     * If items throw, the first exception is rethrown here after all items finished.
+     *
+     * @param items_count how many items
+     * @param item callable with a size_t parameter (the item index), must be safe to call concurrently
+     */
+    template <class F>
+    void parallel_for(size_t items_count, F&& item) {
+        if (items_count == 0) {
+            return;
+        }
+        if ((items_count == 1) || workers.empty()) {
+            for (size_t i = 0; i < items_count; ++i) {
+                item(i);
+            }
+            return;
+        }
+
+        auto job{std::make_shared<Job>(items_count, [&item](size_t i) {
+            item(i);
+        })};
+        const size_t helpers{std::min(workers.size(), items_count - 1)};
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            for (size_t h = 0; h < helpers; ++h) {
+                tasks.emplace_back([job]() {
+                    job->run_items();
+                });
+            }
+        }
+        cv.notify_all();
+
+        job->run_items();  // this thread works too
+        job->wait_all_done();
+    }
+
+private:
+    /// the shared state of one parallel_for. Helpers that start late find no items left and do not use the item
+    struct Job {
+        Job(size_t count, std::function<void(size_t)> f): items_count{count}, item{std::move(f)} {
+        }
+
+        const size_t items_count;
+        const std::function<void(size_t)> item;  ///< references the caller's callable, used only while items remain
+        std::atomic<size_t> next_item{0};
+
+        std::mutex done_mtx;
+        std::condition_variable done_cv;
+        size_t done_count{0};                     ///< protected by done_mtx
+        std::exception_ptr first_error{nullptr};  ///< protected by done_mtx
+
+        void run_items() {
+            for (size_t i = next_item.fetch_add(1); i < items_count; i = next_item.fetch_add(1)) {
+                std::exception_ptr error{nullptr};
+                try {
+                    item(i);
+                } catch (...) {
+                    error = std::current_exception();
+                }
+                std::lock_guard<std::mutex> lock(done_mtx);
+                if (error && !first_error) {
+                    first_error = error;
+                }
+                if (++done_count == items_count) {
+                    done_cv.notify_all();
+                }
+            }
+        }
+
+        void wait_all_done() {
+            std::unique_lock<std::mutex> lock(done_mtx);
+            done_cv.wait(lock, [this]() {
+                return done_count == items_count;
+            });
+            if (first_error) {
+                std::rethrow_exception(first_error);
+            }
+        }
+    };
+
+    void worker_loop() {
+        for (;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                cv.wait(lock, [this]() {
+                    return stopping || !tasks.empty();
+                });
+                if (tasks.empty()) {  // stopping and nothing left
+                    return;
+                }
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;  ///< protected by mtx
+    bool stopping{false};                     ///< protected by mtx
+    std::mutex mtx;
+    std::condition_variable cv;
+};
+
+}  // namespace VPUNN
+
+#endif  // VPUNN_THREAD_POOL_H
@@ -10,14 +10,18 @@
 #ifndef VPUNN_CORE_UTILS_H
 #define VPUNN_CORE_UTILS_H
 
+#include <charconv>
+#include <cstdint>
 #include <cmath>
 #include <iostream>
+#include <map>
 #include <mutex>
 #include <shared_mutex>
 #include <sstream>
 #include <string>
 #include <string_view>
 #include <thread>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 #include <algorithm>
@@ -190,6 +194,25 @@ inline const std::string vec2int_str(const std::vector<int>& vec) {
 constexpr uint32_t fnv_prime = 0x01000193;         // FNV-1a prime
 constexpr uint32_t fnv_offset_basis = 0x811c9dc5;  // FNV-1a offset basis
 
+constexpr uint64_t fnv_prime_64 = 0x00000100000001b3ULL;         // FNV-1a 64b prime
+constexpr uint64_t fnv_offset_basis_64 = 0xcbf29ce484222325ULL;  // FNV-1a 64b offset basis
+
+/// FNV-1a constants for a hash of type H (uint32_t or uint64_t)
+template <typename H>
+struct FNV1aParams;
+
+template <>
+struct FNV1aParams<uint32_t> {
+    static constexpr uint32_t prime{fnv_prime};
+    static constexpr uint32_t offset_basis{fnv_offset_basis};
+};
+
+template <>
+struct FNV1aParams<uint64_t> {
+    static constexpr uint64_t prime{fnv_prime_64};
+    static constexpr uint64_t offset_basis{fnv_offset_basis_64};
+};
+
 // 32b Fowler-Noll-Vo hash function with string input
 inline uint32_t fnv1a_hash(const std::string& str) {
     uint32_t h = fnv_offset_basis;  // FNV-1a base
@@ -201,11 +224,74 @@ inline uint32_t fnv1a_hash(const std::string& str) {
     return h;
 }
 
+/**
+ * @brief FNV-1a hash of a text that is given in pieces, without building the text.
+ *
+ * The 32b hash is the same as fnv1a_hash(std::string) of the concatenated pieces. Numbers are added as the characters
+ * that a std::ostream (integers, floats) or std::to_string (fixed_float) would write, in the "C" locale.
+ *
+ * @tparam H the hash type, uint32_t or uint64_t
+ */
+template <typename H>
+class BasicFNV1aTextHasher {
+public:
+    BasicFNV1aTextHasher& add(std::string_view text) {
+        for (char c : text) {
+            h ^= static_cast<H>(c);
+            h *= FNV1aParams<H>::prime;
+        }
+        return *this;
+    }
+
+    /// adds the decimal representation of an integral value, like `stream << value`
+    template <typename T, std::enable_if_t<std::is_integral_v<T>, bool> = true>
+    BasicFNV1aTextHasher& add_number(const T value) {
+        char buffer[24];  // enough for any 64 bit integer
+        const auto result{std::to_chars(buffer, buffer + sizeof(buffer), value)};
+        return add(std::string_view(buffer, static_cast<size_t>(result.ptr - buffer)));
+    }
+
+    /// adds a float like `stream << value` does with default formatting (%g, 6 digits)
+    BasicFNV1aTextHasher& add_number(const float value) {
+        char buffer[32];
+        const auto result{std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::general, 6)};
+        return add(std::string_view(buffer, static_cast<size_t>(result.ptr - buffer)));
+    }
+
+    /// adds a float like std::to_string(value) does (%f)
+    BasicFNV1aTextHasher& add_fixed_float(const float value) {
+        char buffer[64];  // %f of the largest float has 46 characters
+        const auto result{std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::fixed, 6)};
+        return add(std::string_view(buffer, static_cast<size_t>(result.ptr - buffer)));
+    }
+
+    H value() const {
+        return h;
+    }
+
+private:
+    H h{FNV1aParams<H>::offset_basis};
+};
+
+using FNV1aTextHasher = BasicFNV1aTextHasher<uint32_t>;    ///< 32b, the hash of the existing caches
+using FNV1a64TextHasher = BasicFNV1aTextHasher<uint64_t>;  ///< 64b, the key of the v2 caches
+
+/// @brief adds the 4 bytes of a value to a FNV-1a hash, lowest byte first
+template <typename H>
+inline H fnv1a_add_uint32(H h, const uint32_t value) {
+    h = (h ^ (value & 0xFF)) * FNV1aParams<H>::prime;
+    h = (h ^ ((value >> 8) & 0xFF)) * FNV1aParams<H>::prime;
+    h = (h ^ ((value >> 16) & 0xFF)) * FNV1aParams<H>::prime;
+    h = (h ^ (value >> 24)) * FNV1aParams<H>::prime;
+    return h;
+}
+
 // Function to calculate the FNV-1a hash of a vector of floats, treating them as integers.
 // force_fractional_rescale: if true, rescale the fractional floats (0, +-1) to an integer value to avoid precision
 // related hash issues Needed for eg. sparsity values.
-inline uint32_t fnv1a_hash(const std::vector<float>& vec, const bool force_fractional_rescale = true) {
-    uint32_t h = fnv_offset_basis;
+template <typename H>
+inline H fnv1a_hash_as(const std::vector<float>& vec, const bool force_fractional_rescale = true) {
+    H h = FNV1aParams<H>::offset_basis;
 
     for (const float c : vec) {
         uint32_t value;
@@ -218,15 +304,22 @@ inline uint32_t fnv1a_hash(const std::vector<float>& vec, const bool force_fract
         }
 
         // For each byte in the integer, apply the FNV-1a hash
-        h = (h ^ (value & 0xFF)) * fnv_prime;
-        h = (h ^ ((value >> 8) & 0xFF)) * fnv_prime;
-        h = (h ^ ((value >> 16) & 0xFF)) * fnv_prime;
-        h = (h ^ (value >> 24)) * fnv_prime;
+        h = fnv1a_add_uint32(h, value);
     }
 
     return h;
 }
 
+/// 32b FNV-1a hash of a vector of floats, @sa fnv1a_hash_as
+inline uint32_t fnv1a_hash(const std::vector<float>& vec, const bool force_fractional_rescale = true) {
+    return fnv1a_hash_as<uint32_t>(vec, force_fractional_rescale);
+}
+
+/// 64b FNV-1a hash of a vector of floats, @sa fnv1a_hash_as
+inline uint64_t fnv1a_hash64(const std::vector<float>& vec, const bool force_fractional_rescale = true) {
+    return fnv1a_hash_as<uint64_t>(vec, force_fractional_rescale);
+}
+
 // Define the has_hash trait for this namespace
 template <typename, typename = std::void_t<>>
 struct has_hash : std::false_type {};
@@ -237,6 +330,16 @@ struct has_hash<T, std::void_t<decltype(std::declval<T>().hash())>> : std::true_
 template <typename T>
 inline constexpr bool has_hash_v = has_hash<T>::value;
 
+/// true if T has a hash64() method, the 64b key in the v2 caches
+template <typename, typename = std::void_t<>>
+struct has_hash64 : std::false_type {};
+
+template <typename T>
+struct has_hash64<T, std::void_t<decltype(std::declval<T>().hash64())>> : std::true_type {};
+
+template <typename T>
+inline constexpr bool has_hash64_v = has_hash64<T>::value;
+
 /// An ugly mechanism to generate a hash for a float vector descriptor
 template <typename T>
 struct NNDescriptor {
@@ -248,6 +351,10 @@ struct NNDescriptor {
     uint32_t hash() const {
         return fnv1a_hash(_desc);
     }
+
+    uint64_t hash64() const {
+        return fnv1a_hash64(_desc);
+    }
 };
 
 inline std::string trim_csv_str(const std::string& str) {
@@ -30,6 +30,12 @@
 
 #include <nlohmann/json.hpp>
 
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #include "vpu/types.h"
 #include "vpu/validation/data_dpu_operation.h"
 
@@ -60,7 +66,8 @@ public:
      */
     HTTPClient(const std::string host, int port)
             : _host(host), _port(port), _client(_host, _port), _debug(false) {
-              };
+        _client.set_keep_alive(true);  // one connection for all the requests of this client
+    };
 
     /**
      * @brief Sends a JSON request to the specified path.
@@ -70,6 +77,15 @@ public:
      */
     nlohmann::json sendJsonRequest(const nlohmann::json& payload, const std::string& path);
 
+    /**
+     * @brief Sends a JSON request to the specified path, and tells the HTTP status of the response.
+     * @param payload The JSON payload to send.
+     * @param path The endpoint path for the request.
+     * @param status Set to the HTTP status of the response, also when its body is not JSON. 0 if there is no response.
+     * @return The JSON response from the server.
+     */
+    nlohmann::json sendJsonRequest(const nlohmann::json& payload, const std::string& path, int& status);
+
     /**
      * @brief Enable or disable debug output.
      * @param enable True to enable debug output, false to disable.
@@ -106,14 +122,33 @@ public:
     bool is_available(const std::string& check_backend = "");
 };
 
+/**
+ * @struct HttpBatchOptions
+ * @brief How HttpDPUCostProvider::getCosts talks to the profiling service.
+ */
+struct HttpBatchOptions {
+    size_t max_batch_size{64};  ///< Maximum number of DPUOperations in one batch request.
+    size_t max_in_flight{4};    ///< Maximum number of requests waiting for a response, each has its own connection.
+};
+
 /**
  * @class HttpDPUCostProvider
  * @brief Provides DPU cost metrics via HTTP requests.
  */
 class HttpDPUCostProvider {
 public:
-    HttpDPUCostProvider(const std::string host = "irlccggpu04.ir.intel.com", const int port = 5000): _client(host, port), _debug(false) {};
-    
+    /**
+     * @struct CostResult
+     * @brief The cost of one DPUOperation and the message of the service about it.
+     */
+    struct CostResult {
+        CyclesInterfaceType cycles{Cycles::ERROR_PROFILING_SERVICE};  ///< The cost or an error code.
+        std::string info;                                             ///< Message of the service.
+    };
+
+    HttpDPUCostProvider(const std::string host = "irlccggpu04.ir.intel.com", const int port = 5000)
+            : _client(host, port), _host(host), _port(port), _debug(false) {};
+
     /**
      * @brief Retrieves the cost associated with a given DPU operation.
      * @param op The DPUOperation for which to get the cost.
@@ -123,6 +158,51 @@ public:
      */
     CyclesInterfaceType getCost(const DPUOperation& op, std::string& info, const std::string& backend = "silicon");
 
+    /**
+     * @brief Retrieves the costs of many DPU operations with few round trips.
+     * @details The operations are sent in batches of HttpBatchOptions::max_batch_size to the batch endpoint, with up to
+     * HttpBatchOptions::max_in_flight requests at the same time over keep-alive connections. If the service has no
+     * batch endpoint (or a batch fails) the remaining operations are sent one per request, on the same connections.
+     * The batch endpoint is not tried anymore only if the service answers that it has none (HTTP 404 or 405), after
+     * other failures it is tried again at the next call.
+     * @param ops The DPUOperations, not owned.
+     * @param backend The backend to use for retrieving cost.
+     * @return The cost and message of each operation, same order as ops.
+     * @throws std::runtime_error if the service cannot be reached, like getCost.
+     */
+    std::vector<CostResult> getCosts(const std::vector<const DPUOperation*>& ops,
+                                     const std::string& backend = "silicon");
+
+    /**
+     * @brief Retrieves with getCosts the costs of the DPU operations and keeps them for the next getCost calls.
+     * @details The costs are added to the ones kept by the previous calls (e.g. for other backends) until
+     * clearPrefetched. Only valid costs are kept: errors are not reported here, getCost will ask again for an
+     * operation without a kept cost.
+     * @param ops The DPUOperations, not owned.
+     * @param backend The backend to use for retrieving cost.
+     */
+    void prefetchCosts(const std::vector<const DPUOperation*>& ops, const std::string& backend = "silicon");
+
+    /// @brief Forgets the costs kept by prefetchCosts.
+    void clearPrefetched() {
+        std::lock_guard<std::mutex> lock(_prefetched_mtx);
+        _prefetched.clear();
+    }
+
+    /**
+     * @brief Changes how the batches are sent. The batch endpoint is tried again after this.
+     * @param options The new options.
+     */
+    void setBatchOptions(const HttpBatchOptions& options) {
+        _batch_options = options;
+        _batch_endpoint_available = true;
+    }
+
+    /// @return how the batches are sent.
+    const HttpBatchOptions& getBatchOptions() const {
+        return _batch_options;
+    }
+
     bool is_available(const std::string& check_backend = "") {
         return _client.is_available(check_backend);
     }
@@ -136,9 +216,63 @@ public:
         _client.setDebug(enable);
     }
 
+    /// Endpoint of the single operation requests.
+    static constexpr const char* single_path{"/generate_workload"};
+    /// Endpoint of the batch requests. Request: params and a "dpu_workloads" list. Response: a "results" list with one
+    /// single operation response for each workload, same order.
+    static constexpr const char* batch_path{"/generate_workload_batch"};
+
 private:
     HTTPProfilingClient _client; ///< The HTTPProfilingClient instance.
+    const std::string _host;     ///< The hostname or IP address, for the batch connections.
+    const int _port;             ///< The port number, for the batch connections.
     bool _debug;                 ///< Debug flag for verbose output.
+
+    HttpBatchOptions _batch_options;                                     ///< How getCosts sends the batches.
+    bool _batch_endpoint_available{true};                                ///< False if there is no batch endpoint.
+    std::vector<std::unique_ptr<HTTPProfilingClient>> _batch_clients;   ///< One connection per in-flight request.
+
+    std::unordered_map<std::string, CostResult> _prefetched;  ///< Costs kept by prefetchCosts, see prefetch_key.
+    std::mutex _prefetched_mtx;                               ///< Protects _prefetched.
+
+    /**
+     * @brief The request parameters for a backend.
+     * @param backend The backend to use for retrieving cost.
+     * @return A JSON object for the "params" of a request.
+     */
+    static nlohmann::json profiling_params(const std::string& backend);
+
+    /**
+     * @brief Turns a profiler response of one operation into its cost.
+     * @param response The processed response.
+     * @param info A string to store the message of the response.
+     * @return The cost as CyclesInterfaceType, or an error code.
+     */
+    CyclesInterfaceType cost_of(const ProfilerResponse& response, std::string& info) const;
+
+    /**
+     * @brief Sends one single operation request.
+     * @param client The connection to use.
+     * @param op_json The operation, as produced by dpuop_as_json.
+     * @param info A string to store additional information.
+     * @param backend The backend to use for retrieving cost.
+     * @return The cost as CyclesInterfaceType.
+     */
+    CyclesInterfaceType request_cost(HTTPProfilingClient& client, const nlohmann::json& op_json, std::string& info,
+                                     const std::string& backend);
+
+    /**
+     * @brief Implementation of getCosts, on operations already converted by dpuop_as_json.
+     * @param ops_json The operations.
+     * @param backend The backend to use for retrieving cost.
+     * @return The cost and message of each operation, same order as ops_json.
+     */
+    std::vector<CostResult> request_costs(const std::vector<nlohmann::json>& ops_json, const std::string& backend);
+
+    /// @return the key of an operation in _prefetched
+    static std::string prefetch_key(const nlohmann::json& op_json, const std::string& backend) {
+        return backend + '|' + op_json.dump();
+    }
     
     // TODO -- extend serializer to output json serialized dpu ops.
     /**
@@ -28,6 +28,8 @@
 
 namespace VPUNN {
 /// holds the RW memory that reflects INference model and is used to execute the Model on it.
+/// The constant tensors (weights) are read only views over the model's flatbuffer data, shared by all the instances
+/// created for the same model. Only the activations are allocated per instance. The model must outlive this object.
 /* coverity[rule_of_five_violation:FALSE] */
 class InferenceExecutionData {
 public:
@@ -47,7 +49,7 @@ public:
 
 protected:
     std::vector<Tensor<float>>
-            tensor_map;  ///< this is the memory where actual inputs and inter layer data is kept.
+            tensor_map;  ///< this is the memory where actual inputs and inter layer data is kept (weights are views).
                          ///< You need one instance
                          ///< of this to execute an inference. If multiple inferences have to be run in parallel in the
                          ///< name model, this data placeholder has to be unique per execution thread.
@@ -168,6 +170,20 @@ public:
         tensor_map[input_buffer_cached_IDX].assign(inputs, sizeof(T) * size);
     }
 
+    /**
+     * @brief Direct access to the network input tensor, to be filled in place before running the prediction
+     *
+     * @return float* the input buffer, it has input_size() elements
+     */
+    float* input_data() {
+        return tensor_map[input_buffer_cached_IDX].data();
+    }
+
+    /// @returns the number of elements of the network input tensor
+    unsigned int input_size() const {
+        return static_cast<unsigned int>(tensor_map[input_buffer_cached_IDX].size());
+    }
+
     // get network outputs
     /**
      * @brief Get the outputs tensor values
@@ -11,6 +11,8 @@
 #define PREPROCESSING_H
 
 #include <vpu/types.h>
+#include <algorithm>
+#include <cassert>
 #include <sstream>  // for error formating
 #include <stdexcept>
 #include <string>
@@ -66,6 +68,15 @@ protected:
      */
     virtual const std::vector<T> generate_descriptor(const DPUWorkload& workload, size_t& debug_offset) const = 0;
 
+    /**
+     * @brief Transform a DPUWorkload into a DPUWorkload descriptor written in external memory
+     *
+     * @param workload a DPUWorkload to be transformed
+     * @param destination where to write, must have output_size() elements, zero filled
+     * @param debug_offset [out] will store how many elements were actually written
+     */
+    virtual void generate_descriptor_into(const DPUWorkload& workload, T* destination, size_t& debug_offset) const = 0;
+
 public:
     /// @brief provides the interface number this instance implements
     /// @returns the interface version
@@ -99,6 +110,37 @@ public:
      */
     virtual ~Preprocessing() = default;
 
+    /**
+     * @brief Transform a DPUWorkload into a DPUWorkload descriptor written in place, no allocation
+     *
+     * @param workload the DPUWorkload to transform
+     * @param destination where to write, must have output_size() elements
+     */
+    void transformSingleInto(const DPUWorkload& workload, T* destination) const {
+        std::fill_n(destination, output_size(), static_cast<T>(0.0));
+        size_t unused_output_written_offset{};
+        generate_descriptor_into(workload, destination, unused_output_written_offset);
+    }
+
+    /**
+     * @brief Transform DPUWorkloads into DPUWorkload descriptors written in place, one after the other
+     *
+     * @param workloads a vector of DPUWorkloads
+     * @param destination where to write, must have round_up(workloads.size(), pad) * output_size() elements
+     * @param pad the amount of padding to add (default 1), the batch size. Padding descriptors are zero
+     */
+    void transformBatchInto(const std::vector<DPUWorkload>& workloads, T* destination, unsigned int pad = 1) const {
+        assert(pad > 0);  // pad must be at least 1
+        const auto total_workloads{round_up(static_cast<unsigned int>(workloads.size()), pad)};
+        const size_t descriptor_size{output_size()};
+
+        for (size_t idx = 0; idx < workloads.size(); ++idx) {
+            transformSingleInto(workloads[idx], destination + idx * descriptor_size);
+        }
+        std::fill(destination + workloads.size() * descriptor_size, destination + total_workloads * descriptor_size,
+                  static_cast<T>(0.0));
+    }
+
     /**
      * @brief Transform DPUWorkloads into a DPUWorkload descriptors
      *
@@ -110,23 +152,8 @@ public:
         assert(pad > 0);  // pad must be at least 1
         const auto total_workloads{round_up(static_cast<unsigned int>(workloads.size()), pad)};
 
-        std::vector<T> batch_processed_output;  ///< descriptor like processed_output, but for batch.
-        batch_processed_output.reserve(total_workloads * output_size());
-
-        // zero filled variable with the same size as processed_output
-        const std::vector<T> zero_vector = [](const auto elements_count) {
-            std::vector<T> zero;
-            zero.resize(elements_count, static_cast<T>(0.0));
-            return zero;
-        }(this->output_size());
-
-        for (long unsigned int idx = 0; idx < total_workloads; ++idx) {
-            const std::vector<T> one_descriptor{(idx < workloads.size()) ? transformSingle(workloads[idx])
-                                                                         : zero_vector};
-            assert(one_descriptor.size() == output_size());
-            // copy this result into the big batch descriptor
-            std::copy(one_descriptor.cbegin(), one_descriptor.cend(), std::back_inserter(batch_processed_output));
-        }
+        std::vector<T> batch_processed_output(total_workloads * output_size());
+        transformBatchInto(workloads, batch_processed_output.data(), pad);
         return batch_processed_output;  // RVO
     }
 };
@@ -53,7 +53,7 @@ protected:
         };
         size_t size_required = 0;
         // use the derived class to run a mock of transform only for finding how much it fills in
-        static_cast<const D*>(this)->template transformOnly<true>(dummy_wl, size_required);
+        static_cast<const D*>(this)->template transformOnly<true>(dummy_wl, size_required, nullptr, 0);
         return size_required;
     }
 
@@ -80,9 +80,25 @@ public:
         std::vector<T> descriptor{this->makeSizedContainer()};
         this->check_and_throw_size(static_cast<const D*>(this)->size_of_descriptor);  // will throw in case not matching
 
-        static_cast<const D*>(this)->template transformOnly<false>(workload, debug_offset, descriptor);
+        static_cast<const D*>(this)->template transformOnly<false>(workload, debug_offset, descriptor.data(),
+                                                                   descriptor.size());
         return descriptor;
     };
+
+    /**
+     * @brief Transform a DPUWorkload into a DPUWorkload descriptor written in external memory
+     *
+     * @param workload a DPUWorkload
+     * @param destination where to write, must have output_size() elements, zero filled
+     * @param debug_offset [out] is the offset where a new value can be written. interpreted as how many positions
+     * were written
+     */
+    void generate_descriptor_into(const DPUWorkload& workload, T* destination, size_t& debug_offset) const override {
+        this->check_and_throw_size(static_cast<const D*>(this)->size_of_descriptor);  // will throw in case not matching
+
+        static_cast<const D*>(this)->template transformOnly<false>(workload, debug_offset, destination,
+                                                                   this->output_size());
+    };
 };
 
 }  // namespace VPUNN
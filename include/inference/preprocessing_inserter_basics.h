@@ -27,15 +27,17 @@ namespace VPUNN {
 template <class T>
 class Inserter {
 protected:  // only derived instances allowed
-    Inserter(std::vector<T>& output): external_output(output) {
+    Inserter(std::vector<T>& output): Inserter(output.data(), output.size()) {
+    }
+    Inserter(T* output, size_t size): external_output(output), external_output_size(size) {
     }
 
 private:
-    std::vector<T>&
-            external_output;  ///< external descriptor container, reference should be valid during this lifetime.
+    T* const external_output;  ///< external descriptor memory, should be valid during this lifetime.
+    const size_t external_output_size;  ///< how many elements can be written in external_output
 
     unsigned int output_size() const {
-        return (unsigned int)external_output.size();
+        return (unsigned int)external_output_size;
     }
     void setAValue(size_t idx, const T& value) {
         external_output[idx] = value;  // no bounds checking
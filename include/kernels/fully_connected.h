@@ -24,6 +24,22 @@ namespace VPUNN {
 VPUNN_API void Dense(const VPUNN::Tensor<float>* weights, const VPUNN::Tensor<float>* activations,
                      VPUNN::Tensor<float>* output);
 
+/**
+ * @brief Floating point FC layer (float) for one sparse input, like a one-hot encoded NN descriptor
+ *
+ * The non zero activations are gathered once, then each output is the dot product of its weight row with them only.
+ * Used only for batch 1 and if at most an eighth of the activations (and at most 32) are non zero, measured on the
+ * input: otherwise nothing is computed and false is returned, Dense() (sgemm) is the faster choice then.
+ * The sum order is not the one of the sgemm kernels, the results match Dense() up to float rounding.
+ *
+ * @param weights a VPUNN::Tensor containing the FC layer weights, same layout as for Dense()
+ * @param activations the input tensor
+ * @param output the output tensor
+ * @returns true if the output was computed
+ */
+VPUNN_API bool DenseSparseInput(const VPUNN::Tensor<float>* weights, const VPUNN::Tensor<float>* activations,
+                                VPUNN::Tensor<float>* output);
+
 }  // namespace VPUNN
 
 #endif  // KERNELS_FC_H
@@ -164,6 +164,8 @@ public:
     using Inserter<T>::insert;  ///< exposes the non virtual insert methods
     Inserter_Interface13(std::vector<T>& output): Inserter<T>(output) {
     }
+    Inserter_Interface13(T* output, size_t size): Inserter<T>(output, size) {
+    }
 
     /// @brief insert specialization for VPUTensor
     template <bool only_simulate>
@@ -199,12 +201,13 @@ protected:
      * @param debug_offset [out] is the offset where a new value can be written. interpreted as how many positions were
      * written
      * @tparam only_simulate, if true then no data is actually written, only the offset is computed
-     * @return std::vector<T>& a DPUWorkload descriptor
+     * @param destination_descriptor where the descriptor is written, must be zero filled
+     * @param destination_size how many elements can be written in destination_descriptor
      */
     template <bool only_simulate>
-    void transformOnly(const DPUWorkload& workload, size_t& debug_offset,
-                       std::vector<T>& destination_descriptor) const {
-        Inserter_Interface13<T, DeviceAdapter> ins(destination_descriptor);
+    void transformOnly(const DPUWorkload& workload, size_t& debug_offset, T* destination_descriptor,
+                       size_t destination_size) const {
+        Inserter_Interface13<T, DeviceAdapter> ins(destination_descriptor, destination_size);
 
         // Build the vector from the inputs
         size_t offset = 0;
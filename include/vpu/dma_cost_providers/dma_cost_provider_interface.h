@@ -9,6 +9,8 @@
 #ifndef DMA_COST_PROVIDER_INTERFACE_H
 #define DMA_COST_PROVIDER_INTERFACE_H
 
+#include <string>
+
 #include "vpu/dma_types.h"
 
 namespace VPUNN {
@@ -42,6 +44,15 @@ public:
     virtual bool is_initialized() const {
         return false;
     }
+
+    /**
+     * @brief the nickname of the model behind the provider, overridden like is_initialized only by the providers that
+     * have a model
+     * @return the nickname, empty if there is no model
+     */
+    virtual std::string get_model_nickname() const noexcept {
+        return {};
+    }
 };
 }
 
@@ -52,6 +52,12 @@ public:
     bool is_initialized() const override {
         return provider_wrapper_->is_initialized();
     }
+
+    /// @brief forwards the model nickname of the underlying provider, like is_initialized
+    /// @return the nickname, empty if the underlying provider has no model
+    std::string get_model_nickname() const noexcept override {
+        return provider_wrapper_->get_model_nickname();
+    }
     
 private:
     /// @brief Type-erased interface for storing any provider wrapper
@@ -69,6 +75,10 @@ private:
         /// @brief Check if the wrapped provider is initialized
         /// @return true if the wrapped provider is initialized, false otherwise
         virtual bool is_initialized() const = 0;
+
+        /// @brief the model nickname of the wrapped provider
+        /// @return the nickname, empty if the wrapped provider has no model
+        virtual std::string get_model_nickname() const noexcept = 0;
     };
     
     /// @brief Concrete wrapper that knows both WlT and TargetWlT types
@@ -99,6 +109,10 @@ private:
         bool is_initialized() const override {
             return provider->is_initialized();
         }
+
+        std::string get_model_nickname() const noexcept override {
+            return provider->get_model_nickname();
+        }
     };
     
     std::unique_ptr<IProviderWrapper> provider_wrapper_;
@@ -18,6 +18,7 @@
 #include "vpu/cycles_interface_types.h"
 #include "dma_cost_provider_interface.h"
 #include "core/cache.h"
+#include "core/execution_context_pool.h"
 
 #include <thread>
 #include <unordered_map>
@@ -33,7 +34,8 @@ class DMANNCostProvider : public IDMACostProvider<WlT> {
 public:
     DMANNCostProvider(const std::string& filename = "",
                    const unsigned int batch_size = 1, bool profile = false, const unsigned int cache_size = 16384,
-                   const std::string& dma_cache_filename = "", bool tryToLoadPairedCache = false)
+                   const std::string& dma_cache_filename = "", bool tryToLoadPairedCache = false,
+                   const unsigned int cache_shards = DEFAULT_CACHE_SHARDS)
             : vpunn_runtime(filename, profile),
               preprocessing_factory{},
               postprocessing_factory{},
@@ -41,7 +43,7 @@ public:
               results_config(vpunn_runtime.model_version_info().get_output_interface_version()),
               post_processing(init_postproc(postprocessing_factory, vpunn_runtime.model_version_info(), filename)),
               cache(cache_size /*, preprocessing.output_size()*/, dma_cache_filename,
-                    (tryToLoadPairedCache ? filename : "")),
+                    (tryToLoadPairedCache ? filename : ""), cache_shards),
               cache_miss_serializer(get_env_vars({"ENABLE_VPUNN_CACHE_MISS_DATA_SERIALIZATION"})
                                             .at("ENABLE_VPUNN_CACHE_MISS_DATA_SERIALIZATION") == "TRUE"),
               batch_size(batch_size) {
@@ -58,14 +60,14 @@ public:
     DMANNCostProvider(const char* model_data, size_t model_data_length, const unsigned int batch_size,
                    bool copy_model_data, bool profile = false,
                    const unsigned int cache_size = 16384, const char* dma_cache_data = nullptr,
-                   size_t dma_cache_data_length = 0)
+                   size_t dma_cache_data_length = 0, const unsigned int cache_shards = DEFAULT_CACHE_SHARDS)
             : vpunn_runtime(model_data, model_data_length, copy_model_data, profile),
               preprocessing_factory{},
               postprocessing_factory{},
               preprocessing(init_preproc(preprocessing_factory, vpunn_runtime.model_version_info(), "")),
               results_config(vpunn_runtime.model_version_info().get_output_interface_version()),
               post_processing(init_postproc(postprocessing_factory, vpunn_runtime.model_version_info(), "")),
-              cache(cache_size, /* preprocessing.output_size(),*/ dma_cache_data, dma_cache_data_length),
+              cache(cache_size, /* preprocessing.output_size(),*/ dma_cache_data, dma_cache_data_length, cache_shards),
               cache_miss_serializer(get_env_vars({"ENABLE_VPUNN_CACHE_MISS_DATA_SERIALIZATION"})
                                             .at("ENABLE_VPUNN_CACHE_MISS_DATA_SERIALIZATION") == "TRUE"),
               batch_size(batch_size) {
@@ -94,10 +96,15 @@ public:
 
     /// @brief provides the nickname of the model, used for cache and serializer
     /// @returns the nickname of the model
-    std::string get_model_nickname() const noexcept {
+    std::string get_model_nickname() const noexcept override {
         return model_nickname;
     }
 
+    /// @brief limits how many execution contexts of exited threads are kept for reuse by new threads
+    void set_max_idle_execution_contexts(size_t max_idle) {
+        context_pool.set_max_idle(max_idle);
+    }
+
 protected:
     float infer_raw_input(const WlT& workload) const {
         auto& ctx = get_execution_context();
@@ -232,32 +239,9 @@ public:
     /// provides the context or creates a new one in case it does not exist yet
     /// the context containers are (must be ) mutable
     NNExecutionContext& get_execution_context() const {
-        const auto thread_id = std::this_thread::get_id();
-
-        // First, try to find the context with a shared (read) lock
-        {
-            std::shared_lock<std::shared_mutex> read_lock(context_map_mutex);
-            auto it = context_map.find(thread_id);
-            if (it != context_map.end()) {
-                return *(it->second);
-            }
-        }
-
-        // If not found, acquire an exclusive (write) lock to insert
-        {
-            std::unique_lock<std::shared_mutex> write_lock(context_map_mutex);
-            // Double-check in case another thread inserted in the meantime
-            auto it = context_map.find(thread_id);
-            if (it == context_map.end()) {
-                it = context_map
-                             .emplace(thread_id,  // key
-                                      std::make_shared<NNExecutionContext>(
-                                              vpunn_runtime.createNewInferenceExecutionData(batch_size))  // context
-                                      )
-                             .first;
-            }
-            return *(it->second);
-        }
+        return context_pool.get([this]() {
+            return std::make_unique<NNExecutionContext>(vpunn_runtime.createNewInferenceExecutionData(batch_size));
+        });
     }
 
 public:
@@ -353,9 +337,7 @@ private:
     const std::string model_nickname{make_model_nickname()};  ///< nickname for the model, used for cache and serializer
     const float default_NN_output{-1.0F};     ///< this is the value used in no NN output is present (like not loaded).
     const unsigned int batch_size{1};         ///< the batch size used for the inference, set at ctor, used for context
-    // Map of (thread ID, instance ID) to execution contexts
-    mutable std::map<std::thread::id, std::shared_ptr<NNExecutionContext>> context_map;
-    mutable std::shared_mutex context_map_mutex;  ///< Mutex to protect the context map
+    ExecutionContextPool<NNExecutionContext> context_pool;  ///< execution context of each thread, reused after exit
 private:
     /// @brief obtains the actual preprocessing instance from factory. The factory must live longer than the instance
     /// created. warning: Throws if not possible
@@ -79,6 +79,19 @@ public:
         }
         return false;
     }
+
+    /**
+     * @brief the model nickname of the first initialized provider, the one that answers when it can
+     * @return the nickname, empty if no provider has an initialized model
+     */
+    std::string get_nn_model_nickname() const {
+        for(const auto& prov_ref : cost_providers) {
+            if (prov_ref && prov_ref->is_initialized()) {
+                return prov_ref->get_model_nickname();
+            }
+        }
+        return {};
+    }
 };
     
 }
@@ -302,6 +302,15 @@ struct DMANNWorkload_NPU27 {
     /// @brief Compute FNV-1a hash for cache lookups
     /// @return 32-bit hash value for this workload
     uint32_t hash() const;
+
+    /// @brief 64b variant of hash(), same fields. Key of the v2 caches, where hash() is the fingerprint
+    /// @return 64-bit hash value for this workload
+    uint64_t hash64() const;
+
+private:
+    /// the FNV-1a hash of the fields, of type H (uint32_t or uint64_t)
+    template <typename H>
+    H hash_fields() const;
 };
 
 /// placeholder/reserved name
@@ -490,6 +499,15 @@ struct DMANNWorkload_NPU40_50 {
     /// @brief Compute FNV-1a hash for cache lookups
     /// @return 32-bit hash value for this workload
     uint32_t hash() const;
+
+    /// @brief 64b variant of hash(), same fields. Key of the v2 caches, where hash() is the fingerprint
+    /// @return 64-bit hash value for this workload
+    uint64_t hash64() const;
+
+private:
+    /// the FNV-1a hash of the fields, of type H (uint32_t or uint64_t)
+    template <typename H>
+    H hash_fields() const;
 };
 
 // Custom hasher for DMAWorkload_NPU27 using the hash() method
@@ -382,6 +382,14 @@ public:
     /// compute hash for cache key usage, directly from DPUWorkload fields
     /// Uses the same fnv1a_hash function as NNDescriptor, but without preprocessing
     uint32_t hash() const;
+
+    /// 64b variant of hash(), same fields. Key of the v2 caches, where hash() is the fingerprint
+    uint64_t hash64() const;
+
+private:
+    /// the FNV-1a hash of the fields, of type H (uint32_t or uint64_t)
+    template <typename H>
+    H hash_fields() const;
 };
 
 // Custom hasher for DPUWorkload using the hash() method
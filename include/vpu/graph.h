@@ -10,12 +10,18 @@
 #ifndef VPUNN_GRAPH_H
 #define VPUNN_GRAPH_H
 
+#include <atomic>
 #include <cstddef>
+#include <cstdlib>
+#include <functional>
 #include <iterator>
+#include <list>
 #include <memory>
+#include <queue>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 #include "vpu_layer_cost_model.h"
-#include <random>
 
 namespace VPUNN {
 
@@ -29,6 +35,12 @@ private:
     std::shared_ptr<SHAVEWorkload> shv;
     int _hash;
 
+    /// unique per node in the process (a random device per node was a system call for every node)
+    static int next_hash() {
+        static std::atomic<int> counter{0};
+        return counter.fetch_add(1, std::memory_order_relaxed) & RAND_MAX;
+    }
+
 public:
     /**
      * @brief Node operation type enum
@@ -47,13 +59,8 @@ public:
      *
      * @param dpu_op a DPU layer
      */
-    VPUComputeNode(const std::shared_ptr<DPULayer>& dpu_op): dpu(dpu_op) {
-        std::random_device rd; //create a random device to obtain a seed for the random number generator
-        std::mt19937 gen(rd()); //initialize the random number generator with the random seed
-        std::uniform_int_distribution<int> distrib(0, RAND_MAX); //uniform distribution, range{0, RAND_MAX}
-
+    VPUComputeNode(const std::shared_ptr<DPULayer>& dpu_op): dpu(dpu_op), _hash(next_hash()) {
         type = VPUComputeNode::OpType::DPU_COMPUTE_NODE;
-        _hash = distrib(gen);  // old code: std::rand();
     }
 
     /**
@@ -61,13 +68,8 @@ public:
      *
      * @param shv_op a SHV layer
      */
-    VPUComputeNode(const std::shared_ptr<SHAVEWorkload>& shv_op): shv(shv_op) {
-        std::random_device rd;   // create a random device to obtain a seed for the random number generator
-        std::mt19937 gen(rd());  // initialize the random number generator with the random seed
-        std::uniform_int_distribution<int> distrib(0, RAND_MAX);  // uniform distribution, range{0, RAND_MAX}
-
+    VPUComputeNode(const std::shared_ptr<SHAVEWorkload>& shv_op): shv(shv_op), _hash(next_hash()) {
         type = VPUComputeNode::OpType::SHV_COMPUTE_NODE;
-        _hash = distrib(gen);  // old code: std::rand();
     }
 
     /**
@@ -148,13 +150,117 @@ public:
 /**
  * @brief Represent the Computation DAG in a VPU device
  *
+ * Every node gets a stable id (NodeId), its insertion index. The adjacency is kept in compressed (CSR) form, indexed by
+ * node id, and the topological order is computed once and cached. Both are rebuilt lazily, on the first query after a
+ * change of the graph, so building a graph is O(N+E) and a traversal is O(N) over the cached order.
+ * The queries are not synchronized: a graph that is read from several threads must be built and indexed (for example
+ * by calling topological_order()) before.
  */
 class VPUComputationDAG {
+public:
+    /// stable identifier of a node in this DAG: the index in the order of insertion
+    using NodeId = std::size_t;
+
+    /// a contiguous range of node ids (successors or predecessors of a node, topological order)
+    class NodeIdRange {
+    public:
+        NodeIdRange(const NodeId* first, const NodeId* last): first_(first), last_(last) {
+        }
+        const NodeId* begin() const {
+            return first_;
+        }
+        const NodeId* end() const {
+            return last_;
+        }
+        std::size_t size() const {
+            return static_cast<std::size_t>(last_ - first_);
+        }
+        bool empty() const {
+            return first_ == last_;
+        }
+
+    private:
+        const NodeId* first_;
+        const NodeId* last_;
+    };
+
 private:
-    std::list<std::shared_ptr<VPUComputeNode>> layers;
-    VPUComputeNodeMap<std::vector<std::shared_ptr<VPUComputeNode>>> successors;
-    VPUComputeNodeMap<std::vector<std::shared_ptr<VPUComputeNode>>> predecessors;
-    std::list<std::shared_ptr<VPUComputeNode>> sources_lst;
+    std::vector<std::shared_ptr<VPUComputeNode>> layers;                 ///< the nodes, indexed by NodeId
+    std::unordered_map<const VPUComputeNode*, NodeId> ids;              ///< node to its id
+    std::vector<std::pair<NodeId, NodeId>> edge_list;                   ///< (source, sink), in order of insertion
+    std::vector<unsigned int> in_degree;                                ///< number of predecessors, by NodeId
+
+    /// compressed adjacency and topological order, derived from the above. Rebuilt on demand if not valid
+    struct Index {
+        bool valid{false};
+        std::vector<NodeId> successors_offsets;    ///< successors of n are in [offsets[n], offsets[n+1])
+        std::vector<NodeId> successors_ids;        ///< in the order the edges were added
+        std::vector<NodeId> predecessors_offsets;  ///< predecessors of n are in [offsets[n], offsets[n+1])
+        std::vector<NodeId> predecessors_ids;      ///< in the order the edges were added
+        std::vector<NodeId> topological_order;     ///< nodes on a cycle (and after them) are missing
+    };
+    mutable Index index;
+
+    /// groups the edges by source and by sink, then orders the nodes. O(N+E) plus the ordering
+    void build_index() const {
+        const std::size_t n{layers.size()};
+        const auto to_csr = [n, this](std::vector<NodeId>& offsets, std::vector<NodeId>& targets, bool by_source) {
+            offsets.assign(n + 1, 0);
+            for (const auto& e : edge_list) {
+                ++offsets[(by_source ? e.first : e.second) + 1];
+            }
+            for (std::size_t i = 0; i < n; ++i) {
+                offsets[i + 1] += offsets[i];
+            }
+            targets.resize(edge_list.size());
+            std::vector<NodeId> next(offsets.cbegin(), offsets.cend() - 1);
+            for (const auto& e : edge_list) {
+                const NodeId key{by_source ? e.first : e.second};
+                targets[next[key]++] = by_source ? e.second : e.first;
+            }
+        };
+        to_csr(index.successors_offsets, index.successors_ids, true);
+        to_csr(index.predecessors_offsets, index.predecessors_ids, false);
+
+        // Kahn's algorithm, always taking the smallest ready id: the same order the node by node rescan produced
+        index.topological_order.clear();
+        index.topological_order.reserve(n);
+        std::vector<unsigned int> remaining{in_degree};
+        std::priority_queue<NodeId, std::vector<NodeId>, std::greater<NodeId>> ready;
+        for (NodeId i = 0; i < n; ++i) {
+            if (remaining[i] == 0) {
+                ready.push(i);
+            }
+        }
+        while (!ready.empty()) {
+            const NodeId current{ready.top()};
+            ready.pop();
+            index.topological_order.push_back(current);
+            for (auto k = index.successors_offsets[current]; k < index.successors_offsets[current + 1]; ++k) {
+                const NodeId sink{index.successors_ids[k]};
+                if (--remaining[sink] == 0) {
+                    ready.push(sink);
+                }
+            }
+        }
+        index.valid = true;
+    }
+
+    const Index& get_index() const {
+        if (!index.valid) {
+            build_index();
+        }
+        return index;
+    }
+
+    std::vector<std::shared_ptr<VPUComputeNode>> to_nodes(NodeIdRange range) const {
+        std::vector<std::shared_ptr<VPUComputeNode>> nodes;
+        nodes.reserve(range.size());
+        for (const auto id : range) {
+            nodes.push_back(layers[id]);
+        }
+        return nodes;
+    }
 
 public:
     /**
@@ -170,10 +276,10 @@ public:
      * @return VPUComputationDAG&
      */
     VPUComputationDAG& addNode(const std::shared_ptr<VPUComputeNode> layer) {
+        ids.emplace(layer.get(), layers.size());
         layers.push_back(layer);
-        successors[layer] = {};
-        predecessors[layer] = {};
-        sources_lst.push_back(layer);
+        in_degree.push_back(0);
+        index.valid = false;
         return *this;
     }
 
@@ -185,7 +291,7 @@ public:
      * @return false
      */
     bool has(const std::shared_ptr<VPUComputeNode> layer) const {
-        return std::find(layers.begin(), layers.end(), layer) != layers.end();
+        return ids.find(layer.get()) != ids.cend();
     }
 
     /**
@@ -206,12 +312,10 @@ public:
             addNode(sink);
         }
 
-        // Remove the sink from the list of DAG sources
-        sources_lst.remove(sink);
-
-        // Add the nodes to the appropriate adjacency list
-        predecessors[sink].push_back(source);
-        successors[source].push_back(std::move(sink));
+        const NodeId sink_id{node_id(sink)};
+        edge_list.emplace_back(node_id(source), sink_id);
+        ++in_degree[sink_id];
+        index.valid = false;
         return *this;
     }
 
@@ -229,12 +333,8 @@ public:
      *
      * @return size_t
      */
-    size_t edges() {
-        size_t edges = 0;
-        for (const auto& node : layers) {
-            edges += successors[node].size();
-        }
-        return edges;
+    size_t edges() const {
+        return edge_list.size();
     }
 
     /**
@@ -242,7 +342,13 @@ public:
      *
      * @return std::list<std::shared_ptr<VPUComputeNode>>
      */
-    std::list<std::shared_ptr<VPUComputeNode>> sources() {
+    std::list<std::shared_ptr<VPUComputeNode>> sources() const {
+        std::list<std::shared_ptr<VPUComputeNode>> sources_lst;
+        for (NodeId i = 0; i < layers.size(); ++i) {
+            if (in_degree[i] == 0) {
+                sources_lst.push_back(layers[i]);
+            }
+        }
         return sources_lst;
     }
 
@@ -251,8 +357,8 @@ public:
      *
      * @return std::list<VPUComputeNode>
      */
-    std::list<std::shared_ptr<VPUComputeNode>> get_layers() {
-        return layers;
+    std::list<std::shared_ptr<VPUComputeNode>> get_layers() const {
+        return {layers.cbegin(), layers.cend()};
     }
 
     /**
@@ -261,8 +367,8 @@ public:
      * @param layer a pointer to a VPUComputeNode
      * @return std::vector<std::shared_ptr<VPUComputeNode>>
      */
-    std::vector<std::shared_ptr<VPUComputeNode>> get_successors(const std::shared_ptr<VPUComputeNode> layer) {
-        return successors[layer];
+    std::vector<std::shared_ptr<VPUComputeNode>> get_successors(const std::shared_ptr<VPUComputeNode> layer) const {
+        return has(layer) ? to_nodes(successors(node_id(layer))) : std::vector<std::shared_ptr<VPUComputeNode>>{};
     }
 
     /**
@@ -271,12 +377,54 @@ public:
      * @param layer layer a pointer to a VPUComputeNode
      * @return std::vector<std::shared_ptr<VPUComputeNode>>
      */
-    std::vector<std::shared_ptr<VPUComputeNode>> get_predecessors(const std::shared_ptr<VPUComputeNode> layer) {
-        return predecessors[layer];
+    std::vector<std::shared_ptr<VPUComputeNode>> get_predecessors(const std::shared_ptr<VPUComputeNode> layer) const {
+        return has(layer) ? to_nodes(predecessors(node_id(layer))) : std::vector<std::shared_ptr<VPUComputeNode>>{};
     }
 
     /**
-     * @brief A DAG iterator
+     * @brief the id of a node of this DAG
+     *
+     * @param layer a node of the DAG
+     * @throws std::out_of_range if the node is not in the DAG
+     * @return NodeId its insertion index
+     */
+    NodeId node_id(const std::shared_ptr<VPUComputeNode>& layer) const {
+        return ids.at(layer.get());
+    }
+
+    /// @returns the node with the given id, id must be smaller than nodes()
+    const std::shared_ptr<VPUComputeNode>& node(NodeId id) const {
+        return layers[id];
+    }
+
+    /// @returns the ids of the successors of a node, id must be smaller than nodes()
+    NodeIdRange successors(NodeId id) const {
+        const Index& idx{get_index()};
+        const NodeId* data{idx.successors_ids.data()};
+        return {data + idx.successors_offsets[id], data + idx.successors_offsets[id + 1]};
+    }
+
+    /// @returns the ids of the predecessors of a node, id must be smaller than nodes()
+    NodeIdRange predecessors(NodeId id) const {
+        const Index& idx{get_index()};
+        const NodeId* data{idx.predecessors_ids.data()};
+        return {data + idx.predecessors_offsets[id], data + idx.predecessors_offsets[id + 1]};
+    }
+
+    /**
+     * @brief the node ids in topological order, the order of the DAG Iterator
+     *
+     * Among the nodes ready at a step the smallest id comes first. Computed once per change of the graph.
+     * If the graph has a cycle the order stops before the nodes that depend on it.
+     */
+    NodeIdRange topological_order() const {
+        const Index& idx{get_index()};
+        const NodeId* data{idx.topological_order.data()};
+        return {data, data + idx.topological_order.size()};
+    }
+
+    /**
+     * @brief A DAG iterator, walks the nodes in the cached topological order
      *
      */
     struct Iterator {
@@ -297,13 +445,8 @@ public:
          * @param dag
          * @param all_visited
          */
-        Iterator(VPUComputationDAG& dag, bool all_visited = false): dag(dag) {
-            // The first node
-            current_node_ptr = all_visited ? nullptr : dag.sources_lst.front();
-            for (auto& layer : dag.layers) {
-                dependendcies[layer] = all_visited ? 0u : static_cast<unsigned int>(dag.predecessors[layer].size());
-                visited[layer] = all_visited;
-            }
+        Iterator(const VPUComputationDAG& dag, bool all_visited = false): dag(dag), order(dag.topological_order()) {
+            position = all_visited ? order.end() : order.begin();
         }
 
         /**
@@ -312,7 +455,7 @@ public:
          * @return std::shared_ptr<VPUComputeNode>
          */
         std::shared_ptr<VPUComputeNode> operator*() const {
-            return current_node_ptr;
+            return current();
         }
 
         /**
@@ -321,7 +464,7 @@ public:
          * @return std::shared_ptr<VPUComputeNode>
          */
         std::shared_ptr<VPUComputeNode> operator->() {
-            return current_node_ptr;
+            return current();
         }
 
         /**
@@ -330,23 +473,9 @@ public:
          * @return Iterator&
          */
         Iterator& operator++() {
-            if (!current_node_ptr) {
-                return *this;
+            if (position != order.end()) {
+                ++position;
             }
-            // Node visited
-            visited[current_node_ptr] = true;
-            for (const auto& sinks : dag.successors[current_node_ptr]) {
-                // Decrement the dependencies of the successors nodes
-                dependendcies[sinks] -= 1;
-            }
-            for (const auto& layer : dag.layers) {
-                if (dependendcies[layer] == 0 && !visited[layer]) {
-                    current_node_ptr = layer;
-                    return *this;
-                }
-            }
-            // If no successor if find, set, the current node ptr to nullptr
-            current_node_ptr = nullptr;
             return *this;
         }
 
@@ -370,7 +499,7 @@ public:
          * @return false
          */
         friend bool operator==(const Iterator& a, const Iterator& b) {
-            return a.current_node_ptr == b.current_node_ptr;
+            return a.position == b.position;
         };
 
         /**
@@ -382,14 +511,17 @@ public:
          * @return false
          */
         friend bool operator!=(const Iterator& a, const Iterator& b) {
-            return a.current_node_ptr != b.current_node_ptr;
+            return !(a == b);
         };
 
     private:
-        std::shared_ptr<VPUComputeNode> current_node_ptr;
-        VPUComputationDAG& dag;
-        VPUComputeNodeMap<unsigned int> dependendcies;
-        VPUComputeNodeMap<bool> visited;
+        const VPUComputationDAG& dag;
+        NodeIdRange order;
+        const NodeId* position;
+
+        std::shared_ptr<VPUComputeNode> current() const {
+            return (position != order.end()) ? dag.node(*position) : nullptr;
+        }
     };
 
     /**
@@ -397,7 +529,7 @@ public:
      *
      * @return Iterator
      */
-    Iterator begin() {
+    Iterator begin() const {
         return Iterator(*this, false);
     }
 
@@ -406,7 +538,7 @@ public:
      *
      * @return Iterator
      */
-    Iterator end() {
+    Iterator end() const {
         return Iterator(*this, true);
     }
 };
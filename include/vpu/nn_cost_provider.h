@@ -11,6 +11,7 @@
 #define NN_COST_PROVIDER_H_
 
 #include "core/cache.h"
+#include "core/execution_context_pool.h"
 #include "inference/post_process.h"
 #include "inference/postprocessing_factory.h"
 #include "inference/preprocessing.h"
@@ -18,6 +19,11 @@
 #include "inference/vpunn_runtime.h"
 #include "vpu/cycles_interface_types.h"
 
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
 #include <thread>
 #include <unordered_map>
 
@@ -32,7 +38,7 @@ class NNCostProvider {
 public:
     NNCostProvider(const std::string& filename = "", const unsigned int batch_size = 1, bool profile = false,
                    const unsigned int cache_size = 16384, const std::string& dpu_cache_filename = "",
-                   bool tryToLoadPairedCache = false)
+                   bool tryToLoadPairedCache = false, const unsigned int cache_shards = DEFAULT_CACHE_SHARDS)
             : vpunn_runtime(filename, profile),
               preprocessing_factory{},
               postprocessing_factory{},
@@ -40,9 +46,9 @@ public:
               results_config(vpunn_runtime.model_version_info().get_output_interface_version()),
               post_processing(init_postproc(postprocessing_factory, vpunn_runtime.model_version_info(), filename)),
               cache(cache_size /*, preprocessing.output_size()*/, dpu_cache_filename,
-                    (tryToLoadPairedCache ? filename : "")),
-              new_cache(cache_size, dpu_cache_filename,
-                        (tryToLoadPairedCache ? filename : "")),  // New cache for newer devices
+                    (tryToLoadPairedCache ? filename : ""), cache_shards),
+              new_cache(cache_size, dpu_cache_filename, (tryToLoadPairedCache ? filename : ""),
+                        cache_shards),  // New cache for newer devices
               cache_miss_serializer(get_env_vars({"ENABLE_VPUNN_CACHE_MISS_DATA_SERIALIZATION"})
                                             .at("ENABLE_VPUNN_CACHE_MISS_DATA_SERIALIZATION") == "TRUE"),
               batch_size(batch_size) {
@@ -53,20 +59,22 @@ public:
         check_post_config(vpunn_runtime.model_version_info());
         correlate_preprocessor_with_model_inputs();
         cache_miss_serializer.initialize(cache_miss_file_naming(), FileMode::READ_WRITE, get_names_for_serializer());
+        load_warm_caches();
     };
 
     NNCostProvider(const char* model_data, size_t model_data_length, const unsigned int batch_size,
                    bool copy_model_data, bool profile = false, const unsigned int cache_size = 16384,
-                   const char* dpu_cache_data = nullptr, size_t dpu_cache_data_length = 0)
+                   const char* dpu_cache_data = nullptr, size_t dpu_cache_data_length = 0,
+                   const unsigned int cache_shards = DEFAULT_CACHE_SHARDS)
             : vpunn_runtime(model_data, model_data_length, copy_model_data, profile),
               preprocessing_factory{},
               postprocessing_factory{},
               preprocessing(init_preproc(preprocessing_factory, vpunn_runtime.model_version_info(), "")),
               results_config(vpunn_runtime.model_version_info().get_output_interface_version()),
               post_processing(init_postproc(postprocessing_factory, vpunn_runtime.model_version_info(), "")),
-              cache(cache_size, /* preprocessing.output_size(),*/ dpu_cache_data, dpu_cache_data_length),
-              new_cache(cache_size, dpu_cache_data,
-                        dpu_cache_data_length),  // New cache for newer devices
+              cache(cache_size, /* preprocessing.output_size(),*/ dpu_cache_data, dpu_cache_data_length, cache_shards),
+              new_cache(cache_size, dpu_cache_data, dpu_cache_data_length,
+                        cache_shards),  // New cache for newer devices
               cache_miss_serializer(get_env_vars({"ENABLE_VPUNN_CACHE_MISS_DATA_SERIALIZATION"})
                                             .at("ENABLE_VPUNN_CACHE_MISS_DATA_SERIALIZATION") == "TRUE"),
               batch_size(batch_size) {
@@ -77,12 +85,36 @@ public:
         check_post_config(vpunn_runtime.model_version_info());
         correlate_preprocessor_with_model_inputs();
         cache_miss_serializer.initialize(cache_miss_file_naming(), FileMode::READ_WRITE, get_names_for_serializer());
+        load_warm_caches();
     };
 
     const std::string cache_miss_file_naming() const {
         return "cache_misses";
     }
 
+    /**
+     * @brief saves the dynamic caches in files, their content is merged in the preloaded caches by the next
+     * NNCostProvider of the same model. Enabled by VPUNN_WARM_CACHE_DIR, @sa warm_cache_filename.
+     * Never done implicitly: to be called by the user at the end of a run, or periodically to survive an abnormal end.
+     *
+     * @returns false if enabled and a snapshot could not be written
+     */
+    bool save_warm_caches() const {
+        if (!is_initialized()) {
+            return true;
+        }
+        bool saved{true};
+        const auto descriptors_file{warm_cache_filename(model_nickname, warm_cache_descriptors_name)};
+        if (!descriptors_file.empty()) {
+            saved = cache.save_snapshot(descriptors_file, model_nickname, descriptors_version()) && saved;
+        }
+        const auto workloads_file{warm_cache_filename(model_nickname, warm_cache_workloads_name)};
+        if (!workloads_file.empty()) {
+            saved = new_cache.save_snapshot(workloads_file, model_nickname) && saved;
+        }
+        return saved;
+    }
+
     bool is_initialized() const {
         return vpunn_runtime.initialized();
     }
@@ -103,6 +135,16 @@ public:
         return model_nickname;
     }
 
+    /// @returns the batch size of the inference, set at construction
+    unsigned int get_batch_size() const noexcept {
+        return batch_size;
+    }
+
+    /// @brief limits how many execution contexts of exited threads are kept for reuse by new threads
+    void set_max_idle_execution_contexts(size_t max_idle) {
+        context_pool.set_max_idle(max_idle);
+    }
+
 protected:
     // Helper to determine if workload should use new hash method (newer devices)
     template <typename WlT>
@@ -123,47 +165,61 @@ protected:
             return default_NN_output;
         }
 
-        // Helper lambdas for cache access and update
-        auto compute_and_cache = [&](auto& cache_ref, auto&& key, const std::vector<float>& descriptor) -> float {
-            const auto infered_value = vpunn_runtime.predict<float>(descriptor, ctx.runtime_buffer_data)[0];
-            cache_ref.add(key, infered_value);
-
-            L1CostSerializationWrap serialization_handler(cache_miss_serializer);
-            serialization_handler.serializeInfoAndComputeWorkloadUid(workload, true /*serializer close line*/);
-
-            return infered_value;
-        };
+        // the descriptor is written in place in the context memory, no allocation
+        std::vector<float>& descriptor{ctx.descriptor};
+        descriptor.resize(preprocessing.output_size());
 
         if (use_new_hash_method(workload)) {
             const auto cached_value = new_cache.get(workload);
             if (cached_value) {
                 return cached_value.value();
             }
-            const std::vector<float> descriptor{preprocessing.transformSingle(workload)};
-            return compute_and_cache(new_cache, workload, descriptor);
+            preprocessing.transformSingleInto(workload, descriptor.data());
+            return infer_and_cache(workload, descriptor.data(), new_cache, workload);
         } else {
             // Older devices or non-hashable: Use preprocessing-based caching
-            const std::vector<float> descriptor{preprocessing.transformSingle(workload)};
+            preprocessing.transformSingleInto(workload, descriptor.data());
             const auto cached_value = cache.get(descriptor);
             if (cached_value) {
                 return cached_value.value();
             }
 
-            return compute_and_cache(cache, descriptor, descriptor);
+            return infer_and_cache(workload, descriptor.data(), cache, descriptor);
         }
     }
 
-    template <typename WlT>
-    CyclesInterfaceType infer(const WlT& workload) const {
-        const float raw_value = infer_raw_input(workload);
+    /// @brief runs the NN on a prepared descriptor and adds the raw result to the cache, under the given key
+    /// @returns the NN raw value
+    template <typename WlT, typename CacheT, typename KeyT>
+    float infer_and_cache(const WlT& workload, const float* descriptor, CacheT& cache_ref, const KeyT& key) const {
+        auto& ctx = get_execution_context();
+        const auto infered_value = vpunn_runtime.predict(
+                descriptor, static_cast<unsigned int>(preprocessing.output_size()), ctx.runtime_buffer_data)[0];
+        cache_ref.add(key, infered_value);
+
+        L1CostSerializationWrap serialization_handler(cache_miss_serializer);
+        serialization_handler.serializeInfoAndComputeWorkloadUid(workload, true /*serializer close line*/);
+
+        return infered_value;
+    }
 
+    /// @returns the cycles corresponding to a NN raw value, or ERROR_INVALID_OUTPUT_RANGE
+    template <typename WlT>
+    CyclesInterfaceType to_cycles(const WlT& workload, const float raw_value) const {
         if (post_processing.is_NN_value_invalid(raw_value)) {
             return Cycles::ERROR_INVALID_OUTPUT_RANGE;
         }
         return static_cast<CyclesInterfaceType>(std::ceil(post_processing.process(workload, raw_value)));
     }
 
+    template <typename WlT>
+    CyclesInterfaceType infer(const WlT& workload) const {
+        return to_cycles(workload, infer_raw_input(workload));
+    }
+
     /// returns a reference that is owned by the executor context, normally thread bounded
+    /// The workloads found in cache are not inferred, the others are packed in full NN batches, inferred and added to
+    /// the cache (same as the single workload inference)
     template <typename WlT>
     const std::vector<float>& infer_raw_input(const std::vector<WlT>& workloads) const {
         auto& ctx = get_execution_context();
@@ -175,31 +231,97 @@ protected:
             return ctx.workloads_results_buffer;
         }
 
-        // Pre-process the workloads to generate descriptors
         // This is set up at ctor
         const auto model_batch_size{
                 (ctx.runtime_buffer_data
                          .input_shapes()[0])[0]};  // how many wlds in a batch, this was established at the
                                                    // beginning. and it is obtained from the execution buffer!
-        // transforms all at once, potential optimization is to do batch by batch
-        const std::vector<float> descriptor_for_all = preprocessing.transformBatch(workloads, model_batch_size);
+        const size_t descriptor_size{preprocessing.output_size()};
+        const auto inputs_to_process_in_batch{static_cast<unsigned int>(descriptor_size * model_batch_size)};
+
+        // split hits and misses: hits go directly to results. Misses are only remembered, except the ones using the
+        // descriptor as cache key, whose descriptors are kept packed in miss_descriptors
+        std::vector<size_t>& miss_positions{ctx.miss_positions};
+        std::vector<float>& miss_descriptors{ctx.miss_descriptors};
+        std::vector<float>& descriptor{ctx.descriptor};
+        miss_positions.clear();
+        miss_descriptors.clear();
+        descriptor.resize(descriptor_size);
+        for (size_t idx = 0; idx < workloads.size(); ++idx) {
+            const auto& wl{workloads[idx]};
+            std::optional<float> cached_value;
+            if (use_new_hash_method(wl)) {
+                cached_value = new_cache.get(wl);
+            } else {
+                preprocessing.transformSingleInto(wl, descriptor.data());
+                cached_value = cache.get(descriptor);
+                if (!cached_value) {
+                    miss_descriptors.insert(miss_descriptors.end(), descriptor.cbegin(), descriptor.cend());
+                }
+            }
 
-        const auto descriptor_size{preprocessing.output_size()};
-        const auto inputs_to_process_in_batch{descriptor_size * model_batch_size};
+            if (cached_value) {
+                ctx.workloads_results_buffer[idx] = cached_value.value();
+            } else {
+                miss_positions.push_back(idx);
+            }
+        }
 
-        for (unsigned int wl_idx = 0; wl_idx < workloads.size(); wl_idx += model_batch_size) {
-            // Slice the workload descriptors and predict on a single batch
-            // pointer inside of the passed runtime_buffer_data
-            const float* hw_overhead_arr = vpunn_runtime.predict(
-                    &(descriptor_for_all[static_cast<size_t>(wl_idx) * static_cast<size_t>(descriptor_size)]),
-                    inputs_to_process_in_batch, ctx.runtime_buffer_data);
+        const size_t misses_count{miss_positions.size()};
+        if ((misses_count > 0) && (ctx.runtime_buffer_data.input_size() != inputs_to_process_in_batch)) {
+            std::stringstream buffer;
+            buffer << "[ERROR]NNCostProvider::infer_raw_input(), the NN input has size: "
+                   << ctx.runtime_buffer_data.input_size()
+                   << ", this is inconsistent with the batch of descriptors: " << inputs_to_process_in_batch
+                   << " File: " << __FILE__ << " Line: " << __LINE__;
+            throw std::runtime_error(buffer.str());
+        }
 
-            const auto complete_batch_end_idx{wl_idx + model_batch_size};
-            auto end_idx{(complete_batch_end_idx > workloads.size()) ? workloads.size() : complete_batch_end_idx};
+        // infer only the misses, in full batches (last one padded with zeros). Descriptors are written directly in
+        // the NN input tensor
+        float* const nn_input{ctx.runtime_buffer_data.input_data()};
+        size_t packed_fill_idx{0};     // next packed descriptor to be put in the NN input
+        size_t packed_scatter_idx{0};  // next packed descriptor to be used as cache key
+        for (size_t batch_start = 0; batch_start < misses_count; batch_start += model_batch_size) {
+            const size_t batch_end{std::min(batch_start + model_batch_size, misses_count)};
+            for (size_t miss_idx = batch_start; miss_idx < batch_end; ++miss_idx) {
+                const auto& wl{workloads[miss_positions[miss_idx]]};
+                float* const row{nn_input + (miss_idx - batch_start) * descriptor_size};
+                if (use_new_hash_method(wl)) {
+                    preprocessing.transformSingleInto(wl, row);
+                } else {
+                    const auto packed_begin{miss_descriptors.cbegin() +
+                                            static_cast<std::ptrdiff_t>(packed_fill_idx * descriptor_size)};
+                    std::copy_n(packed_begin, descriptor_size, row);
+                    ++packed_fill_idx;
+                }
+            }
+            std::fill(nn_input + (batch_end - batch_start) * descriptor_size, nn_input + inputs_to_process_in_batch,
+                      0.0f);
 
-            // fill into result the data for this batch
-            for (unsigned int idx = wl_idx; idx < end_idx; ++idx) {
-                ctx.workloads_results_buffer[idx] = hw_overhead_arr[idx - wl_idx];
+            vpunn_runtime.predict(ctx.runtime_buffer_data);
+            // pointer inside of the passed runtime_buffer_data
+            const float* hw_overhead_arr = ctx.runtime_buffer_data.get_outputs<float>();
+
+            // scatter the results of this batch and remember them
+            for (size_t miss_idx = batch_start; miss_idx < batch_end; ++miss_idx) {
+                const auto& wl{workloads[miss_positions[miss_idx]]};
+                const float infered_value{hw_overhead_arr[miss_idx - batch_start]};
+                ctx.workloads_results_buffer[miss_positions[miss_idx]] = infered_value;
+
+                if (use_new_hash_method(wl)) {
+                    new_cache.add(wl, infered_value);
+                } else {
+                    const auto descriptor_begin{miss_descriptors.cbegin() +
+                                                static_cast<std::ptrdiff_t>(packed_scatter_idx * descriptor_size)};
+                    cache.add(std::vector<float>(descriptor_begin,
+                                                 descriptor_begin + static_cast<std::ptrdiff_t>(descriptor_size)),
+                              infered_value);
+                    ++packed_scatter_idx;
+                }
+
+                L1CostSerializationWrap serialization_handler(cache_miss_serializer);
+                serialization_handler.serializeInfoAndComputeWorkloadUid(wl, true /*serializer close line*/);
             }
         }
         //\todo: optimization (skip this if no processing required?)
@@ -220,13 +342,7 @@ protected:
         const std::vector<float>& NN_results{infer_raw_input(workloads)};  // reference inside of context
 
         for (unsigned int idx = 0; idx < workloads.size(); ++idx) {
-            const auto nn_output_cycles = NN_results[idx];
-            if (post_processing.is_NN_value_invalid(nn_output_cycles)) {
-                cycles_vector[idx] = Cycles::ERROR_INVALID_OUTPUT_RANGE;
-            } else {
-                cycles_vector[idx] = static_cast<CyclesInterfaceType>(
-                        std::ceil(post_processing.process(workloads[idx], nn_output_cycles)));
-            }
+            cycles_vector[idx] = to_cycles(workloads[idx], NN_results[idx]);
         }
         return cycles_vector;  // RVO
     }
@@ -234,32 +350,9 @@ protected:
     /// provides the context or creates a new one in case it does not exist yet
     /// the context containers are (must be ) mutable
     NNExecutionContext& get_execution_context() const {
-        const auto thread_id = std::this_thread::get_id();
-
-        // First, try to find the context with a shared (read) lock
-        {
-            std::shared_lock<std::shared_mutex> read_lock(context_map_mutex);
-            auto it = context_map.find(thread_id);
-            if (it != context_map.end()) {
-                return *(it->second);
-            }
-        }
-
-        // If not found, acquire an exclusive (write) lock to insert
-        {
-            std::unique_lock<std::shared_mutex> write_lock(context_map_mutex);
-            // Double-check in case another thread inserted in the meantime
-            auto it = context_map.find(thread_id);
-            if (it == context_map.end()) {
-                it = context_map
-                             .emplace(thread_id,  // key
-                                      std::make_shared<NNExecutionContext>(
-                                              vpunn_runtime.createNewInferenceExecutionData(batch_size))  // context
-                                      )
-                             .first;
-            }
-            return *(it->second);
-        }
+        return context_pool.get([this]() {
+            return std::make_unique<NNExecutionContext>(vpunn_runtime.createNewInferenceExecutionData(batch_size));
+        });
     }
 
 public:
@@ -279,49 +372,111 @@ public:
         return infer(workloads);  // Directly return the result of infer
     }
 
-    /// @brief Only used as a WA to share fixed cache outside of nn_cost_provider - will be removed in future.
-    CyclesInterfaceType get_cached(const DPUWorkload& workload, std::string* source = nullptr) const {
-        if (!is_initialized()) {
-            return Cycles::ERROR_CACHE_MISS;
+    /**
+     * @brief One DPU workload prepared for the caches, for a lookup-or-compute done in one pass.
+     *
+     * The cache key (for older devices this is the NN descriptor) is built once by probe_cache() and reused by the
+     * inference and by the cache insertion that follow a miss. Must not outlive the workload it was made for.
+     */
+    class CacheProbe {
+    public:
+        /// @returns true if the cache has a value for the workload, found at probing or added through this probe
+        bool has_cached_value() const {
+            return raw_value.has_value();
         }
 
-        std::optional<float> cached_value;
+    private:
+        friend class NNCostProvider;
+        explicit CacheProbe(const DPUWorkload& wl): workload{wl} {
+        }
+
+        const DPUWorkload& workload;
+        std::vector<float> descriptor;   ///< the NN input for the workload, empty until needed
+        std::optional<float> raw_value;  ///< the value in cache (a NN raw value), nothing at a miss
+    };
+
+    /// @brief looks up a workload in the cache, first step of a lookup-or-compute
+    /// @param workload the workload, must outlive the probe
+    /// @param source [out] what cache had the value, untouched at a miss
+    CacheProbe probe_cache(const DPUWorkload& workload, std::string* source = nullptr) const {
+        CacheProbe probe{workload};
+        if (!is_initialized()) {
+            return probe;
+        }
 
         // For newer devices, check new cache; otherwise use old cache
         if (use_new_hash_method(workload)) {
-            cached_value = new_cache.get(workload, source);
+            probe.raw_value = new_cache.get(workload, source);
         } else {
-            const std::vector<float> vector = preprocessing.transformSingle(workload);
-            cached_value = cache.get(vector, source);
+            prepare_descriptor(probe);
+            probe.raw_value = cache.get(probe.descriptor, source);
         }
+        return probe;
+    }
 
-        if (!cached_value) {
+    /// @returns the cost cached for the probed workload, ERROR_CACHE_MISS if there is none
+    CyclesInterfaceType get_cached(const CacheProbe& probe) const {
+        if (!probe.raw_value) {
             return Cycles::ERROR_CACHE_MISS;
         }
+        return to_cycles(probe.workload, *probe.raw_value);
+    }
 
-        if (post_processing.is_NN_value_invalid(*cached_value)) {
-            return Cycles::ERROR_INVALID_OUTPUT_RANGE;
+    /// @brief the cost of the probed workload: the cached one, or inferred by the NN and added to the cache without
+    /// building the key again
+    CyclesInterfaceType get_cost(CacheProbe& probe) const {
+        if (!is_initialized()) {
+            return Cycles::ERROR_INFERENCE_NOT_POSSIBLE;
         }
-
-        auto postProcessed_value = post_processing.process(workload, *cached_value);
-        return static_cast<CyclesInterfaceType>(std::ceil(postProcessed_value));
+        if (!probe.raw_value) {
+            prepare_descriptor(probe);
+            probe.raw_value = use_new_hash_method(probe.workload)
+                                      ? infer_and_cache(probe.workload, probe.descriptor.data(), new_cache,
+                                                        probe.workload)
+                                      : infer_and_cache(probe.workload, probe.descriptor.data(), cache,
+                                                        probe.descriptor);
+        }
+        return to_cycles(probe.workload, *probe.raw_value);
     }
 
+    /// @brief adds a value for the probed workload, only if the cache has none yet.
     /// Is const because the cache is mutable.
-    void add_to_cache(const DPUWorkload& workload, const float value) const {
-        if (!is_initialized()) {
+    void add_to_cache(CacheProbe& probe, const float value) const {
+        if (!is_initialized() || probe.raw_value) {
             return;
         }
 
         // For newer devices, add to new cache; otherwise use old cache
-        if (use_new_hash_method(workload)) {
-            new_cache.add(workload, value);
+        if (use_new_hash_method(probe.workload)) {
+            new_cache.add(probe.workload, value);
         } else {
-            const std::vector<float> vector = preprocessing.transformSingle(workload);
-            cache.add(vector, value);
+            prepare_descriptor(probe);
+            cache.add(probe.descriptor, value);
+        }
+        probe.raw_value = value;
+    }
+
+    /// @brief Only used as a WA to share fixed cache outside of nn_cost_provider - will be removed in future.
+    CyclesInterfaceType get_cached(const DPUWorkload& workload, std::string* source = nullptr) const {
+        return get_cached(probe_cache(workload, source));
+    }
+
+    /// Is const because the cache is mutable.
+    void add_to_cache(const DPUWorkload& workload, const float value) const {
+        CacheProbe probe{workload};
+        add_to_cache(probe, value);
+    }
+
+private:
+    /// builds the NN descriptor of the probed workload, once
+    void prepare_descriptor(CacheProbe& probe) const {
+        if (probe.descriptor.empty()) {
+            probe.descriptor.resize(preprocessing.output_size());
+            preprocessing.transformSingleInto(probe.workload, probe.descriptor.data());
         }
     }
 
+public:
     /// @brief provides the input and output versions of the loaded NN (debug purposes)
     std::tuple<int, int> getNNVersion() const {
         const auto& version{vpunn_runtime.model_version_info()};
@@ -367,10 +522,28 @@ private:
     const float default_NN_output{-1.0F};  ///< this is the value used in no NN output is present (like not loaded).
     const unsigned int batch_size{1};      ///< the batch size used for the inference, set at ctor, used for context
 
-    // Map of (thread ID, instance ID) to execution contexts
-    mutable std::map<std::thread::id, std::shared_ptr<NNExecutionContext>> context_map;
-    mutable std::shared_mutex context_map_mutex;  ///< Mutex to protect the context map
+    ExecutionContextPool<NNExecutionContext> context_pool;  ///< execution context of each thread, reused after exit
 private:
+    static constexpr const char* warm_cache_descriptors_name{"dpu_descriptors"};  ///< snapshot name of cache
+    static constexpr const char* warm_cache_workloads_name{"dpu_workloads"};      ///< snapshot name of new_cache
+
+    /// the version of the descriptors that are the keys of cache
+    int32_t descriptors_version() const {
+        return static_cast<int32_t>(vpunn_runtime.model_version_info().get_input_interface_version());
+    }
+
+    /// @brief merges in the preloaded caches the snapshots made by previous runs of the same model, if enabled
+    void load_warm_caches() {
+        const auto descriptors_file{warm_cache_filename(model_nickname, warm_cache_descriptors_name)};
+        if (!descriptors_file.empty()) {
+            cache.load_snapshot(descriptors_file, model_nickname, descriptors_version());
+        }
+        const auto workloads_file{warm_cache_filename(model_nickname, warm_cache_workloads_name)};
+        if (!workloads_file.empty()) {
+            new_cache.load_snapshot(workloads_file, model_nickname);
+        }
+    }
+
     /// @brief obtains the actual preprocessing instance from factory. The factory must live longer than the instance
     /// created. warning: Throws if not possible
     static Preprocessing<float>& init_preproc(const RuntimeProcessingFactory& factory,
@@ -22,6 +22,9 @@ namespace VPUNN {
 struct NNExecutionContext {
     InferenceExecutionData runtime_buffer_data;   ///< buffer data for the inference execution
     std::vector<float> workloads_results_buffer;  ///< buffer for the results of the BATCH inference
+    std::vector<float> miss_descriptors;          ///< packed descriptors of the BATCH workloads not found in cache
+    std::vector<size_t> miss_positions;           ///< positions in the BATCH of the workloads not found in cache
+    std::vector<float> descriptor;                ///< descriptor of one workload, reused to avoid allocations
 
     const std::thread::id thread_id;                        ///< thread id for the context
     static inline constexpr size_t prealloc_results{1000};  ///< how much results buffer to pre-alloc
@@ -0,0 +1,147 @@
+// Copyright © 2025 Intel Corporation
+// SPDX-License-Identifier: Apache 2.0
+// LEGAL NOTICE: Your use of this software and any required dependent software (the “Software Package”)
+// is subject to the terms and conditions of the software license agreements for the Software Package,
+// which may also include notices, disclaimers, or license terms for third party or open source software
+// included in or with the Software Package, and your use indicates your acceptance of all such terms.
+// Please refer to the “third-party-programs.txt” or other similarly-named text file included with the
+// Software Package for additional details.
+
+#ifndef VPUNN_INTRA_TILE_SPLIT_MEMO_H
+#define VPUNN_INTRA_TILE_SPLIT_MEMO_H
+
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "core/bounded_sharded_memo.h"
+#include "vpu/layer.h"
+#include "vpu/layer_split_info.h"
+#include "workload_optimization_types.h"
+
+namespace VPUNN {
+
+/**
+ * @brief Remembers the results of intra-tile splits, so an identical tile layer is not searched again.
+ *
+ * The key is the tile layer together with the SplitOptions, the value is the best split (DPUWorkloadsCost) and,
+ * if it was asked for, the list of all splits investigated. Searches with a time budget (maxLatencyUs) depend on
+ * timing and are not remembered. Failed searches (exceptions) are not remembered.
+ *
+ * Thread safe and bounded, see BoundedShardedMemo.
+ */
+class IntraTileSplitMemo {
+public:
+    /**
+     * @brief Construct a new IntraTileSplitMemo
+     *
+     * @param max_size maximum number of remembered tile layers, zero disables the memo
+     * @param shards_count number of independently locked parts, limited to max_size
+     */
+    explicit IntraTileSplitMemo(size_t max_size, size_t shards_count = DEFAULT_CACHE_SHARDS)
+            : memo(max_size, shards_count) {
+    }
+
+    /// @returns true if a search with these options gives always the same result and can be remembered
+    static bool is_memoizable(const SplitOptions& options) {
+        return options.maxLatencyUs == 0;
+    }
+
+    /**
+     * @brief finds the result of a previous intra-tile split of this tile layer
+     *
+     * @param tile_layer the layer of one tile
+     * @param options the options of the split
+     * @param all_splits [out] if not null, receives the list of all splits investigated. An entry remembered without
+     * this list is not usable then
+     * @returns the best split, or nothing if not available
+     */
+    std::optional<DPUWorkloadsCost> get(const DPULayer& tile_layer, const SplitOptions& options,
+                                        std::vector<DPUWorkloadsWithCyclesSplit>* all_splits) const {
+        if (!memo.is_enabled() || !is_memoizable(options)) {
+            return std::nullopt;
+        }
+        std::optional<DPUWorkloadsCost> found;
+        memo.visit(Key{tile_layer, options}, [&found, all_splits](const Outcome& outcome) {
+            if (all_splits && !outcome.all_splits.has_value()) {
+                return;
+            }
+            if (all_splits) {
+                all_splits->insert(all_splits->end(), outcome.all_splits->cbegin(), outcome.all_splits->cend());
+            }
+            found = outcome.best;
+        });
+        return found;
+    }
+
+    /**
+     * @brief remembers the result of an intra-tile split, replaces the previous one for the same key
+     *
+     * @param tile_layer the layer of one tile
+     * @param options the options of the split
+     * @param best the best split found
+     * @param all_splits the list of all splits investigated, null if not available
+     */
+    void add(const DPULayer& tile_layer, const SplitOptions& options, const DPUWorkloadsCost& best,
+             const std::vector<DPUWorkloadsWithCyclesSplit>* all_splits) {
+        if (!memo.is_enabled() || !is_memoizable(options)) {
+            return;
+        }
+        memo.add(Key{tile_layer, options}, Outcome{best, all_splits ? std::make_optional(*all_splits) : std::nullopt});
+    }
+
+    /// @returns the number of remembered tile layers
+    size_t size() const {
+        return memo.size();
+    }
+
+private:
+    /// what identifies a search. The cost source hints are outside of the layer equality/hash but select where the
+    /// costs come from (NN, profiling service, theoretical), so they are part of the key
+    struct Key {
+        DPULayer tile_layer;
+        SplitOptions options;
+
+        bool operator==(const Key& b) const {
+            return (tile_layer == b.tile_layer) && (tile_layer.cost_source_hint == b.tile_layer.cost_source_hint) &&
+                   (tile_layer.profiling_service_backend_hint == b.tile_layer.profiling_service_backend_hint) &&
+                   (options.maxWorkloads == b.options.maxWorkloads) &&
+                   (options.maxLatencyUs == b.options.maxLatencyUs) && (options.nDPU == b.options.nDPU) &&
+                   (options.runtimeOverhead == b.options.runtimeOverhead) && (options.target == b.options.target) &&
+                   (options.availableStrategies == b.options.availableStrategies) &&
+                   (options.pruneByLowerBound == b.options.pruneByLowerBound);
+        }
+    };
+
+    struct KeyHasher {
+        size_t operator()(const Key& key) const {
+            size_t h{key.tile_layer.hash()};
+            const auto mix = [&h](size_t v) {
+                h ^= v + 0x9e3779b9 + (h << 6) + (h >> 2);
+            };
+            mix(static_cast<size_t>(key.tile_layer.cost_source_hint));
+            mix(static_cast<size_t>(key.tile_layer.profiling_service_backend_hint));
+            mix(key.options.maxWorkloads);
+            mix(key.options.nDPU);
+            mix(key.options.runtimeOverhead);
+            mix(static_cast<size_t>(key.options.target));
+            mix(static_cast<size_t>(key.options.pruneByLowerBound));
+            for (const auto s : key.options.availableStrategies) {
+                mix(static_cast<size_t>(s));
+            }
+            return h;
+        }
+    };
+
+    /// what is remembered about one search
+    struct Outcome {
+        DPUWorkloadsCost best;                                                ///< cost and workloads of the best split
+        std::optional<std::vector<DPUWorkloadsWithCyclesSplit>> all_splits;  ///< all splits, if they were asked for
+    };
+
+    BoundedShardedMemo<std::unordered_map<Key, Outcome, KeyHasher>, KeyHasher> memo;  ///< search to outcome
+};
+
+}  // namespace VPUNN
+
+#endif  // VPUNN_INTRA_TILE_SPLIT_MEMO_H
@@ -56,6 +56,15 @@ public:
                                              const unsigned int runtimeOverhead = 0,
                                              const bool skip_power = true) const = 0;
 
+    /**
+     * @brief how many split candidates were not costed because of their lower bound (SplitOptions::pruneByLowerBound)
+     *
+     * @return the count accumulated over all the searches done by this tiler
+     */
+    virtual size_t get_pruned_candidates_count() const {
+        return 0;
+    }
+
     /**
      * @brief Destroy the DPUTiler object
      */
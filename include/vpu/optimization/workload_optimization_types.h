@@ -44,6 +44,10 @@ struct SplitOptions {
             VPUSplitStrategy::HW_TILING,
             VPUSplitStrategy::Z_TILING};  ///<  Valid strategies for splitting a layer into multiple workloads. Default
                                           ///<  is all (HW tiling and Z tiling)
+    bool pruneByLowerBound{false};  ///< Full search only, approximate: a split whose estimated lower bound (70% of
+                                    ///< the ideal MAC cycles, scheduled on the DPUs) exceeds the best cost found so
+                                    ///< far is not costed with the NN. The best split can differ from the one of the
+                                    ///< full search if the NN predicts below that part of the ideal cycles
 };
 
 /**
@@ -0,0 +1,399 @@
+// Copyright © 2025 Intel Corporation
+// SPDX-License-Identifier: Apache 2.0
+// LEGAL NOTICE: Your use of this software and any required dependent software (the “Software Package”)
+// is subject to the terms and conditions of the software license agreements for the Software Package,
+// which may also include notices, disclaimers, or license terms for third party or open source software
+// included in or with the Software Package, and your use indicates your acceptance of all such terms.
+// Please refer to the “third-party-programs.txt” or other similarly-named text file included with the
+// Software Package for additional details.
+
+#ifndef VPUNN_PROFILING_RESULT_STORE_H
+#define VPUNN_PROFILING_RESULT_STORE_H
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "core/logger.h"
+#include "core/utils.h"
+#include "vpu/cycles_interface_types.h"
+#include "vpu/dpu_types.h"
+
+namespace VPUNN {
+
+/**
+ * @brief Durable store of the results of the profiling service, keyed on the workload hash and the backend.
+ *
+ * The file is append only: a header followed by fixed size records (64 bit workload hash, 32 bit workload hash as
+ * fingerprint, backend, cycles, checksum), little endian. At construction the whole file is loaded in memory, where the
+ * lookups are done. A later record of the same key replaces an earlier one. A result is given only if the fingerprint
+ * matches, a collision of the 64 bit hashes is a miss.
+ *
+ * Several processes can use the same file. New results are appended by a background thread, each batch with a single
+ * write on a descriptor opened in append mode, so the records of different processes do not interleave. Records
+ * damaged by an interrupted write fail their checksum and are skipped at load, the ones after them are still read.
+ * The file is never truncated.
+ * All the results added are written before the destructor returns.
+ *
+ * A file that exists but is not a store (of this format) is never changed, the store is read only then (and empty).
+ * Thread safe.
+ */
+class ProfilingResultStore {
+public:
+    /// first bytes of a store file, the last character is the format version
+    static constexpr std::array<char, 8> file_magic{'V', 'P', 'U', 'N', 'N', 'P', 'S', '2'};
+    /// bytes of one record: workload hash (8), fingerprint, backend, cycles, checksum (4 each)
+    static constexpr size_t record_size{24};
+
+    /**
+     * @brief Opens (or creates) a store file and loads its content
+     *
+     * @param filename the file of the store
+     */
+    explicit ProfilingResultStore(std::string filename): filename{std::move(filename)} {
+        writable = load();
+        if (writable) {
+            writer = std::thread([this]() {
+                write_loop();
+            });
+        }
+    }
+
+    ProfilingResultStore(const ProfilingResultStore&) = delete;
+    ProfilingResultStore& operator=(const ProfilingResultStore&) = delete;
+
+    ~ProfilingResultStore() {
+        {
+            std::lock_guard<std::mutex> lock(queue_mtx);
+            stopping = true;
+        }
+        queue_cv.notify_all();
+        if (writer.joinable()) {
+            writer.join();
+        }
+    }
+
+    /**
+     * @brief the stored result for a workload
+     *
+     * @param workload_hash the 64 bit hash of the (sanitized) workload
+     * @param fingerprint the 32 bit hash of the same workload
+     * @param backend the backend that profiled it
+     * @returns the cycles or nothing if not stored
+     */
+    std::optional<CyclesInterfaceType> get(const uint64_t workload_hash, const uint32_t fingerprint,
+                                           const ProfilingServiceBackend backend) const {
+        if (backend == ProfilingServiceBackend::__size) {
+            return std::nullopt;
+        }
+        std::shared_lock<std::shared_mutex> lock(table_mtx);
+        const auto& table{tables[static_cast<size_t>(backend)]};
+        const auto it{table.find(workload_hash)};
+        if ((it == table.cend()) || (it->second.fingerprint != fingerprint)) {
+            return std::nullopt;
+        }
+        return it->second.cycles;
+    }
+
+    /**
+     * @brief stores a result, the file is written asynchronously. A result already stored with the same value is not
+     * written again
+     *
+     * @param workload_hash the 64 bit hash of the (sanitized) workload
+     * @param fingerprint the 32 bit hash of the same workload
+     * @param backend the backend that profiled it, unknown backends are not stored
+     * @param cycles the result, error codes are not stored
+     */
+    void add(const uint64_t workload_hash, const uint32_t fingerprint, const ProfilingServiceBackend backend,
+             const CyclesInterfaceType cycles) {
+        if ((backend == ProfilingServiceBackend::__size) || Cycles::isErrorCode(cycles)) {
+            return;
+        }
+        {
+            std::unique_lock<std::shared_mutex> lock(table_mtx);
+            auto& table{tables[static_cast<size_t>(backend)]};
+            const Stored stored{fingerprint, cycles};
+            const auto inserted{table.emplace(workload_hash, stored)};
+            if (!inserted.second) {
+                if ((inserted.first->second.fingerprint == fingerprint) && (inserted.first->second.cycles == cycles)) {
+                    return;
+                }
+                inserted.first->second = stored;
+            }
+        }
+        if (!writable) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(queue_mtx);
+            pending.push_back(encode(workload_hash, fingerprint, backend, cycles));
+            ++enqueued;
+        }
+        queue_cv.notify_all();
+    }
+
+    /// @brief waits until all the results added so far are in the file
+    void flush() {
+        std::unique_lock<std::mutex> lock(queue_mtx);
+        written_cv.wait(lock, [this]() {
+            return written == enqueued;
+        });
+    }
+
+    /// @returns the number of stored results
+    size_t size() const {
+        std::shared_lock<std::shared_mutex> lock(table_mtx);
+        size_t total{0};
+        for (const auto& table : tables) {
+            total += table.size();
+        }
+        return total;
+    }
+
+    /// @returns the number of results found in the file at construction
+    size_t loaded_count() const {
+        return loaded;
+    }
+
+    /// @returns the number of damaged records skipped at construction
+    size_t skipped_count() const {
+        return skipped;
+    }
+
+    /// @returns false if the new results are not written to the file
+    bool is_writable() const {
+        return writable;
+    }
+
+    /// @returns the file of the store
+    const std::string& get_filename() const {
+        return filename;
+    }
+
+private:
+    using Record = std::array<char, record_size>;
+
+    /// what is known about one workload and backend
+    struct Stored {
+        uint32_t fingerprint;        ///< 32 bit hash of the workload
+        CyclesInterfaceType cycles;  ///< the profiled result
+    };
+    static constexpr size_t backends_count{static_cast<size_t>(ProfilingServiceBackend::__size)};
+
+    const std::string filename;  ///< the store file
+    bool writable{false};        ///< the file is a store (or was created) and the writer runs
+    size_t loaded{0};            ///< results loaded at construction
+    size_t skipped{0};           ///< damaged records found at construction
+
+    std::array<std::unordered_map<uint64_t, Stored>, backends_count> tables;  ///< per backend, workload hash to result
+    mutable std::shared_mutex table_mtx;                                      ///< protects tables
+
+    std::vector<Record> pending;         ///< records waiting for the writer
+    size_t enqueued{0};                  ///< records given to the writer
+    size_t written{0};                   ///< records written by the writer
+    bool stopping{false};                ///< the writer ends after writing the pending records
+    std::mutex queue_mtx;                ///< protects pending, the counters and stopping
+    std::condition_variable queue_cv;    ///< wakes the writer
+    std::condition_variable written_cv;  ///< wakes flush
+    std::thread writer;                  ///< appends the pending records
+
+    static void put_u32(char* where, const uint32_t v) {
+        for (int i = 0; i < 4; ++i) {
+            where[i] = static_cast<char>((v >> (8 * i)) & 0xFFU);
+        }
+    }
+
+    static uint32_t get_u32(const char* where) {
+        uint32_t v{0};
+        for (int i = 0; i < 4; ++i) {
+            v |= static_cast<uint32_t>(static_cast<unsigned char>(where[i])) << (8 * i);
+        }
+        return v;
+    }
+
+    /// FNV-1a of the record content, without the checksum field
+    static uint32_t checksum_of(const char* record) {
+        uint32_t h{fnv_offset_basis};
+        for (size_t i = 0; i < record_size - 4; i += 4) {
+            h = fnv1a_add_uint32(h, get_u32(record + i));
+        }
+        return h;
+    }
+
+    static Record encode(const uint64_t workload_hash, const uint32_t fingerprint,
+                         const ProfilingServiceBackend backend, const CyclesInterfaceType cycles) {
+        Record record{};
+        put_u32(record.data(), static_cast<uint32_t>(workload_hash & 0xFFFFFFFFU));
+        put_u32(record.data() + 4, static_cast<uint32_t>(workload_hash >> 32));
+        put_u32(record.data() + 8, fingerprint);
+        put_u32(record.data() + 12, static_cast<uint32_t>(backend));
+        put_u32(record.data() + 16, cycles);
+        put_u32(record.data() + 20, checksum_of(record.data()));
+        return record;
+    }
+
+    /// @brief the record at this position, if its checksum is right
+    /// @returns false if the bytes are not a record
+    bool decode(const char* record) {
+        if (get_u32(record + 20) != checksum_of(record)) {
+            return false;
+        }
+        const uint32_t backend{get_u32(record + 12)};
+        if (backend < backends_count) {  // otherwise written by a version with more backends
+            const uint64_t workload_hash{static_cast<uint64_t>(get_u32(record)) |
+                                         (static_cast<uint64_t>(get_u32(record + 4)) << 32)};
+            tables[backend][workload_hash] = Stored{get_u32(record + 8), get_u32(record + 16)};
+        }
+        return true;
+    }
+
+    static int open_for_append(const std::string& name, const bool create) {
+#ifdef _WIN32
+        return ::_open(name.c_str(), _O_WRONLY | _O_APPEND | _O_BINARY | (create ? (_O_CREAT | _O_EXCL) : 0),
+                       _S_IREAD | _S_IWRITE);
+#else
+        return ::open(name.c_str(), O_WRONLY | O_APPEND | (create ? (O_CREAT | O_EXCL) : 0), 0644);
+#endif
+    }
+
+    static void close_file(const int fd) {
+#ifdef _WIN32
+        ::_close(fd);
+#else
+        ::close(fd);
+#endif
+    }
+
+    /// @brief writes all the bytes with as few system calls as possible, one when the OS allows it
+    static bool write_all(const int fd, const char* data, size_t size) {
+        while (size > 0) {
+#ifdef _WIN32
+            const auto done = ::_write(fd, data, static_cast<unsigned int>(size));
+#else
+            const auto done = ::write(fd, data, size);
+#endif
+            if (done < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            data += done;
+            size -= static_cast<size_t>(done);
+        }
+        return true;
+    }
+
+    /// @brief loads the file, or creates it with the header
+    /// @returns true if the file can receive the new records
+    bool load() {
+        const int created{open_for_append(filename, true)};  // only one of the processes creates it
+        if (created >= 0) {
+            const bool ok{write_all(created, file_magic.data(), file_magic.size())};
+            close_file(created);
+            if (!ok) {
+                Logger::warning() << "\n Profiling result store: cannot create " << filename << "\n";
+            }
+            return ok;
+        }
+
+        std::ifstream file(filename, std::ios::binary | std::ios::in);
+        if (!file) {
+            Logger::warning() << "\n Profiling result store: cannot open " << filename << "\n";
+            return false;
+        }
+        std::vector<char> content{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+        const size_t header_size{std::min(content.size(), file_magic.size())};
+        if (!std::equal(content.cbegin(), content.cbegin() + header_size, file_magic.cbegin())) {
+            Logger::warning() << "\n Profiling result store: " << filename
+                              << " is not a profiling result store of this version, it is not used\n";
+            return false;
+        }
+        if (content.size() < file_magic.size()) {
+            return false;  // being created by another process, not appended to before its header is complete
+        }
+
+        // a damaged record (interrupted write) shifts the ones appended after it: search the next valid record
+        size_t pos{file_magic.size()};
+        bool in_damaged{false};
+        while (pos + record_size <= content.size()) {
+            if (decode(content.data() + pos)) {
+                pos += record_size;
+                in_damaged = false;
+            } else {
+                skipped += in_damaged ? 0 : 1;
+                in_damaged = true;
+                ++pos;
+            }
+        }
+        for (const auto& table : tables) {
+            loaded += table.size();
+        }
+        if (skipped > 0) {
+            Logger::warning() << "\n Profiling result store: " << skipped << " damaged record(s) skipped in "
+                              << filename << "\n";
+        }
+        return true;
+    }
+
+    /// the writer thread: appends the pending records until stopped
+    void write_loop() {
+        const int fd{open_for_append(filename, false)};
+        if (fd < 0) {
+            Logger::warning() << "\n Profiling result store: cannot write " << filename << "\n";
+        }
+        std::vector<char> batch;
+        std::unique_lock<std::mutex> lock(queue_mtx);
+        while (true) {
+            queue_cv.wait(lock, [this]() {
+                return stopping || !pending.empty();
+            });
+            if (pending.empty()) {  // stopping, all written
+                break;
+            }
+            std::vector<Record> records;
+            records.swap(pending);
+            lock.unlock();
+            batch.clear();
+            for (const auto& record : records) {
+                batch.insert(batch.end(), record.cbegin(), record.cend());
+            }
+            if ((fd >= 0) && !write_all(fd, batch.data(), batch.size())) {
+                Logger::warning() << "\n Profiling result store: write failed for " << filename << "\n";
+            }
+            lock.lock();
+            written += records.size();
+            written_cv.notify_all();
+        }
+        if (fd >= 0) {
+            close_file(fd);
+        }
+    }
+};
+
+}  // namespace VPUNN
+
+#endif  // VPUNN_PROFILING_RESULT_STORE_H
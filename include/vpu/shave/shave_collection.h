@@ -21,6 +21,7 @@
 #include "shave_op_executors.h"
 #include "shave_vpuem_executors.h"
 #include "vpu/cycles_interface_types.h"
+#include "vpu/shave_op_id.h"
 #include "vpu/types.h"
 #include "vpu/shave/VPUEM_cost_function.h"
 #include "vpu/shave/shave_factors_mapping.h"
@@ -47,12 +48,25 @@ private:
     /// maps names of functions to their model instances (executor). Owns this instances, responsible with destruction
     std::map<std::string, map_content_t> map_shaves;
 
+    /// same executors as map_shaves, indexed by the interned operation name (ShaveOpId). Not owning, nullptr for ids
+    /// not present on this device
+    std::vector<const ShaveOpExecutor*> executors_by_id;
+
     /// @brief inserts an executor to the map, full transfer of ownership
     void addOp(map_content_t&& up) {
         if (up != nullptr) {
             // map[up->getName()] = std::move(up);  // overrides previous if existed
             // auto up{map_content_t(p, &deleter)};
-            map_shaves.insert({up->getName(), std::move(up)});  // for results checking
+            const ShaveOpExecutor* executor{up.get()};
+            const std::string name{up->getName()};
+            const auto inserted{map_shaves.insert({name, std::move(up)}).second};  // for results checking
+            if (inserted) {
+                const ShaveOpId id{ShaveOpIds::intern(name)};
+                if (id >= executors_by_id.size()) {
+                    executors_by_id.resize(id + 1, nullptr);
+                }
+                executors_by_id[id] = executor;
+            }
         }
     }
 
@@ -94,6 +108,12 @@ public:
         throw std::out_of_range(details);
     }
 
+    /// @brief finds the executor by interned operation name, no string compare and no exception
+    /// @returns the executor or nullptr if not present on this device
+    const ShaveOpExecutor* findShaveExecutor(ShaveOpId id) const noexcept {
+        return (id < executors_by_id.size()) ? executors_by_id[id] : nullptr;
+    }
+
 protected:
     // next are helper functions to add a particular instance of concrete  executors, will be used by derived types.
 
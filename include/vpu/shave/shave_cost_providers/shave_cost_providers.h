@@ -53,16 +53,18 @@ public:
     CyclesInterfaceType get_cost(const SHAVEWorkload& workload, std::string* cost_source = nullptr) const override {    
 
         VPUDevice device = workload.get_device();
-        auto shaveInstance = get_shave_instance(workload.get_name(), device);
+        // by interned name: no string compare and no exception on the hot path
+        const auto& sel = static_cast<const CostProviderImpl*>(this)->getSelectorImpl(device);
+        const ShaveOpExecutor* shaveInstance = sel.findShaveFunction(workload.get_op_id());
 
         // operator not found
-        if (!shaveInstance.has_value()) {
+        if (shaveInstance == nullptr) {
             return Cycles::ERROR_SHAVE_OPERATOR_MISSING;
         }
 
         if (cost_source) *cost_source = CostProviderImpl::cost_source_name;
 
-        return shaveInstance.value().get().dpuCycles(workload);
+        return shaveInstance->dpuCycles(workload);
     }
 
     /// @brief Get the maximum number of parameters across all SHAVE functions
@@ -43,6 +43,10 @@ public:
     virtual const ShaveOpExecutor& getShaveFuntion(const std::string& name) const {
         return container.getShaveExecutor(name);  // will throw if not existing
     }
+    /// @brief finds by interned operation name, @returns nullptr if not existing
+    virtual const ShaveOpExecutor* findShaveFunction(ShaveOpId id) const noexcept {
+        return container.findShaveExecutor(id);
+    }
     virtual std::vector<std::string> getShaveList() const {
         return container.getShaveList();
     }
@@ -72,6 +76,10 @@ public:
             return container2.getShaveExecutor(name);  // will throw if not existing
         }
     }
+    const ShaveOpExecutor* findShaveFunction(ShaveOpId id) const noexcept override {
+        const ShaveOpExecutor* first{ShaveSelector::findShaveFunction(id)};
+        return (first != nullptr) ? first : container2.findShaveExecutor(id);
+    }
     virtual std::vector<std::string> getShaveList() const override {
         auto v1{ShaveSelector::getShaveList()};
         const auto v2{container2.getShaveList()};
@@ -0,0 +1,48 @@
+// Copyright © 2025 Intel Corporation
+// SPDX-License-Identifier: Apache 2.0
+// LEGAL NOTICE: Your use of this software and any required dependent software (the “Software Package”)
+// is subject to the terms and conditions of the software license agreements for the Software Package,
+// which may also include notices, disclaimers, or license terms for third party or open source software
+// included in or with the Software Package, and your use indicates your acceptance of all such terms.
+// Please refer to the “third-party-programs.txt” or other similarly-named text file included with the
+// Software Package for additional details.
+
+#ifndef VPUNN_SHAVE_OP_ID_H
+#define VPUNN_SHAVE_OP_ID_H
+
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include "core/vpunn_api.h"
+
+namespace VPUNN {
+
+/// compact identifier of a SHAVE operator name, the same in the whole process
+using ShaveOpId = uint32_t;
+
+/**
+ * @brief Interns the SHAVE operator names into compact ids, used to find operator executors by index instead of by
+ * name.
+ *
+ * Ids are given in order, starting at zero, and are never released. Only the executor containers intern names, the
+ * workloads only look them up, so the table is bounded by the names of the registered executors. Thread safe.
+ */
+class VPUNN_API ShaveOpIds {
+public:
+    /// the id of a name that was never interned, no executor has it
+    static constexpr ShaveOpId unknown{std::numeric_limits<ShaveOpId>::max()};
+
+    /// @returns the id of the operator name, a new one if the name was not seen before
+    static ShaveOpId intern(const std::string& name);
+
+    /// @returns the id of an interned operator name, unknown otherwise. Never adds to the table
+    static ShaveOpId find(const std::string& name);
+
+    /// @returns how many names were interned, all ids are smaller than this
+    static ShaveOpId count();
+};
+
+}  // namespace VPUNN
+
+#endif  // VPUNN_SHAVE_OP_ID_H
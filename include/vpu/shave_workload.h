@@ -15,6 +15,8 @@
 #include <map>
 #include <sstream>  //
 #include <string>
+#include <type_traits>
+#include <unordered_map>
 #include <variant>
 #include <vector>
 
@@ -22,6 +24,7 @@
 #include "vpu_tensor.h"
 #include "dpu_defaults.h"
 #include "core/utils.h"
+#include "vpu/shave_op_id.h"
 
 namespace VPUNN {
 
@@ -67,6 +70,11 @@ public:
     std::string get_name() const {
         return name;
     };
+    /// @returns the interned id of the operation name, ShaveOpIds::unknown if no executor has this name.
+    /// Looked up at each call, not stored: creating a workload costs no lookup
+    ShaveOpId get_op_id() const {
+        return ShaveOpIds::find(name);
+    };
     VPUDevice get_device() const {
         return device;
     };
@@ -88,43 +96,76 @@ public:
         return loc_name;
     };
 
+    /// @brief hash of the workload, streamed over the fields without building a text.
+    /// Gives the same value as the hash of the comma separated text of the fields, used by the existing caches
     uint32_t hash() const {
-        std::stringstream ss;
-        ss << static_cast<int>(get_device()) << ",";
-        ss << get_name() << ",";
+        return hash_fields<uint32_t>();
+    }
+
+    /// @brief 64b variant of hash(), same text. Key of the v2 caches, where hash() is the fingerprint
+    uint64_t hash64() const {
+        return hash_fields<uint64_t>();
+    }
+
+private:
+    /// the FNV-1a hash of the comma separated text of the fields, of type H (uint32_t or uint64_t)
+    template <typename H>
+    H hash_fields() const {
+        BasicFNV1aTextHasher<H> h;
+        h.add_number(static_cast<int>(get_device())).add(",");
+        h.add(name).add(",");
+        const auto add_tensor = [&h](const VPUTensor& tensor) {
+            h.add_number(tensor.batches()).add(",");
+            h.add_number(tensor.channels()).add(",");
+            h.add_number(tensor.height()).add(",");
+            h.add_number(tensor.width()).add(",");
+            h.add_number(static_cast<int>(tensor.get_dtype())).add(",");
+            h.add_number(static_cast<int>(tensor.get_layout())).add(",");
+        };
         for (const auto& input : get_inputs()) {
-            ss << input.batches() << "," << input.channels() << "," << input.height() << "," << input.width() << "," << (int)input.get_dtype() << "," << (int)input.get_layout() << ",";
+            add_tensor(input);
         }
         for (const auto& output : get_outputs()) {
-            ss << output.batches() << "," << output.channels() << "," << output.height() << "," << output.width() << "," << (int)output.get_dtype() << "," << (int)output.get_layout()
-               << ",";
+            add_tensor(output);
         }
 
-        for (const auto& param : get_params()) {
+        for (const auto& param : get_params()) {  // as written by a stream
             std::visit(
-                    [&ss](auto&& arg) {
-                        ss << arg << ",";
+                    [&h](auto&& arg) {
+                        using T = std::decay_t<decltype(arg)>;
+                        if constexpr (std::is_same_v<T, std::string>) {
+                            h.add(arg);
+                        } else if constexpr (std::is_same_v<T, bool>) {
+                            h.add(arg ? "1" : "0");
+                        } else {
+                            h.add_number(arg);
+                        }
                     },
                     param);
+            h.add(",");
         }
 
-        for(const auto& extra_param : get_extra_params()) {
-            ss << extra_param.first << "/";
+        for (const auto& extra_param : get_extra_params()) {  // as written by std::to_string
+            h.add(extra_param.first).add("/");
             std::visit(
-                [&ss](auto&& arg) {
-                    if constexpr (std::is_same_v<std::decay_t<decltype(arg)>, std::string>) {
-                        ss << arg;
-                    } else {
-                        ss << std::to_string(arg);
-                    }
-                },
-                extra_param.second);
-            ss << ",";
+                    [&h](auto&& arg) {
+                        using T = std::decay_t<decltype(arg)>;
+                        if constexpr (std::is_same_v<T, std::string>) {
+                            h.add(arg);
+                        } else if constexpr (std::is_same_v<T, float>) {
+                            h.add_fixed_float(arg);
+                        } else {
+                            h.add_number(static_cast<int>(arg));
+                        }
+                    },
+                    extra_param.second);
+            h.add(",");
         }
-        
-        return fnv1a_hash(ss.str());
+
+        return h.value();
     }
 
+public:
     std::string toString() const {
         std::stringstream stream;
         stream << "SHAVEWorkload: \n"                                                                                //
@@ -181,6 +222,7 @@ public:
         return stream.str();
     };
     friend bool operator<(const VPUNN::SHAVEWorkload& lhs, const VPUNN::SHAVEWorkload& rhs);
+    friend bool operator==(const VPUNN::SHAVEWorkload& lhs, const VPUNN::SHAVEWorkload& rhs);
 };
 
 inline std::ostream& operator<<(std::ostream& stream, const VPUNN::SHAVEWorkload& d) {
@@ -188,6 +230,13 @@ inline std::ostream& operator<<(std::ostream& stream, const VPUNN::SHAVEWorkload
     return stream;
 }
 
+/// equality over the fields that are part of the hash (the location name is not)
+inline bool operator==(const VPUNN::SHAVEWorkload& lhs, const VPUNN::SHAVEWorkload& rhs) {
+    return (lhs.name == rhs.name) && (lhs.device == rhs.device) && (lhs.inputs == rhs.inputs) &&
+           (lhs.outputs == rhs.outputs) && (lhs.call_params == rhs.call_params) &&
+           (lhs.extra_params == rhs.extra_params);
+}
+
 inline bool operator<(const VPUNN::SHAVEWorkload& lhs, const VPUNN::SHAVEWorkload& rhs) {
     // lexicographical_compare style
     {  // name
@@ -224,6 +273,23 @@ inline bool operator<(const VPUNN::SHAVEWorkload& lhs, const VPUNN::SHAVEWorkloa
     return false;  // all are  no smaller or no larger than other
 }
 
+// Custom hasher for SHAVEWorkload using the hash() method
+struct SHAVEWorkloadHasher {
+    std::size_t operator()(const SHAVEWorkload& swl) const noexcept {
+        return static_cast<std::size_t>(swl.hash());
+    }
+};
+
+template <typename K>
+struct MapTypeSelector;  // Forward declaration, defined in cache.h
+
+// Specialization for SHAVEWorkload: use std::unordered_map with custom hasher
+template <>
+struct MapTypeSelector<SHAVEWorkload> {
+    template <typename V>
+    using type = std::unordered_map<SHAVEWorkload, V, SHAVEWorkloadHasher>;
+};
+
 }  // namespace VPUNN
 
 #endif  // VPUNN_TYPES_H
@@ -37,6 +37,10 @@ public:
         print_tags = new_mode;
         return old_mode;
     }
+    /// @returns the current mode
+    static bool get_print_tags() {
+        return print_tags;
+    }
 
     /// cleans  up the history
     /// @returns the state before reset
@@ -0,0 +1,97 @@
+// Copyright © 2025 Intel Corporation
+// SPDX-License-Identifier: Apache 2.0
+// LEGAL NOTICE: Your use of this software and any required dependent software (the “Software Package”)
+// is subject to the terms and conditions of the software license agreements for the Software Package,
+// which may also include notices, disclaimers, or license terms for third party or open source software
+// included in or with the Software Package, and your use indicates your acceptance of all such terms.
+// Please refer to the “third-party-programs.txt” or other similarly-named text file included with the
+// Software Package for additional details.
+
+#ifndef VPUNN_SANITIZATION_MEMO_H
+#define VPUNN_SANITIZATION_MEMO_H
+
+#include <optional>
+
+#include "core/bounded_sharded_memo.h"
+#include "vpu/validation/sanity_report.h"
+
+namespace VPUNN {
+
+/**
+ * @brief Remembers the outcome of the sanitization of workloads, so a repeated workload is not checked again.
+ *
+ * The key is the workload as received by the sanitization (raw), the value is the sanitized workload together with
+ * its SanityReport. Invalid workloads are remembered too (negative results).
+ * The textual findings depend on the Checker print mode, so the mode is part of an entry and an entry made in the
+ * other mode is not used.
+ *
+ * Thread safe and bounded, see BoundedShardedMemo.
+ *
+ * @tparam WL the workload type, must have hash() and a MapTypeSelector specialization
+ */
+template <typename WL>
+class SanitizationMemo {
+public:
+    /// what is remembered about one raw workload
+    struct Outcome {
+        WL sanitized_workload;  ///< the workload after sanitization
+        SanityReport report;    ///< the findings and the error code
+        bool print_tags;        ///< Checker print mode used to produce the report's text
+    };
+
+    /**
+     * @brief Construct a new SanitizationMemo
+     *
+     * @param max_size maximum number of remembered workloads, zero disables the memo
+     * @param shards_count number of independently locked parts, limited to max_size
+     */
+    explicit SanitizationMemo(size_t max_size, size_t shards_count = DEFAULT_CACHE_SHARDS)
+            : memo(max_size, shards_count) {
+    }
+
+    /**
+     * @brief finds the outcome of a previous sanitization of this raw workload
+     *
+     * @param raw_wl the workload before sanitization
+     * @param print_tags the current Checker print mode
+     * @returns the outcome, or nothing if not available
+     */
+    std::optional<Outcome> get(const WL& raw_wl, bool print_tags) const {
+        std::optional<Outcome> found;
+        memo.visit(raw_wl, [&found, print_tags](const Outcome& outcome) {
+            if (outcome.print_tags == print_tags) {
+                found = outcome;
+            }
+        });
+        return found;
+    }
+
+    /**
+     * @brief remembers the outcome of a sanitization, replaces the previous one for the same raw workload
+     *
+     * @param raw_wl the workload before sanitization
+     * @param outcome what sanitization produced
+     */
+    void add(const WL& raw_wl, Outcome outcome) {
+        memo.add(raw_wl, std::move(outcome));
+    }
+
+    /// @returns the number of remembered workloads
+    size_t size() const {
+        return memo.size();
+    }
+
+private:
+    /// selects the shard by the workload hash
+    struct WorkloadHash {
+        uint32_t operator()(const WL& wl) const {
+            return wl.hash();
+        }
+    };
+
+    BoundedShardedMemo<typename MapTypeSelector<WL>::template type<Outcome>, WorkloadHash> memo;  ///< raw to outcome
+};
+
+}  // namespace VPUNN
+
+#endif  // VPUNN_SANITIZATION_MEMO_H
@@ -11,7 +11,11 @@
 #define VPU_COST_MODEL_H
 
 #include <algorithm>
+#include <deque>
 #include <functional>
+#include <iterator>
+#include <map>
+#include <memory>
 #include <numeric>
 #include <string>
 #include <type_traits>
@@ -24,6 +28,7 @@
 #include "core/cache.h"
 #include "core/logger.h"
 #include "core/serializer.h"
+#include "core/thread_pool.h"
 
 #include "inference/post_process.h"
 #include "inference/postprocessing_factory.h"
@@ -41,6 +46,7 @@
 #include "vpu/cycles_interface_types.h"
 #include "vpu/dpu_info_pack.h"
 #include "vpu/validation/dpu_operations_sanitizer.h"
+#include "vpu/validation/sanitization_memo.h"
 
 #include "vpu/shave/shave_collection.h"
 #include "vpu/shave/shave_devices.h"
@@ -61,6 +67,7 @@
 #endif
 
 #include "vpu/energy_interface.h"
+#include "vpu/profiling_result_store.h"
 #include "vpu/vpu_mutex.h"
 
 namespace VPUNN {
@@ -104,10 +111,23 @@ protected:
     // should be const and init at ctor!
     std::string profiling_backend{"silicon"};  ///< backend for profiling service [silicon, vpuem]
     bool is_profiling_service_enabled{false};  ///< true if profiling service is enabled
+    /// results of the profiling service kept on disk between runs, null if not configured
+    std::unique_ptr<ProfilingResultStore> profiling_store;
 
     const DPU_OperationSanitizer sanitizer;  ///< sanitizer mechanisms
+    /// outcomes of sanitize_workload, repeated workloads are not checked again
+    mutable SanitizationMemo<DPUWorkload> sanitization_memo;
+
+    /// minimum number of workloads given to one task when DPU(vector) is evaluated in parallel
+    static constexpr size_t min_workloads_per_batch_task{64};
+    const std::unique_ptr<ThreadPool> batch_pool;  ///< workers for DPU(vector), null if evaluated sequentially
 
 private:
+    /// @brief creates the pool used by DPU(vector), the calling thread is one of the batch_threads
+    static std::unique_ptr<ThreadPool> make_batch_pool(const unsigned int batch_threads) {
+        return (batch_threads > 1) ? std::make_unique<ThreadPool>(batch_threads - 1) : nullptr;
+    }
+
     /**
      * @brief Ensures that input channels are equal to output channels for channel preserving operations
      *
@@ -168,6 +188,18 @@ private:
 #endif
     }
 
+    /**
+     * @brief Opens the store of profiling service results named by the VPUNN_PROFILING_SERVICE_STORE environment
+     * variable, if set. The stored results are used also without the profiling service (or its HTTP client).
+     */
+    void init_profiling_store() {
+        const std::string env_store =
+                get_env_vars({"VPUNN_PROFILING_SERVICE_STORE"}).at("VPUNN_PROFILING_SERVICE_STORE");
+        if (!env_store.empty()) {
+            profiling_store = std::make_unique<ProfilingResultStore>(env_store);
+        }
+    }
+
 public:
     /// returns a reference of energy object
     /// owned by the current costmodel
@@ -239,6 +271,18 @@ public:
         return dpu_nn_cost_provider;
     }
 
+    /// @brief saves the dynamic caches of the DPU NN for the warm start of the next runs, @sa NNCostProvider
+    /// @returns false if enabled and a snapshot could not be written
+    bool save_warm_caches() const {
+        return dpu_nn_cost_provider.save_warm_caches();
+    }
+
+    /// @brief true if workloads can be evaluated from several threads at the same time.
+    /// Not when the profiling service is used or the workloads are serialized (both are sequential by nature)
+    bool allows_concurrent_evaluation() const {
+        return !is_profiling_service_enabled && !serializer.is_serialization_enabled();
+    }
+
     /**
      * @brief Construct a new VPUCostModel object
      *
@@ -266,16 +310,21 @@ public:
      * @param shave_cache_filename the name of the shave cache file
      * @param tryToLoadPairedCache , special condition: if main file empty, try to load the paired cache, generated name
      * based on NN file. (fro DPU, for others?) DRAFT!
+     * @param batch_threads how many threads evaluate a list of DPU workloads (including the calling thread), 0 or 1
+     * means sequential evaluation
      *
      */
     explicit VPUCostModel(const std::string& filename = "", bool profile = false, const unsigned int cache_size = 16384,
                           const unsigned int batch_size = 1, const std::string& dpu_cache_filename = "",
                           const std::string& shave_cache_filename = "", bool use_shave_2_api = false,
-                          bool tryToLoadPairedCache = false)
+                          bool tryToLoadPairedCache = false, const unsigned int batch_threads = 0)
             : dpu_nn_cost_provider(filename, batch_size, profile, cache_size, dpu_cache_filename, tryToLoadPairedCache),
               ptr_internal_shave_cost_model(
-                      std::make_shared<SHAVECostModel>(shave_cache_filename, cache_size, use_shave_2_api)) {
+                      std::make_shared<SHAVECostModel>(shave_cache_filename, cache_size, use_shave_2_api)),
+              sanitization_memo{cache_size},
+              batch_pool{make_batch_pool(batch_threads)} {
         Logger::initialize();
+        init_profiling_store();
 
         if (!dpu_nn_cost_provider.is_initialized()) {
             return;
@@ -298,17 +347,22 @@ public:
      * @param profile enable/disable profiling
      * @param cache_size the size of the LRUCache
      * @param batch_size model batch size
+     * @param batch_threads how many threads evaluate a list of DPU workloads (including the calling thread), 0 or 1
+     * means sequential evaluation
      */
     explicit VPUCostModel(const char* model_data, size_t model_data_length, bool copy_model_data, bool profile = false,
                           const unsigned int cache_size = 16384, const unsigned int batch_size = 1,
                           const char* dpu_cache_data = nullptr, size_t dpu_cache_data_length = 0,
                           const char* shave_cache_data = nullptr, size_t shave_cache_data_length = 0,
-                          bool use_shave_2_api = false)
+                          bool use_shave_2_api = false, const unsigned int batch_threads = 0)
             : dpu_nn_cost_provider(model_data, model_data_length, batch_size, copy_model_data, profile, cache_size,
                                    dpu_cache_data, dpu_cache_data_length),
               ptr_internal_shave_cost_model(std::make_shared<SHAVECostModel>(shave_cache_data, shave_cache_data_length,
-                                                                             cache_size, use_shave_2_api)) {
+                                                                             cache_size, use_shave_2_api)),
+              sanitization_memo{cache_size},
+              batch_pool{make_batch_pool(batch_threads)} {
         Logger::initialize();
+        init_profiling_store();
 
         if (!dpu_nn_cost_provider.is_initialized()) {
             return;
@@ -325,16 +379,32 @@ public:
     /// @sa DPU_OperationSanitizer::check_and_sanitize for details
     /// from legacy behavior is ensures that input channels are equal to output channels for channel preserving
     /// operations
+    /// The outcome is memoized, a workload seen before gets the remembered sanitized workload and report.
+    ///
     /// @param workload [in, out] to be checked and changed
     /// @param result [out] holds error code
     /// @returns true if checks were OK, false if this wl is not to be used
     bool sanitize_workload(DPUWorkload& workload, SanityReport& result) const {
+        const bool print_tags{Checker::get_print_tags()};
+        if (auto known = sanitization_memo.get(workload, print_tags)) {
+            // fields outside of the workload equality are not touched by sanitization, keep the ones received
+            DPUWorkload& sanitized{known->sanitized_workload};
+            sanitized.offsets = workload.offsets;
+            sanitized.cost_source_hint = workload.cost_source_hint;
+            sanitized.profiling_service_backend_hint = workload.profiling_service_backend_hint;
+            workload = std::move(sanitized);
+            result = std::move(known->report);
+            return result.is_usable();
+        }
+
+        const DPUWorkload raw_workload{workload};
         avgpool_replace_by(workload);  // AVEPOOL will be transformed to something equivalent
         compressConv_replace_by_CM_CONV_VPU27(workload);
 
         channels_preserving_operations_consistency_check(workload);  // old style sanitation
 
         sanitizer.check_and_sanitize(workload, result);
+        sanitization_memo.add(raw_workload, {workload, result, print_tags});
         return result.is_usable();
     }
 
@@ -355,6 +425,17 @@ protected:
         const auto wl_noWt{cloneDeactivateWeightSParsity(workload)};
         const CyclesInterfaceType wt_off = run_cost_providers(wl_noWt, info);
 
+        return dualsparsity_cost(act_off, wt_off);
+    }
+
+    /**
+     * @brief the runtime of a workload with both sparsities active, from its runtimes with only one of them active
+     *
+     * @param act_off the runtime with the activation sparsity deactivated
+     * @param wt_off the runtime with the weight sparsity deactivated
+     * @return the runtime or error
+     */
+    static CyclesInterfaceType dualsparsity_cost(const CyclesInterfaceType act_off, const CyclesInterfaceType wt_off) {
         // case when act_off is invalid, also this catch the case when both of values are invalid
         //   does not count which of them we return if both are invalid
         if (Cycles::isErrorCode(act_off)) {
@@ -401,6 +482,9 @@ protected:
      * This function checks if the DPU NN cost provider is initialized and retrieves the cost from the cache or
      * profiling service. If the profiling service is not available, it falls back to the DPU NN cost provider or
      * theoretical cycles.
+     * In AUTO mode a result of the profiling service kept in the store is preferred to the caches. The cache key is
+     * built once and the cache is probed once, the same key serves the NN inference and the insertion of the computed
+     * cost.
      *
      * @param workload The DPU workload to be processed.
      * @param info A string to store additional information about the cost source.
@@ -409,93 +493,260 @@ protected:
      */
     CyclesInterfaceType run_cost_providers(const DPUWorkload& workload, std::string& info,
                                            std::string* cost_source = nullptr) const {
-        CyclesInterfaceType cycles{Cycles::NO_ERROR};
-        const bool is_inference_possible = dpu_nn_cost_provider.is_initialized();
+        if (workload.cost_source_hint == CostSourceHint::AUTO) {
+            // 1. Stored results of the profiling service
+            if (const auto stored = stored_profiling_result(workload, cost_source)) {
+                return *stored;
+            }
 
-        const auto try_cache = [&]() -> CyclesInterfaceType {
-            return dpu_nn_cost_provider.get_cached(workload, cost_source);
-        };
-        const auto try_profiling = [&]() -> CyclesInterfaceType {
-            if (!is_profiling_service_enabled) {
-                return Cycles::ERROR_PROFILING_SERVICE;
+            // 2. Cache
+            auto probe{dpu_nn_cost_provider.probe_cache(workload, cost_source)};
+            const auto cached = dpu_nn_cost_provider.get_cached(probe);
+            if (!Cycles::isErrorCode(cached)) {
+                return cached;
             }
 
-            auto get_profiling_backend_string = [&](ProfilingServiceBackend backend) -> std::string {
-                if (backend != ProfilingServiceBackend::__size) {
-                    return mapToText<ProfilingServiceBackend>().at(static_cast<int>(backend));
-                }
-                return profiling_backend;
-            };
+            // 3. Profiling service, 4. Fallbacks
+            return cost_after_cache_miss(workload, probe, service_cost(workload, info, cost_source), cost_source);
 
-            if (cost_source) {
-                *cost_source =
-                        "profiling_service_" + get_profiling_backend_string(workload.profiling_service_backend_hint);
-            }
+        } else if (workload.cost_source_hint == CostSourceHint::PROFILING_SERVICE) {
+            return profiling_cost(workload, info, cost_source);
 
-            auto dpu_op = DPUOperation(workload, sanitizer.getDeviceConfiguration(workload.device));
+        } else if (workload.cost_source_hint == CostSourceHint::NN) {
+            return nn_cost(workload, nullptr, cost_source);
 
-#ifdef VPUNN_BUILD_HTTP_CLIENT
-            return http_dpu_cost_provider->getCost(
-                    dpu_op, info, get_profiling_backend_string(workload.profiling_service_backend_hint));
-#else
-            (void)dpu_op;
-            (void)info;
-            return Cycles::ERROR_PROFILING_SERVICE;
-#endif
-        };
-        const auto try_nn = [&]() -> CyclesInterfaceType {
-            if (!is_inference_possible) {
-                return Cycles::ERROR_INFERENCE_NOT_POSSIBLE;
+        } else if (workload.cost_source_hint == CostSourceHint::THEORETICAL) {
+            return theoretical_cost(workload, cost_source);
+        }
+
+        return Cycles::NO_ERROR;
+    }
+
+    /**
+     * @brief Run the cost providers for a list of workloads, same results as run_cost_providers for each one.
+     *
+     * The workloads that need the profiling service (no stored result, and a cache miss in AUTO mode or the
+     * PROFILING_SERVICE hint) are asked together, in batched requests for each backend, instead of one round trip
+     * each. The cache is probed once for each workload.
+     *
+     * @param workloads the sanitized workloads, not both sparsities active. Must not change during the call.
+     * @param infos [in, out] the info of each workload, same role as info of run_cost_providers, same order
+     * @param cost_sources [out] the source of the cost of each workload, same order
+     * @return the cycles of each workload, same order
+     * @throws std::runtime_error if the profiling service cannot be reached, like run_cost_providers
+     */
+    std::vector<CyclesInterfaceType> run_cost_providers(const std::vector<DPUWorkload>& workloads,
+                                                        std::vector<std::string>& infos,
+                                                        std::vector<std::string>& cost_sources) const {
+        const auto number_of_workloads{workloads.size()};
+        std::vector<CyclesInterfaceType> cycles(number_of_workloads, Cycles::NO_ERROR);
+        infos.resize(number_of_workloads);
+        cost_sources.assign(number_of_workloads, "unknown");
+
+        std::vector<NNCostProvider::CacheProbe> probes;  // of the AUTO workloads that missed the cache
+        std::vector<size_t> probe_of(number_of_workloads, number_of_workloads);  // index in probes
+        std::vector<char> asks_profiling(number_of_workloads, 0);
+        std::map<std::string, std::vector<size_t>> asked_of_backend;  // the workloads to ask the service, by backend
+        for (size_t idx = 0; idx < number_of_workloads; ++idx) {
+            const DPUWorkload& wl{workloads[idx]};
+            if ((wl.cost_source_hint == CostSourceHint::AUTO) ||
+                (wl.cost_source_hint == CostSourceHint::PROFILING_SERVICE)) {
+                if (const auto stored = stored_profiling_result(wl, &cost_sources[idx])) {
+                    cycles[idx] = *stored;
+                    continue;
+                }
             }
-            if (cost_source) {
-                *cost_source = "nn_" + dpu_nn_cost_provider.get_model_nickname();
+            if (wl.cost_source_hint == CostSourceHint::AUTO) {
+                auto probe{dpu_nn_cost_provider.probe_cache(wl, &cost_sources[idx])};
+                cycles[idx] = dpu_nn_cost_provider.get_cached(probe);
+                if (!Cycles::isErrorCode(cycles[idx])) {
+                    continue;
+                }
+                probe_of[idx] = probes.size();
+                probes.push_back(std::move(probe));
+            } else if (wl.cost_source_hint != CostSourceHint::PROFILING_SERVICE) {
+                cycles[idx] = run_cost_providers(wl, infos[idx], &cost_sources[idx]);
+                continue;
             }
-            return dpu_nn_cost_provider.get_cost(workload);
-        };
-        const auto try_theoretical = [&]() -> CyclesInterfaceType {
-            if (cost_source) {
-                *cost_source = "theoretical";
+            asks_profiling[idx] = 1;
+            if (is_profiling_service_enabled) {
+                asked_of_backend[profiling_backend_of(wl)].push_back(idx);
             }
-            return dpu_theoretical.DPUTheoreticalCycles(workload);
-        };
+        }
 
-        if (workload.cost_source_hint == CostSourceHint::AUTO) {
-            // 1. Cache
-            const auto cached = try_cache();
-            if (!Cycles::isErrorCode(cached)) {
-                return cached;
+        std::vector<std::optional<CyclesInterfaceType>> profiled(number_of_workloads);  // answers of the service
+#ifdef VPUNN_BUILD_HTTP_CLIENT
+        for (const auto& [backend, asked] : asked_of_backend) {
+            std::deque<DPUOperation> operations;  // DPUOperation cannot be moved
+            std::vector<const DPUOperation*> ops;
+            for (const size_t idx : asked) {
+                operations.emplace_back(workloads[idx], sanitizer.getDeviceConfiguration(workloads[idx].device));
+                ops.push_back(&operations.back());
             }
-
-            // 2. Profiling service
-            cycles = try_profiling();
-
-            // 3. Fallbacks (NN then theoretical)
-            if (Cycles::isErrorCode(cycles) || cycles == Cycles::NO_ERROR) {
-                cycles = try_nn();
-                if (Cycles::isErrorCode(cycles)) {
-                    cycles = try_theoretical();
-                }
+            auto results{http_dpu_cost_provider->getCosts(ops, backend)};
+            for (size_t i = 0; i < asked.size(); ++i) {
+                const size_t idx{asked[i]};
+                profiled[idx] = results[i].cycles;
+                infos[idx] = std::move(results[i].info);
+                keep_profiling_result(workloads[idx], results[i].cycles);
             }
+        }
+#endif
 
-            // Share result with NN cache if needed (only if cache had no valid entry)
-            if (Cycles::isErrorCode(dpu_nn_cost_provider.get_cached(workload)) && !Cycles::isErrorCode(cycles)) {
-                dpu_nn_cost_provider.add_to_cache(workload, static_cast<float>(cycles));
+        for (size_t idx = 0; idx < number_of_workloads; ++idx) {
+            if (!asks_profiling[idx]) {
+                continue;
             }
-            return cycles;
+            const DPUWorkload& wl{workloads[idx]};
+            if (profiled[idx]) {
+                cost_sources[idx] = "profiling_service_" + profiling_backend_of(wl);
+            }
+            const CyclesInterfaceType profiling{profiled[idx] ? *profiled[idx] : Cycles::ERROR_PROFILING_SERVICE};
+            cycles[idx] = (probe_of[idx] < probes.size())
+                                  ? cost_after_cache_miss(wl, probes[probe_of[idx]], profiling, &cost_sources[idx])
+                                  : profiling;
+        }
+        return cycles;
+    }
 
-        } else if (workload.cost_source_hint == CostSourceHint::PROFILING_SERVICE) {
-            cycles = try_profiling();
+    /**
+     * @brief The cost of a workload from the stored results of the profiling service, or from the service itself.
+     *
+     * @param workload The DPU workload to be processed.
+     * @param info A string to store additional information about the cost.
+     * @param cost_source A string to store the source of the cost, untouched if the service is not used.
+     * @return The number of cycles, ERROR_PROFILING_SERVICE if the service is not enabled and no result is stored.
+     */
+    CyclesInterfaceType profiling_cost(const DPUWorkload& workload, std::string& info,
+                                       std::string* cost_source) const {
+        // the stored results are used also when the service is not reachable
+        if (const auto stored = stored_profiling_result(workload, cost_source)) {
+            return *stored;
+        }
+        return service_cost(workload, info, cost_source);
+    }
 
-        } else if (workload.cost_source_hint == CostSourceHint::NN) {
-            cycles = try_nn();
+    /**
+     * @brief The cost of a workload asked to the profiling service. A valid result is stored.
+     *
+     * @param workload The DPU workload to be processed.
+     * @param info A string to store additional information about the cost.
+     * @param cost_source A string to store the source of the cost, untouched if the service is not enabled.
+     * @return The number of cycles, ERROR_PROFILING_SERVICE if the service is not enabled.
+     */
+    CyclesInterfaceType service_cost(const DPUWorkload& workload, std::string& info, std::string* cost_source) const {
+        if (!is_profiling_service_enabled) {
+            return Cycles::ERROR_PROFILING_SERVICE;
+        }
 
-        } else if (workload.cost_source_hint == CostSourceHint::THEORETICAL) {
-            cycles = try_theoretical();
+        if (cost_source) {
+            *cost_source = "profiling_service_" + profiling_backend_of(workload);
+        }
+
+        auto dpu_op = DPUOperation(workload, sanitizer.getDeviceConfiguration(workload.device));
+
+#ifdef VPUNN_BUILD_HTTP_CLIENT
+        const CyclesInterfaceType profiled{
+                http_dpu_cost_provider->getCost(dpu_op, info, profiling_backend_of(workload))};
+        keep_profiling_result(workload, profiled);
+        return profiled;
+#else
+        (void)dpu_op;
+        (void)info;
+        return Cycles::ERROR_PROFILING_SERVICE;
+#endif
+    }
+
+    /// @brief stores a result of the profiling service for the next runs, if there is a store
+    void keep_profiling_result(const DPUWorkload& workload, const CyclesInterfaceType profiled) const {
+        if (profiling_store && !Cycles::isErrorCode(profiled)) {
+            profiling_store->add(workload.hash64(), workload.hash(), profiling_backend_id_of(workload), profiled);
+        }
+    }
+
+    /**
+     * @brief AUTO mode after a cache miss: the cost given by the profiling service if valid, else the NN one, else the
+     * theoretical one. A valid cost is added to the cache through the probe.
+     *
+     * @param workload The DPU workload to be processed.
+     * @param probe The cache probe of the workload, that missed.
+     * @param profiled The answer of the profiling service, or its error.
+     * @param cost_source A string to store the source of the cost.
+     * @return The number of cycles required for the workload.
+     */
+    CyclesInterfaceType cost_after_cache_miss(const DPUWorkload& workload, NNCostProvider::CacheProbe& probe,
+                                              const CyclesInterfaceType profiled, std::string* cost_source) const {
+        CyclesInterfaceType cycles{profiled};
+        if (Cycles::isErrorCode(cycles) || cycles == Cycles::NO_ERROR) {
+            cycles = nn_cost(workload, &probe, cost_source);  // the NN result is cached by the provider
+            if (Cycles::isErrorCode(cycles)) {
+                cycles = theoretical_cost(workload, cost_source);
+            }
         }
 
+        // Share result with NN cache if needed (only if cache had no entry)
+        if (!Cycles::isErrorCode(cycles)) {
+            dpu_nn_cost_provider.add_to_cache(probe, static_cast<float>(cycles));
+        }
         return cycles;
     }
 
+    /// @brief the cost of a workload given by the NN, through its cache probe if there is one
+    CyclesInterfaceType nn_cost(const DPUWorkload& workload, NNCostProvider::CacheProbe* probe,
+                                std::string* cost_source) const {
+        if (!dpu_nn_cost_provider.is_initialized()) {
+            return Cycles::ERROR_INFERENCE_NOT_POSSIBLE;
+        }
+        if (cost_source) {
+            *cost_source = "nn_" + dpu_nn_cost_provider.get_model_nickname();
+        }
+        return probe ? dpu_nn_cost_provider.get_cost(*probe) : dpu_nn_cost_provider.get_cost(workload);
+    }
+
+    /// @brief the theoretical cost of a workload
+    CyclesInterfaceType theoretical_cost(const DPUWorkload& workload, std::string* cost_source) const {
+        if (cost_source) {
+            *cost_source = "theoretical";
+        }
+        return dpu_theoretical.DPUTheoreticalCycles(workload);
+    }
+
+    /// @brief the profiling service backend for a workload: its hint, or the default backend if it has none
+    std::string profiling_backend_of(const DPUWorkload& workload) const {
+        if (workload.profiling_service_backend_hint != ProfilingServiceBackend::__size) {
+            return mapToText<ProfilingServiceBackend>().at(static_cast<int>(workload.profiling_service_backend_hint));
+        }
+        return profiling_backend;
+    }
+
+    /// @brief the profiling service backend for a workload, as enum. ProfilingServiceBackend::__size if the default
+    /// backend is not a known one
+    ProfilingServiceBackend profiling_backend_id_of(const DPUWorkload& workload) const {
+        if (workload.profiling_service_backend_hint != ProfilingServiceBackend::__size) {
+            return workload.profiling_service_backend_hint;
+        }
+        for (const auto& [id, name] : mapToText<ProfilingServiceBackend>()) {
+            if (name == profiling_backend) {
+                return static_cast<ProfilingServiceBackend>(id);
+            }
+        }
+        return ProfilingServiceBackend::__size;
+    }
+
+    /// @brief the result of a previous run of the profiling service for this (sanitized) workload, if stored on disk
+    /// @param cost_source [out] set to the profiling service if there is a result
+    std::optional<CyclesInterfaceType> stored_profiling_result(const DPUWorkload& workload,
+                                                               std::string* cost_source = nullptr) const {
+        if (!profiling_store) {
+            return std::nullopt;
+        }
+        auto stored{profiling_store->get(workload.hash64(), workload.hash(), profiling_backend_id_of(workload))};
+        if (stored && cost_source) {
+            *cost_source = "profiling_service_" + profiling_backend_of(workload);
+        }
+        return stored;
+    }
+
     /**
      * @brief checks if both input tensor sparsity(activation) and wl weight sparsity are active
      *
@@ -551,10 +802,11 @@ protected:
         if (exists_dual_spars) {
             std::vector<CyclesInterfaceType> cycles_vector;
             cycles_vector.reserve(workloads.size());
-            std::transform(workloads.cbegin(), workloads.cend(), cycles_vector.begin(), [this](const DPUWorkload& wl) {
-                std::string info, source;
-                return get_cost(wl, info, &source);
-            });
+            std::transform(workloads.cbegin(), workloads.cend(), std::back_inserter(cycles_vector),
+                           [this](const DPUWorkload& wl) {
+                               std::string info, source;
+                               return get_cost(wl, info, &source);
+                           });
 
             return cycles_vector;
         } else {
@@ -690,6 +942,134 @@ public:
 
         const auto number_of_workloads{workloads.size()};  ///< fixed value remembered here, workloads is non const
         std::vector<CyclesInterfaceType> cycles_vector = std::vector<CyclesInterfaceType>(number_of_workloads);
+
+        const size_t chunk_size{batch_chunk_size(number_of_workloads)};
+        if (chunk_size >= number_of_workloads) {
+            DPU_costs(workloads, cycles_vector.data());
+        } else {
+            // each chunk is an independent evaluation, results are written at the chunk's position (same order)
+            const size_t chunks_count{(number_of_workloads + chunk_size - 1) / chunk_size};
+            batch_pool->parallel_for(chunks_count, [&](size_t chunk) {
+                const size_t first{chunk * chunk_size};
+                const size_t last{std::min(first + chunk_size, number_of_workloads)};
+                std::vector<DPUWorkload> chunk_wls(std::make_move_iterator(workloads.begin() + first),
+                                                   std::make_move_iterator(workloads.begin() + last));
+                DPU_costs(chunk_wls, cycles_vector.data() + first);
+            });
+        }
+
+        const std::string dpu_nickname{get_NN_cost_provider().get_model_nickname()};
+        L1CostSerializationWrap serialization_handler(serializer);
+        serialization_handler.serializeCyclesAndComputeWorkloadUid_closeLine(std::move(serializer_orig_wls),
+                                                                             cycles_vector, dpu_nickname);
+
+        return cycles_vector;
+    }
+
+    /**
+     * @brief Return the number of cycles of each workload, the same values as DPU(wl) called for each one in order
+     *
+     * Unlike DPU(vector), every workload takes the complete single workload path (all cost providers and the
+     * workload's hints). Large lists are spread over the batch threads if the model has them and allows concurrent
+     * evaluation. With the profiling service the workloads it has to cost are asked in batched requests.
+     *
+     * @param workloads the workloads, not changed
+     * @return std::vector<CyclesInterfaceType> the cycles or error code of each workload, same order
+     * @throws the exceptions of DPU(wl), the first one if several threads throw
+     */
+    std::vector<CyclesInterfaceType> DPU_each(const std::vector<DPUWorkload>& workloads) const {
+        if (is_profiling_service_enabled) {
+            return DPU_each_profiled(workloads);  // a few round trips instead of one per workload
+        }
+
+        const auto number_of_workloads{workloads.size()};
+        std::vector<CyclesInterfaceType> cycles_vector(number_of_workloads);
+        const auto evaluate = [&](size_t first, size_t last) {
+            std::string info;
+            for (size_t idx = first; idx < last; ++idx) {
+                cycles_vector[idx] = DPU(workloads[idx], info);
+            }
+        };
+
+        const size_t chunk_size{allows_concurrent_evaluation() ? batch_chunk_size(number_of_workloads)
+                                                               : number_of_workloads};
+        if (chunk_size >= number_of_workloads) {
+            evaluate(0, number_of_workloads);
+        } else {
+            const size_t chunks_count{(number_of_workloads + chunk_size - 1) / chunk_size};
+            batch_pool->parallel_for(chunks_count, [&](size_t chunk) {
+                const size_t first{chunk * chunk_size};
+                evaluate(first, std::min(first + chunk_size, number_of_workloads));
+            });
+        }
+        return cycles_vector;
+    }
+
+private:
+    /// @brief DPU_each with the profiling service: all the workloads are sanitized first, then costed together by the
+    /// list form of run_cost_providers. Same results and serialization as DPU(wl) called for each one in order.
+    std::vector<CyclesInterfaceType> DPU_each_profiled(const std::vector<DPUWorkload>& workloads) const {
+        const auto number_of_workloads{workloads.size()};
+        std::vector<DPUWorkload> sanitized{workloads};
+        std::vector<SanityReport> problems(number_of_workloads);
+        std::vector<char> is_inference_relevant(number_of_workloads, 0);
+        std::vector<DPUWorkload> to_cost;                        // one for each relevant workload, two if dual sparsity
+        std::vector<size_t> first_to_cost(number_of_workloads);  // position of the workload in to_cost
+        std::vector<std::string> infos;
+        for (size_t idx = 0; idx < number_of_workloads; ++idx) {
+            DPUWorkload& wl{sanitized[idx]};
+            swizzling_turn_OFF(wl);  // swizz guard sanitization
+            is_inference_relevant[idx] = sanitize_workload(wl, problems[idx]);
+            first_to_cost[idx] = to_cost.size();
+            if (!is_inference_relevant[idx]) {
+                continue;
+            }
+            if (is_dualsparsity_active(wl)) {
+                to_cost.push_back(cloneDeactivateActSparsity(wl));
+                to_cost.push_back(cloneDeactivateWeightSParsity(wl));
+                infos.resize(to_cost.size());
+            } else {
+                to_cost.push_back(wl);
+                infos.push_back(problems[idx].info);
+            }
+        }
+
+        std::vector<std::string> cost_sources;
+        const auto costs{run_cost_providers(to_cost, infos, cost_sources)};
+
+        std::vector<CyclesInterfaceType> cycles_vector(number_of_workloads);
+        for (size_t idx = 0; idx < number_of_workloads; ++idx) {
+            DPUWorkload wl{workloads[idx]};
+            swizzling_turn_OFF(wl);
+            L1CostSerializationWrap serialization_handler(serializer);
+            serialization_handler.serializeInfoAndComputeWorkloadUid(wl);
+
+            std::string info{problems[idx].info};
+            std::string cost_source = "unknown";
+            CyclesInterfaceType cycles{problems[idx].value()};  // neutral value or reported problems at sanitization
+            if (is_inference_relevant[idx]) {
+                const size_t first{first_to_cost[idx]};
+                if (is_dualsparsity_active(sanitized[idx])) {
+                    cycles = dualsparsity_cost(costs[first], costs[first + 1]);
+                } else {
+                    cycles = costs[first];
+                    info = std::move(infos[first]);
+                    cost_source = std::move(cost_sources[first]);
+                }
+            }
+
+            serialization_handler.serializeCyclesAndCostInfo_closeLine(cycles, std::move(cost_source), info);
+            cycles_vector[idx] = cycles;
+        }
+        return cycles_vector;
+    }
+
+    /// @brief computes the cycles of a list of workloads: sanitization, NN inference and selection of the result
+    ///
+    /// @param workloads [in, out] the workloads, they are sanitized in place
+    /// @param cycles_out where to write the cycles, one for each workload, same order
+    void DPU_costs(std::vector<DPUWorkload>& workloads, CyclesInterfaceType* cycles_out) const {
+        const auto number_of_workloads{workloads.size()};
         const auto is_inference_posible = nn_initialized();
 
         /// @brief sanitization result element
@@ -727,15 +1107,24 @@ public:
                 }
             }
 
-            cycles_vector[idx] = cycles;
+            cycles_out[idx] = cycles;
         }
+    }
 
-        const std::string dpu_nickname{get_NN_cost_provider().get_model_nickname()};
-        L1CostSerializationWrap serialization_handler(serializer);
-        serialization_handler.serializeCyclesAndComputeWorkloadUid_closeLine(std::move(serializer_orig_wls),
-                                                                             cycles_vector, dpu_nickname);
-
-        return cycles_vector;
+    /// @brief how many workloads are evaluated together by one task of the batch pool.
+    /// Chunks are multiple of the NN batch size so that inference batches stay full.
+    /// @param number_of_workloads the size of the whole list
+    /// @returns the chunk size, number_of_workloads (or more) means no split, sequential evaluation
+    size_t batch_chunk_size(size_t number_of_workloads) const {
+        // the profiling service is not meant for concurrent requests
+        if (!batch_pool || is_profiling_service_enabled || number_of_workloads < 2 * min_workloads_per_batch_task) {
+            return number_of_workloads;
+        }
+        const size_t nn_batch{std::max<size_t>(1, dpu_nn_cost_provider.get_batch_size())};
+        const size_t tasks{batch_pool->workers_count() + 1};  // the calling thread also works
+        size_t chunk{std::max((number_of_workloads + tasks - 1) / tasks, min_workloads_per_batch_task)};
+        chunk = ((chunk + nn_batch - 1) / nn_batch) * nn_batch;
+        return chunk;
     }
 
 public:
@@ -139,16 +139,19 @@ public:
      * @param cache_size the size of the LRUCache
      * @param batch_size model batch size
      * @param cache_filename filename for cache persistence
+     * @param cache_shards number of independently locked parts of the LRUCache
      */
     explicit DMACostModel(const std::string& filename = "", bool profile = false, const unsigned int cache_size = 16384,
-                          const unsigned int batch_size = 1, const std::string& cache_filename = "")
+                          const unsigned int batch_size = 1, const std::string& cache_filename = "",
+                          const unsigned int cache_shards = DEFAULT_CACHE_SHARDS)
             : ptr_internal_dma_cost_provider(std::make_shared<PriorityDMACostProvider<DMADesc>>(
                   DMACostProviderBundles::createDefaultDMACostProviders<DMADesc>(filename, batch_size, profile))),
-              cache(cache_size, cache_filename) {
+              cache(cache_size, cache_filename, "", cache_shards) {
         Logger::initialize();
 
         // is_profiling_service_enabled = init_profiling_service();
         interogation_serializer.initialize(DescType::get_wl_name(), FileMode::READ_WRITE, DMANNCostProvider<DMADesc>::get_names_for_serializer());
+        load_warm_cache();
     }
     // VPUCostModel(const VPUCostModel&) = delete;
     // VPUCostModel(VPUCostModel&&) = default;
@@ -164,18 +167,54 @@ public:
      * @param batch_size model batch size
      * @param cache_data buffer containing cache data
      * @param cache_data_length size of cache data buffer
+     * @param cache_shards number of independently locked parts of the LRUCache
      */
     explicit DMACostModel(const char* model_data, size_t model_data_length, bool copy_model_data, bool profile = false,
                           const unsigned int cache_size = 16384, const unsigned int batch_size = 1,
-                          const char* cache_data = nullptr, size_t cache_data_length = 0)
+                          const char* cache_data = nullptr, size_t cache_data_length = 0,
+                          const unsigned int cache_shards = DEFAULT_CACHE_SHARDS)
             : ptr_internal_dma_cost_provider(std::make_shared<PriorityDMACostProvider<DMADesc>>(
                   DMACostProviderBundles::createDefaultDMACostProviders<DMADesc>(
                       model_data, model_data_length, batch_size, copy_model_data, profile))),
-              cache(cache_size, cache_data, cache_data_length) {
+              cache(cache_size, cache_data, cache_data_length, cache_shards) {
         Logger::initialize();
 
         // is_profiling_service_enabled = init_profiling_service();
         interogation_serializer.initialize(DescType::get_wl_name(), FileMode::READ_WRITE, DMANNCostProvider<DMADesc>::get_names_for_serializer());
+        load_warm_cache();
+    }
+
+    /**
+     * @brief saves the dynamic cache in a file, its content is merged in the preloaded cache by the next DMACostModel
+     * with the same model. Enabled by VPUNN_WARM_CACHE_DIR, @sa warm_cache_filename.
+     * Never done implicitly: to be called by the user at the end of a run, or periodically to survive an abnormal end.
+     *
+     * @returns false if enabled and the snapshot could not be written
+     */
+    bool save_warm_cache() const {
+        const std::string nickname{nn_model_nickname()};
+        const auto file{warm_cache_filename(nickname, warm_cache_name())};
+        return file.empty() || cache.save_snapshot(file, nickname);
+    }
+
+private:
+    /// @returns the nickname of the NN model that answers, empty if none is loaded
+    std::string nn_model_nickname() const {
+        auto priority_provider = std::dynamic_pointer_cast<const PriorityDMACostProvider<DMADesc>>(ptr_internal_dma_cost_provider);
+        return priority_provider ? priority_provider->get_nn_model_nickname() : std::string{};
+    }
+
+    static std::string warm_cache_name() {
+        return "dma_" + DescType::get_wl_name();
+    }
+
+    /// @brief merges in the preloaded cache the snapshot made by a previous run with the same model, if enabled
+    void load_warm_cache() {
+        const std::string nickname{nn_model_nickname()};
+        const auto file{warm_cache_filename(nickname, warm_cache_name())};
+        if (!file.empty()) {
+            cache.load_snapshot(file, nickname);
+        }
     }
 
 public:
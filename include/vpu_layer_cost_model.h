@@ -19,9 +19,11 @@
 
 #include "core/logger.h"
 #include "core/serializer.h"
+#include "core/thread_pool.h"
 #include "vpu/cycles_interface_types.h"
 #include "vpu/dpu_defaults.h"
 #include "vpu/layer.h"
+#include "vpu/optimization/intra_tile_split_memo.h"
 #include "vpu/optimization/workload_optimization.h"
 #include "vpu/performance.h"
 #include "vpu/types.h"
@@ -55,6 +57,13 @@ private:
     static constexpr unsigned int default_maxWorkloadsPerIntraTileSplit{128U};  ///< default max splits for a tile
     unsigned int maxWorkloadsPerIntraTileSplit{default_maxWorkloadsPerIntraTileSplit};  ///< max splits for a tile
 
+    /// workers for the evaluation of the tiling strategies of a layer, null if evaluated sequentially
+    std::unique_ptr<ThreadPool> strategy_pool;
+
+    static constexpr size_t default_intraTileSplitMemoSize{2048U};  ///< tile layers remembered by default
+    /// results of the intra-tile splits, an identical tile layer is not searched again
+    mutable IntraTileSplitMemo intra_tile_split_memo{default_intraTileSplitMemoSize};
+
     const DMACostModelVariant the_dma_cost_model{static_cast<DMACostModel<DMANNWorkload_NPU27>*>(
             nullptr)};  ///< Variant that holds a DMACostModel pointer (non const). External provider!
 
@@ -254,6 +263,31 @@ public:
     //////////////////////////// Constructors section END
 
 protected:
+    /**
+     * @brief intra-tile split of one tile layer, the result of an identical previous search is reused
+     * (not when serializing or using the profiling service)
+     *
+     * @param tiler the intra-tile tiler, working with this model's DPU cost provider
+     * @param tile_layer the layer of one tile
+     * @param options the options of the split
+     * @param all_splits [out] if not null, receives all the splits investigated
+     * @return DPUWorkloadsCost the best split
+     * @throws the exceptions of IDPUTiler::intraTileSplit, failed searches are not remembered
+     */
+    DPUWorkloadsCost memoized_intraTileSplit(const IDPUTiler& tiler, const DPULayer& tile_layer,
+                                             const SplitOptions& options,
+                                             std::vector<DPUWorkloadsWithCyclesSplit>* all_splits) const {
+        if (!allows_concurrent_layers()) {  // serialization wants every DPU call, profiling answers may change
+            return tiler.intraTileSplit(tile_layer, options, all_splits);
+        }
+        if (auto known = intra_tile_split_memo.get(tile_layer, options, all_splits)) {
+            return std::move(*known);
+        }
+        DPUWorkloadsCost best{tiler.intraTileSplit(tile_layer, options, all_splits)};
+        intra_tile_split_memo.add(tile_layer, options, best, all_splits);
+        return best;
+    }
+
     /// common code for initializing serializers
     void initialize_serializers() {
         // TODO: better move the serializers in a subobject that makes the init in its constructor
@@ -270,6 +304,32 @@ public:
         return maxWorkloadsPerIntraTileSplit;
     }
 
+    /**
+     * @brief how many threads evaluate the tiling strategies of a layer, in the Layer overload that has no strategy
+     * (including the calling thread). Not to be changed while a Layer evaluation is running.
+     *
+     * @param threads 0 or 1 means sequential evaluation
+     */
+    void set_strategy_threads(unsigned int threads) {
+        strategy_pool = (threads > 1) ? std::make_unique<ThreadPool>(threads - 1) : nullptr;
+    }
+
+    /// @returns how many threads evaluate the tiling strategies of a layer, 1 if sequential
+    unsigned int get_strategy_threads() const {
+        return strategy_pool ? static_cast<unsigned int>(strategy_pool->workers_count() + 1) : 1U;
+    }
+
+    /// @returns the number of tile layers whose intra-tile split result is remembered
+    size_t get_intraTileSplitMemo_size() const {
+        return intra_tile_split_memo.size();
+    }
+
+    /// @brief true if layers can be evaluated from several threads at the same time (no serialization, L1 allows it)
+    bool allows_concurrent_layers() const {
+        return !serializer.is_serialization_enabled() && !presplit_serializer.is_serialization_enabled() &&
+               get_cost_model().allows_concurrent_evaluation();
+    }
+
     /**
      * @brief Compute the optimal cost of a DPULayer given a strategy and context
      *
@@ -618,7 +678,8 @@ protected:
                 try {
                     // obtains the best DPU workloads split
                     std::vector<DPUWorkloadsWithCyclesSplit> splits;
-                    const DPUWorkloadsCost cost_and_workloads = tiler->intraTileSplit(one_tile_layer, options, &splits);
+                    const DPUWorkloadsCost cost_and_workloads = memoized_intraTileSplit(
+                            *tiler, one_tile_layer, options, detailed_split ? &splits : nullptr);
                     const auto cycles = cost_and_workloads.first;
                     tiles_cost.push_back(cycles);
 
@@ -810,8 +871,8 @@ protected:
                     // obtains the best DPU workloads split
                     std::vector<DPUWorkloadsWithCyclesSplit>
                             all_intra_tile_splits{};  ///< all intra tile splits generated. one pair() is a split
-                    const DPUWorkloadsCost cost_and_workloads = tiler->intraTileSplit(
-                            one_tile_layer, options, detailed_split ? &all_intra_tile_splits : nullptr);
+                    const DPUWorkloadsCost cost_and_workloads = memoized_intraTileSplit(
+                            *tiler, one_tile_layer, options, detailed_split ? &all_intra_tile_splits : nullptr);
                     const auto cycles = cost_and_workloads.first;
                     tiles_cost.push_back(cycles);
 
@@ -1069,12 +1130,21 @@ public:
         // Cost of a layer if executed in nTiles using nDPU/tile
         auto valid_strategies = getValidTilingStrategies(layer.device);
 
-        // The cost of all configurations
-        std::vector<CyclesInterfaceType> costs;
-
-        for (const auto& strategy : valid_strategies) {
-            auto configuration_cost = Layer(layer, strategy, nDPU, nTiles, input_in_ddr, output_in_ddr, prefetching);
-            costs.push_back(configuration_cost);
+        // The cost of all configurations, by strategy position
+        std::vector<CyclesInterfaceType> costs(valid_strategies.size());
+
+        if (strategy_pool && (valid_strategies.size() > 1) && allows_concurrent_layers()) {
+            // each strategy works on its own copy, the evaluation adjusts the layer (sanitization)
+            std::vector<DPULayer> layers(valid_strategies.size(), layer);
+            strategy_pool->parallel_for(valid_strategies.size(), [&](size_t i) {
+                costs[i] = Layer(layers[i], valid_strategies[i], nDPU, nTiles, input_in_ddr, output_in_ddr,
+                                 prefetching);
+            });
+            layer = std::move(layers.back());  // as adjusted by the last evaluation, like the sequential loop
+        } else {
+            for (size_t i = 0; i < valid_strategies.size(); ++i) {
+                costs[i] = Layer(layer, valid_strategies[i], nDPU, nTiles, input_in_ddr, output_in_ddr, prefetching);
+            }
         }
 
         // Return the configuration with min cost (the optimal one). Any good value will dominate any error code
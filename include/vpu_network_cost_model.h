@@ -10,6 +10,10 @@
 #ifndef VPUNN_NETWORK_COST_MODEL_H
 #define VPUNN_NETWORK_COST_MODEL_H
 
+#include <memory>
+#include <vector>
+
+#include "core/thread_pool.h"
 #include "vpu/graph.h"
 #include "vpu_layer_cost_model.h"
 
@@ -43,11 +47,47 @@ public:
 /**
  * @brief The VPUNN network cost model (also called VPUNN Level3 API)
  *
+ * The layers of a network are independent for costing (they share only the caches), so they can be evaluated in
+ * parallel, see set_network_threads. The total is always summed in topological order, same result as sequential.
  */
 class VPUNN_API VPUNetworkCostModel
         : public VPULayerCostModel,
           virtual protected VPU_MutexAcces  // for mutex access
 {
+private:
+    std::unique_ptr<ThreadPool> network_pool;  ///< workers for Network, null if layers are evaluated sequentially
+
+    /**
+     * @brief evaluates all layers of the dag, in parallel if possible, and sums them in topological order
+     *
+     * @param dag the network
+     * @param strategy_of callable giving the VPULayerStrategy& of a NodeId, must be safe to call concurrently
+     * @return the sum of the layers' cycles, or the first error in topological order
+     */
+    template <class StrategyOf>
+    unsigned long int sum_of_layers(const VPUComputationDAG& dag, StrategyOf&& strategy_of) {
+        const auto order{dag.topological_order()};
+        std::vector<unsigned int> layers_cycles(order.size());
+        const auto evaluate = [&](size_t i) {
+            const auto id{order.begin()[i]};
+            layers_cycles[i] = dag.node(id)->cycles(*this, strategy_of(id));
+        };
+
+        if (network_pool && allows_concurrent_layers()) {
+            network_pool->parallel_for(order.size(), evaluate);  // each free thread takes the next layer
+        } else {
+            for (size_t i = 0; i < order.size(); ++i) {
+                evaluate(i);
+            }
+        }
+
+        unsigned long int cost = 0;
+        for (const auto cycles : layers_cycles) {
+            cost = Cycles::cost_adder(cost, cycles);
+        }
+        return cost;
+    }
+
 public:
     /**
      * @brief Using the same VPULayerCostModel constructor
@@ -55,6 +95,23 @@ public:
      */
     using VPULayerCostModel::VPULayerCostModel;
 
+    /**
+     * @brief how many threads evaluate the layers of a network in Network (including the calling thread)
+     *
+     * Layers are evaluated sequentially anyway if serialization or the profiling service is enabled.
+     * Not to be changed while Network is running.
+     *
+     * @param threads 0 or 1 means sequential evaluation
+     */
+    void set_network_threads(unsigned int threads) {
+        network_pool = (threads > 1) ? std::make_unique<ThreadPool>(threads - 1) : nullptr;
+    }
+
+    /// @returns how many threads evaluate the layers of a network, 1 if sequential
+    unsigned int get_network_threads() const {
+        return network_pool ? static_cast<unsigned int>(network_pool->workers_count() + 1) : 1U;
+    }
+
     /**
      * @brief Compute the cost of executing a network with a specific per-layer strategy
      *
@@ -63,16 +120,37 @@ public:
      * @return unsigned long int
      */
     unsigned long int Network(VPUComputationDAG& dag, VPUNetworkStrategy& strategy) {
-        unsigned long int cost = 0;
-        for (auto layer : dag) {
+        // resolved up front: the strategy map is not safe for concurrent lookup
+        std::vector<VPULayerStrategy*> strategy_by_id(dag.nodes(), nullptr);
+        for (const auto id : dag.topological_order()) {
+            const auto& layer{dag.node(id)};
             if (strategy.exists(layer)) {
-                cost = Cycles::cost_adder(cost, layer->cycles(*this, strategy[layer]));
+                strategy_by_id[id] = &strategy[layer];
             } else {
                 throw_error<std::runtime_error>("Impossible to find a strategy for a layer");
             }
         }
 
-        return cost;
+        return sum_of_layers(dag, [&strategy_by_id](VPUComputationDAG::NodeId id) -> VPULayerStrategy& {
+            return *strategy_by_id[id];
+        });
+    }
+
+    /**
+     * @brief Compute the cost of executing a network with a per-layer strategy stored by node id
+     *
+     * @param dag a VPUComputationDAG representing the network to estimate
+     * @param strategy the strategy of each layer, indexed by VPUComputationDAG::NodeId, one for every node
+     * @return unsigned long int
+     */
+    unsigned long int Network(const VPUComputationDAG& dag, std::vector<VPULayerStrategy>& strategy) {
+        if (strategy.size() < dag.nodes()) {
+            throw_error<std::runtime_error>("Impossible to find a strategy for a layer");
+        }
+
+        return sum_of_layers(dag, [&strategy](VPUComputationDAG::NodeId id) -> VPULayerStrategy& {
+            return strategy[id];
+        });
     }
 };
 
@@ -46,22 +46,23 @@ private:
 
 public:
 
-    explicit SHAVECostModel(const std::string& cache_filename = "", const unsigned int cache_size = 16384, const bool use_shave_2_api = false)
+    explicit SHAVECostModel(const std::string& cache_filename = "", const unsigned int cache_size = 16384, const bool use_shave_2_api = false,
+                            const unsigned int cache_shards = DEFAULT_CACHE_SHARDS)
             : use_shave_2_api(use_shave_2_api),
               ptr_internal_shave_cost_provider(std::make_shared<PriorityShaveCostProvider>(use_shave_2_api ? 
                                                 ShaveCostProviderBundles::createDefaultShaveCostProviders() : 
                                                 ShaveCostProviderBundles::createOldShaveOnlyProviders())),
-              cache(cache_size, cache_filename) {
+              cache(cache_size, cache_filename, "", cache_shards) {
         serializer.initialize("shave_workloads", FileMode::READ_WRITE, ShaveSerializerUtils::get_names_for_shave_serializer(shave_cost_provider.get_max_num_params()));
     }
 
     explicit SHAVECostModel(const char* cache_data, size_t cache_data_length, const unsigned int cache_size = 16384, 
-                        bool use_shave_2_api = false)
+                        bool use_shave_2_api = false, const unsigned int cache_shards = DEFAULT_CACHE_SHARDS)
             : use_shave_2_api(use_shave_2_api),
               ptr_internal_shave_cost_provider(std::make_shared<PriorityShaveCostProvider>(use_shave_2_api ? 
                                                 ShaveCostProviderBundles::createDefaultShaveCostProviders() : 
                                                 ShaveCostProviderBundles::createOldShaveOnlyProviders())),
-              cache(cache_size, cache_data, cache_data_length) {
+              cache(cache_size, cache_data, cache_data_length, cache_shards) {
         serializer.initialize("shave_workloads", FileMode::READ_WRITE, ShaveSerializerUtils::get_names_for_shave_serializer(shave_cost_provider.get_max_num_params()));
     }
 
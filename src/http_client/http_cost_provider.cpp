@@ -1,15 +1,27 @@
 #include "http_client/http_cost_provider.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
 #include <iostream>
+#include <thread>
 
 nlohmann::json VPUNN::HTTPClient::sendJsonRequest(const nlohmann::json& request, const std::string& path) {
+    int status = 0;
+    return sendJsonRequest(request, path, status);
+}
+
+nlohmann::json VPUNN::HTTPClient::sendJsonRequest(const nlohmann::json& request, const std::string& path,
+                                                  int& status) {
+    status = 0;
     if (_debug) {
         std::cout << "[DEBUG] HTTPClient::sendJsonRequest - Sending request to path: " << path << std::endl;
-        std::cout << "[DEBUG] HTTPClient::sendJsonRequest - Request payload: " << request.dump(2) << std::endl;
+        std::cout << "[DEBUG] HTTPClient::sendJsonRequest - Request payload: " << request.dump() << std::endl;
     }
     
     try {
         auto res = _client.Post(path, request.dump(), "application/json");
         if (res) {
+            status = res->status;
             if (_debug) {
                 std::cout << "[DEBUG] HTTPClient::sendJsonRequest - Response received, status: " << res->status << std::endl;
                 std::cout << "[DEBUG] HTTPClient::sendJsonRequest - Response body: " << res->body << std::endl;
@@ -62,7 +74,10 @@ bool VPUNN::HTTPProfilingClient::is_available(const std::string& check_backend)
                 return true;
             } else {
                 if (check_backend == "silicon") {
-                    bool silicon_available = res["profiling"].get<std::string>() == "true";
+                    // the service tells it as a bool, older ones as the string "true"
+                    const nlohmann::json profiling = res.contains("profiling") ? res["profiling"] : nlohmann::json();
+                    const bool silicon_available = (profiling.is_boolean() && profiling.get<bool>()) ||
+                                                   (profiling.is_string() && profiling.get<std::string>() == "true");
                     if (_debug) {
                         std::cout << "[DEBUG] HTTPProfilingClient::is_available - Silicon backend available: " 
                                   << (silicon_available ? "true" : "false") << std::endl;
@@ -88,7 +103,7 @@ bool VPUNN::HTTPProfilingClient::is_available(const std::string& check_backend)
 VPUNN::ProfilerResponse VPUNN::HTTPProfilingClient::handle_profiler_response(const nlohmann::json& response) {
     if (_debug) {
         std::cout << "[DEBUG] HTTPProfilingClient::handle_profiler_response - Processing response" << std::endl;
-        std::cout << "[DEBUG] HTTPProfilingClient::handle_profiler_response - Response: " << response.dump(2) << std::endl;
+        std::cout << "[DEBUG] HTTPProfilingClient::handle_profiler_response - Response: " << response.dump() << std::endl;
     }
     
     ProfilerResponse profiler_response;
@@ -195,22 +210,51 @@ VPUNN::CyclesInterfaceType VPUNN::HttpDPUCostProvider::getCost(const DPUOperatio
         std::cout << "[DEBUG] HttpDPUCostProvider::getCost - Backend: " << backend << std::endl;
         std::cout << "[DEBUG] HttpDPUCostProvider::getCost - Workload UID: " << op.hash() << std::endl;
     }
-    
-    nlohmann::json payload;
 
-    payload["params"] = nlohmann::json::object();
-    payload["params"]["backend"] = backend;
+    const nlohmann::json op_json = dpuop_as_json(op);
+
+    {
+        std::lock_guard<std::mutex> lock(_prefetched_mtx);
+        if (!_prefetched.empty()) {
+            const auto it = _prefetched.find(prefetch_key(op_json, backend));
+            if (it != _prefetched.end()) {
+                if (_debug) {
+                    std::cout << "[DEBUG] HttpDPUCostProvider::getCost - Prefetched cost: " << it->second.cycles
+                              << std::endl;
+                }
+                info = it->second.info;
+                return it->second.cycles;
+            }
+        }
+    }
+
+    return request_cost(_client, op_json, info, backend);
+}
+
+nlohmann::json VPUNN::HttpDPUCostProvider::profiling_params(const std::string& backend) {
+    nlohmann::json params = nlohmann::json::object();
+    params["backend"] = backend;
 
-    payload["params"]["name"] = "profiling_request";
-    payload["params"]["timeout"] = -1;  // Need to wait for the profiling to finish
+    params["name"] = "profiling_request";
+    params["timeout"] = -1;  // Need to wait for the profiling to finish
+    return params;
+}
 
-    payload["dpu_workload"] = nlohmann::json::object();
-    payload["dpu_workload"] = dpuop_as_json(op);
+VPUNN::CyclesInterfaceType VPUNN::HttpDPUCostProvider::request_cost(HTTPProfilingClient& client,
+                                                                    const nlohmann::json& op_json, std::string& info,
+                                                                    const std::string& backend) {
+    nlohmann::json payload;
 
-    nlohmann::json response = _client.sendJsonRequest(payload, "/generate_workload");
+    payload["params"] = profiling_params(backend);
+    payload["dpu_workload"] = op_json;
 
-    auto parsed_res = _client.handle_profiler_response(response);
+    nlohmann::json response = client.sendJsonRequest(payload, single_path);
 
+    return cost_of(client.handle_profiler_response(response), info);
+}
+
+VPUNN::CyclesInterfaceType VPUNN::HttpDPUCostProvider::cost_of(const ProfilerResponse& parsed_res,
+                                                               std::string& info) const {
     CyclesInterfaceType cycles = Cycles::ERROR_PROFILING_SERVICE;
     info = parsed_res.message;
 
@@ -236,6 +280,162 @@ VPUNN::CyclesInterfaceType VPUNN::HttpDPUCostProvider::getCost(const DPUOperatio
     return cycles;
 }
 
+std::vector<VPUNN::HttpDPUCostProvider::CostResult> VPUNN::HttpDPUCostProvider::getCosts(
+        const std::vector<const DPUOperation*>& ops, const std::string& backend) {
+    std::vector<nlohmann::json> ops_json;
+    ops_json.reserve(ops.size());
+    for (const DPUOperation* op : ops) {
+        ops_json.push_back(dpuop_as_json(*op));
+    }
+    return request_costs(ops_json, backend);
+}
+
+std::vector<VPUNN::HttpDPUCostProvider::CostResult> VPUNN::HttpDPUCostProvider::request_costs(
+        const std::vector<nlohmann::json>& ops_json, const std::string& backend) {
+    std::vector<CostResult> results(ops_json.size());
+    if (ops_json.empty()) {
+        return results;
+    }
+    if (_debug) {
+        std::cout << "[DEBUG] HttpDPUCostProvider::getCosts - Getting cost for " << ops_json.size()
+                  << " DPU operations, backend: " << backend << std::endl;
+    }
+
+    const size_t max_connections = std::max<size_t>(1, _batch_options.max_in_flight);
+    while (_batch_clients.size() < max_connections) {
+        _batch_clients.push_back(std::make_unique<HTTPProfilingClient>(_host, _port));
+        _batch_clients.back()->setDebug(_debug);
+    }
+
+    // runs units_count units of work on up to max_connections threads (the calling one included), each thread
+    // with its own connection. After an exception no unit is started, the first one is rethrown at the end.
+    const auto on_connections = [&](const size_t units_count, const auto& work) {
+        std::atomic<size_t> next_unit{0};
+        std::atomic<bool> failed{false};
+        std::exception_ptr first_error;
+        std::mutex error_mtx;
+        const auto worker = [&](HTTPProfilingClient& client) {
+            for (size_t unit = next_unit++; (unit < units_count) && !failed; unit = next_unit++) {
+                try {
+                    work(client, unit);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(error_mtx);
+                    if (!first_error) {
+                        first_error = std::current_exception();
+                    }
+                    failed = true;
+                }
+            }
+        };
+        std::vector<std::thread> threads;
+        const size_t connections = std::min(max_connections, units_count);
+        for (size_t c = 1; c < connections; ++c) {
+            threads.emplace_back(worker, std::ref(*_batch_clients[c]));
+        }
+        worker(*_batch_clients[0]);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        if (first_error) {
+            std::rethrow_exception(first_error);
+        }
+    };
+
+    std::vector<char> done(ops_json.size(), 0);
+    if (_batch_endpoint_available) {
+        const size_t batch_size = std::max<size_t>(1, _batch_options.max_batch_size);
+        const size_t batches_count = (ops_json.size() + batch_size - 1) / batch_size;
+        std::atomic<bool> batch_failed{false};
+        std::atomic<bool> batch_not_supported{false};
+        on_connections(batches_count, [&](HTTPProfilingClient& client, const size_t batch) {
+            if (batch_failed) {
+                return;
+            }
+            const size_t first = batch * batch_size;
+            const size_t last = std::min(first + batch_size, ops_json.size());
+            int status = 0;
+            try {
+                nlohmann::json payload;
+                payload["params"] = profiling_params(backend);
+                payload["dpu_workloads"] = nlohmann::json::array();
+                for (size_t idx = first; idx < last; ++idx) {
+                    payload["dpu_workloads"].push_back(ops_json[idx]);
+                }
+
+                const nlohmann::json response = client.sendJsonRequest(payload, batch_path, status);
+                if (!response.contains("results") || !response["results"].is_array() ||
+                    response["results"].size() != (last - first)) {
+                    batch_failed = true;  // not a batch answer
+                    return;
+                }
+                for (size_t idx = first; idx < last; ++idx) {
+                    const auto parsed = client.handle_profiler_response(response["results"][idx - first]);
+                    results[idx].cycles = cost_of(parsed, results[idx].info);
+                    done[idx] = 1;
+                }
+            } catch (const std::exception& e) {
+                if (_debug) {
+                    std::cout << "[DEBUG] HttpDPUCostProvider::getCosts - Batch request failed: " << e.what()
+                              << std::endl;
+                }
+                if ((status == 404) || (status == 405)) {  // the service has no batch endpoint
+                    batch_not_supported = true;
+                }
+                batch_failed = true;
+            }
+        });
+        if (batch_not_supported) {
+            _batch_endpoint_available = false;  // other failures can be temporary, the next call tries again
+        }
+    }
+
+    std::vector<size_t> remaining;
+    for (size_t idx = 0; idx < ops_json.size(); ++idx) {
+        if (!done[idx]) {
+            remaining.push_back(idx);
+        }
+    }
+    on_connections(remaining.size(), [&](HTTPProfilingClient& client, const size_t unit) {
+        const size_t idx = remaining[unit];
+        results[idx].cycles = request_cost(client, ops_json[idx], results[idx].info, backend);
+    });
+
+    return results;
+}
+
+void VPUNN::HttpDPUCostProvider::prefetchCosts(const std::vector<const DPUOperation*>& ops,
+                                               const std::string& backend) {
+    // the same operation is asked once
+    std::unordered_map<std::string, size_t> position_of_key;
+    std::vector<std::string> keys;
+    std::vector<nlohmann::json> distinct_ops_json;
+    for (const DPUOperation* op : ops) {
+        nlohmann::json op_json = dpuop_as_json(*op);
+        std::string key = prefetch_key(op_json, backend);
+        if (position_of_key.emplace(key, distinct_ops_json.size()).second) {
+            keys.push_back(std::move(key));
+            distinct_ops_json.push_back(std::move(op_json));
+        }
+    }
+
+    std::vector<CostResult> results;
+    try {
+        results = request_costs(distinct_ops_json, backend);
+    } catch (const std::exception& e) {
+        if (_debug) {
+            std::cout << "[DEBUG] HttpDPUCostProvider::prefetchCosts - Failed: " << e.what() << std::endl;
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_prefetched_mtx);
+    for (size_t idx = 0; idx < results.size(); ++idx) {
+        if (!Cycles::isErrorCode(results[idx].cycles)) {  // an error is asked again by getCost
+            _prefetched[std::move(keys[idx])] = std::move(results[idx]);
+        }
+    }
+}
+
 const nlohmann::json VPUNN::HttpDPUCostProvider::dpuop_as_json(const DPUOperation& op) {
     if (_debug) {
         std::cout << "[DEBUG] HttpDPUCostProvider::dpuop_as_json - Converting DPUOperation to JSON" << std::endl;
@@ -9,6 +9,9 @@
 
 #include "inference/inference_execution_data.h"
 
+#include <functional>
+#include <numeric>
+
 #include "vpunn_generated.h"  //for flabuffer model
 
 // #include "inference/model.h"
@@ -35,6 +38,19 @@ void InferenceExecutionData::allocate_tensorsMapAndBias(const unsigned int batch
 
         const auto tensor_shape{parse_vector(flatbuffer_tensor->shape(), forced_batch)};
 
+        if (buffer_is_present) {
+            // constant data (weights), is read only and shared by all execution data of this model: the tensor is a
+            // view over the flatbuffer data when possible, no copy
+            const auto array = buffers->Get(buffer_ID)->data();
+            const float* weights{reinterpret_cast<const float*>(array->data())};
+            const size_t expected_bytes{sizeof(float) * std::accumulate(tensor_shape.cbegin(), tensor_shape.cend(),
+                                                                        size_t{1}, std::multiplies<size_t>())};
+            if (Tensor<float>::can_view(weights) && (array->size() == expected_bytes)) {
+                tensor_map.emplace_back(Tensor<float>::view(weights, tensor_shape));
+                continue;
+            }
+        }
+
         {                                        // Create/Fill the new tensor structure
             Tensor<float> tensor{tensor_shape};  // allocates on heap!
             if (buffer_is_present) {  // in this case, copy the existing data(the buffer) into tensor's memory
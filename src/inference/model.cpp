@@ -81,7 +81,10 @@ void InferenceModel::run_layer(const VPUNN_SCHEMA::Layer* layer, const std::vect
     switch (layer->implementation_type()) {
     case VPUNN_SCHEMA::LayerType_FullyConnectedLayer:
         // inputs: activations, weights, bias
-        Dense(inputs[1], inputs[0], outputs[0]);
+        // one NN descriptor is mostly zeros (one-hot fields), skipping them is faster than the sgemm
+        if (!DenseSparseInput(inputs[1], inputs[0], outputs[0])) {
+            Dense(inputs[1], inputs[0], outputs[0]);
+        }
 
         if (inputs.size() > 2) {
             BiasOp::Bias(inputs[2], outputs[0], biasBuf);
@@ -9,6 +9,7 @@
 
 #include <math.h>
 #include "kernels/vpunn_blas.h"
+#include "sgemm_kernels.h"
 
 #include <stdint.h>
 #include <algorithm>  // for std::min
@@ -22,7 +23,12 @@ inline bool is_aligned(const float* p) {
 #define USE_SIMD
 #endif
 
-#ifdef USE_SIMD
+// runtime selection of AVX2/AVX-512 kernels is possible only with GCC/Clang on x86
+#if defined(VPUNN_BLAS_RUNTIME_DISPATCH) && !(defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)))
+#undef VPUNN_BLAS_RUNTIME_DISPATCH
+#endif
+
+#if defined(USE_SIMD) || defined(VPUNN_BLAS_RUNTIME_DISPATCH)
 #include <immintrin.h>
 #endif
 
@@ -110,13 +116,362 @@ void inline cblas_sgemm_rm_ntt_10(const int M, const int N, const int K, const f
     }
 }
 
-// todo: check if compiler can optimize better if helped.
-void cblas_sgemm(const CBLAS_LAYOUT layout, const CBLAS_TRANSPOSE TransA, const CBLAS_TRANSPOSE TransB, const int M,
-                 const int N, const int K, const float alpha, const float* A, const int lda, const float* B,
-                 const int ldb, const float beta, float* C, const int ldc) {
-    if (layout == CblasRowMajor && TransA == CblasNoTrans && TransB == CblasTrans && alpha == 1 && beta == 0) {
+// C <- alpha A * B + beta C, RowMajor, NoTrans, NoTrans (bias shape). Inner loop is contiguous in B and C
+inline void sgemm_rm_nn_body(const int M, const int N, const int K, const float alpha, const float* A, const int lda,
+                             const float* B, const int ldb, const float beta, float* C, const int ldc) {
+    for (int i = 0; i < M; ++i) {
+        float* c_row = C + i * ldc;
+        for (int j = 0; j < N; ++j) {
+            c_row[j] = (beta == 0) ? 0.0F : c_row[j] * beta;  // with beta zero C is not read
+        }
+        for (int k = 0; k < K; ++k) {
+            const float a = alpha * A[i * lda + k];
+            const float* b_row = B + k * ldb;
+            for (int j = 0; j < N; ++j) {
+                c_row[j] += a * b_row[j];
+            }
+        }
+    }
+}
+
+// C <- alpha A * B' + beta C, ColMajor, NoTrans, Trans (kNN shape). Inner loop is contiguous in B
+inline void sgemm_cm_nt_body(const int M, const int N, const int K, const float alpha, const float* A, const int lda,
+                             const float* B, const int ldb, const float beta, float* C, const int ldc) {
+    for (int i = 0; i < M; ++i) {
+        for (int j = 0; j < N; ++j) {
+            C[i + j * ldc] = (beta == 0) ? 0.0F : C[i + j * ldc] * beta;  // with beta zero C is not read
+        }
+        for (int k = 0; k < K; ++k) {
+            const float a = alpha * A[i + k * lda];
+            const float* b_col = B + k * ldb;
+            for (int j = 0; j < N; ++j) {
+                C[i + j * ldc] += a * b_col[j];
+            }
+        }
+    }
+}
+
+typedef void (*sgemm_rm_ntt_10_kernel)(const int M, const int N, const int K, const float* A, const int lda,
+                                       const float* B, const int ldb, float* C, const int ldc);
+typedef void (*sgemm_general_kernel)(const int M, const int N, const int K, const float alpha, const float* A,
+                                     const int lda, const float* B, const int ldb, const float beta, float* C,
+                                     const int ldc);
+
+#ifdef VPUNN_BLAS_RUNTIME_DISPATCH
+// AVX2/FMA and AVX-512 kernels, compiled for their instruction set only and selected at runtime (CPUID), so the
+// library still runs on any x86 CPU
+
+__attribute__((target("avx2,fma"))) static inline float hsum_avx2(__m256 v) {
+    const __m128 sum4 = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    const __m128 sum2 = _mm_add_ps(sum4, _mm_movehl_ps(sum4, sum4));
+    const __m128 sum1 = _mm_add_ss(sum2, _mm_shuffle_ps(sum2, sum2, 0x1));
+    return _mm_cvtss_f32(sum1);
+}
+
+// each A row is multiplied with 4 B rows at a time, the A values are loaded once for the 4 dot products
+__attribute__((target("avx2,fma"))) static void sgemm_rm_ntt_10_avx2(const int M, const int N, const int K,
+                                                                      const float* A, const int lda, const float* B,
+                                                                      const int ldb, float* C, const int ldc) {
+    constexpr int width = 8;
+    const int K_vec = K - K % width;
+    for (int j = 0; j < M; ++j) {
+        const float* a = A + j * lda;
+        int i = 0;
+        for (; i + 4 <= N; i += 4) {
+            const float* b0 = B + i * ldb;
+            const float* b1 = b0 + ldb;
+            const float* b2 = b1 + ldb;
+            const float* b3 = b2 + ldb;
+            __m256 acc0 = _mm256_setzero_ps();
+            __m256 acc1 = _mm256_setzero_ps();
+            __m256 acc2 = _mm256_setzero_ps();
+            __m256 acc3 = _mm256_setzero_ps();
+            for (int k = 0; k < K_vec; k += width) {
+                const __m256 av = _mm256_loadu_ps(a + k);
+                acc0 = _mm256_fmadd_ps(av, _mm256_loadu_ps(b0 + k), acc0);
+                acc1 = _mm256_fmadd_ps(av, _mm256_loadu_ps(b1 + k), acc1);
+                acc2 = _mm256_fmadd_ps(av, _mm256_loadu_ps(b2 + k), acc2);
+                acc3 = _mm256_fmadd_ps(av, _mm256_loadu_ps(b3 + k), acc3);
+            }
+            float r0 = hsum_avx2(acc0), r1 = hsum_avx2(acc1), r2 = hsum_avx2(acc2), r3 = hsum_avx2(acc3);
+            for (int k = K_vec; k < K; ++k) {
+                r0 += a[k] * b0[k];
+                r1 += a[k] * b1[k];
+                r2 += a[k] * b2[k];
+                r3 += a[k] * b3[k];
+            }
+            float* c = C + j * ldc + i;
+            c[0] = r0;
+            c[1] = r1;
+            c[2] = r2;
+            c[3] = r3;
+        }
+        for (; i < N; ++i) {  // remaining B rows, one at a time
+            const float* b = B + i * ldb;
+            __m256 acc = _mm256_setzero_ps();
+            for (int k = 0; k < K_vec; k += width) {
+                acc = _mm256_fmadd_ps(_mm256_loadu_ps(a + k), _mm256_loadu_ps(b + k), acc);
+            }
+            float r = hsum_avx2(acc);
+            for (int k = K_vec; k < K; ++k) {
+                r += a[k] * b[k];
+            }
+            C[j * ldc + i] = r;
+        }
+    }
+}
+
+// spelled out instead of _mm512_reduce_add_ps, GCC implements it and the unmasked shuffle/extract intrinsics with
+// undefined vectors, which trips -Wmaybe-uninitialized: the zero masked forms are used, all lanes selected
+__attribute__((target("avx512f"))) static inline float hsum_avx512(const __m512 v) {
+    constexpr __mmask16 all = 0xFFFF;
+    const __m512 sum8 = _mm512_add_ps(v, _mm512_maskz_shuffle_f32x4(all, v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+    const __m512 sum4 = _mm512_add_ps(sum8, _mm512_maskz_shuffle_f32x4(all, sum8, sum8, _MM_SHUFFLE(2, 3, 0, 1)));
+    const __m128 low = _mm512_maskz_extractf32x4_ps(0xF, sum4, 0);
+    const __m128 sum2 = _mm_add_ps(low, _mm_movehl_ps(low, low));
+    return _mm_cvtss_f32(_mm_add_ss(sum2, _mm_shuffle_ps(sum2, sum2, 0x1)));
+}
+
+// one A row times 4 B rows at a time, the K tail is handled with masked loads
+__attribute__((target("avx512f"))) static void sgemm_rm_ntt_10_avx512_1row(const int N, const int K, const float* a,
+                                                                            const float* B, const int ldb, float* c) {
+    constexpr int width = 16;
+    const int K_vec = K - K % width;
+    const __mmask16 tail = static_cast<__mmask16>((1u << (K % width)) - 1u);
+    const __m512 a_tail = _mm512_maskz_loadu_ps(tail, a + K_vec);
+    int i = 0;
+    for (; i + 4 <= N; i += 4) {
+        const float* b0 = B + i * ldb;
+        const float* b1 = b0 + ldb;
+        const float* b2 = b1 + ldb;
+        const float* b3 = b2 + ldb;
+        __m512 acc0 = _mm512_setzero_ps();
+        __m512 acc1 = _mm512_setzero_ps();
+        __m512 acc2 = _mm512_setzero_ps();
+        __m512 acc3 = _mm512_setzero_ps();
+        for (int k = 0; k < K_vec; k += width) {
+            const __m512 av = _mm512_loadu_ps(a + k);
+            acc0 = _mm512_fmadd_ps(av, _mm512_loadu_ps(b0 + k), acc0);
+            acc1 = _mm512_fmadd_ps(av, _mm512_loadu_ps(b1 + k), acc1);
+            acc2 = _mm512_fmadd_ps(av, _mm512_loadu_ps(b2 + k), acc2);
+            acc3 = _mm512_fmadd_ps(av, _mm512_loadu_ps(b3 + k), acc3);
+        }
+        acc0 = _mm512_fmadd_ps(a_tail, _mm512_maskz_loadu_ps(tail, b0 + K_vec), acc0);
+        acc1 = _mm512_fmadd_ps(a_tail, _mm512_maskz_loadu_ps(tail, b1 + K_vec), acc1);
+        acc2 = _mm512_fmadd_ps(a_tail, _mm512_maskz_loadu_ps(tail, b2 + K_vec), acc2);
+        acc3 = _mm512_fmadd_ps(a_tail, _mm512_maskz_loadu_ps(tail, b3 + K_vec), acc3);
+        c[i] = hsum_avx512(acc0);
+        c[i + 1] = hsum_avx512(acc1);
+        c[i + 2] = hsum_avx512(acc2);
+        c[i + 3] = hsum_avx512(acc3);
+    }
+    for (; i < N; ++i) {  // remaining B rows, one at a time
+        const float* b = B + i * ldb;
+        __m512 acc = _mm512_setzero_ps();
+        for (int k = 0; k < K_vec; k += width) {
+            acc = _mm512_fmadd_ps(_mm512_loadu_ps(a + k), _mm512_loadu_ps(b + k), acc);
+        }
+        acc = _mm512_fmadd_ps(a_tail, _mm512_maskz_loadu_ps(tail, b + K_vec), acc);
+        c[i] = hsum_avx512(acc);
+    }
+}
+
+// blocks of 2 A rows times 4 B rows, 8 accumulators held in registers: each loaded A vector feeds 4 FMAs and each B
+// vector 2. A last odd A row is done alone. The K tail is handled with masked loads
+__attribute__((target("avx512f"))) static void sgemm_rm_ntt_10_avx512(const int M, const int N, const int K,
+                                                                       const float* A, const int lda, const float* B,
+                                                                       const int ldb, float* C, const int ldc) {
+    constexpr int width = 16;
+    const int K_vec = K - K % width;
+    const __mmask16 tail = static_cast<__mmask16>((1u << (K % width)) - 1u);
+    int j = 0;
+    for (; j + 2 <= M; j += 2) {
+        const float* a0 = A + j * lda;
+        const float* a1 = a0 + lda;
+        const __m512 a0_tail = _mm512_maskz_loadu_ps(tail, a0 + K_vec);
+        const __m512 a1_tail = _mm512_maskz_loadu_ps(tail, a1 + K_vec);
+        float* c0 = C + j * ldc;
+        float* c1 = c0 + ldc;
+        int i = 0;
+        for (; i + 4 <= N; i += 4) {
+            const float* b0 = B + i * ldb;
+            const float* b1 = b0 + ldb;
+            const float* b2 = b1 + ldb;
+            const float* b3 = b2 + ldb;
+            __m512 acc00 = _mm512_setzero_ps(), acc01 = _mm512_setzero_ps();
+            __m512 acc02 = _mm512_setzero_ps(), acc03 = _mm512_setzero_ps();
+            __m512 acc10 = _mm512_setzero_ps(), acc11 = _mm512_setzero_ps();
+            __m512 acc12 = _mm512_setzero_ps(), acc13 = _mm512_setzero_ps();
+            auto block = [&](const __m512 av0, const __m512 av1, const __m512 bv0, const __m512 bv1, const __m512 bv2,
+                             const __m512 bv3) __attribute__((target("avx512f"))) {
+                acc00 = _mm512_fmadd_ps(av0, bv0, acc00);
+                acc01 = _mm512_fmadd_ps(av0, bv1, acc01);
+                acc02 = _mm512_fmadd_ps(av0, bv2, acc02);
+                acc03 = _mm512_fmadd_ps(av0, bv3, acc03);
+                acc10 = _mm512_fmadd_ps(av1, bv0, acc10);
+                acc11 = _mm512_fmadd_ps(av1, bv1, acc11);
+                acc12 = _mm512_fmadd_ps(av1, bv2, acc12);
+                acc13 = _mm512_fmadd_ps(av1, bv3, acc13);
+            };
+            for (int k = 0; k < K_vec; k += width) {
+                block(_mm512_loadu_ps(a0 + k), _mm512_loadu_ps(a1 + k), _mm512_loadu_ps(b0 + k),
+                      _mm512_loadu_ps(b1 + k), _mm512_loadu_ps(b2 + k), _mm512_loadu_ps(b3 + k));
+            }
+            block(a0_tail, a1_tail, _mm512_maskz_loadu_ps(tail, b0 + K_vec), _mm512_maskz_loadu_ps(tail, b1 + K_vec),
+                  _mm512_maskz_loadu_ps(tail, b2 + K_vec), _mm512_maskz_loadu_ps(tail, b3 + K_vec));
+            c0[i] = hsum_avx512(acc00);
+            c0[i + 1] = hsum_avx512(acc01);
+            c0[i + 2] = hsum_avx512(acc02);
+            c0[i + 3] = hsum_avx512(acc03);
+            c1[i] = hsum_avx512(acc10);
+            c1[i + 1] = hsum_avx512(acc11);
+            c1[i + 2] = hsum_avx512(acc12);
+            c1[i + 3] = hsum_avx512(acc13);
+        }
+        for (; i < N; ++i) {  // remaining B rows, one at a time
+            const float* b = B + i * ldb;
+            __m512 acc0 = _mm512_setzero_ps();
+            __m512 acc1 = _mm512_setzero_ps();
+            for (int k = 0; k < K_vec; k += width) {
+                const __m512 bv = _mm512_loadu_ps(b + k);
+                acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(a0 + k), bv, acc0);
+                acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(a1 + k), bv, acc1);
+            }
+            const __m512 b_tail = _mm512_maskz_loadu_ps(tail, b + K_vec);
+            c0[i] = hsum_avx512(_mm512_fmadd_ps(a0_tail, b_tail, acc0));
+            c1[i] = hsum_avx512(_mm512_fmadd_ps(a1_tail, b_tail, acc1));
+        }
+    }
+    if (j < M) {
+        sgemm_rm_ntt_10_avx512_1row(N, K, A + j * lda, B, ldb, C + j * ldc);
+    }
+}
+
+// the general bodies compiled for AVX-512, vectorized by the compiler
+__attribute__((target("avx512f"))) static void sgemm_rm_nn_avx512(const int M, const int N, const int K,
+                                                                   const float alpha, const float* A, const int lda,
+                                                                   const float* B, const int ldb, const float beta,
+                                                                   float* C, const int ldc) {
+    sgemm_rm_nn_body(M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
+}
+
+__attribute__((target("avx512f"))) static void sgemm_cm_nt_avx512(const int M, const int N, const int K,
+                                                                   const float alpha, const float* A, const int lda,
+                                                                   const float* B, const int ldb, const float beta,
+                                                                   float* C, const int ldc) {
+    sgemm_cm_nt_body(M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
+}
+
+// the general bodies are vectorized by the compiler for the target instruction set
+__attribute__((target("avx2,fma"))) static void sgemm_rm_nn_avx2(const int M, const int N, const int K,
+                                                                  const float alpha, const float* A, const int lda,
+                                                                  const float* B, const int ldb, const float beta,
+                                                                  float* C, const int ldc) {
+    sgemm_rm_nn_body(M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
+}
+
+__attribute__((target("avx2,fma"))) static void sgemm_cm_nt_avx2(const int M, const int N, const int K,
+                                                                  const float alpha, const float* A, const int lda,
+                                                                  const float* B, const int ldb, const float beta,
+                                                                  float* C, const int ldc) {
+    sgemm_cm_nt_body(M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
+}
+
+inline bool cpu_has_avx512() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx512f");
+}
+
+inline bool cpu_has_avx2_fma() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+}
+#endif  // VPUNN_BLAS_RUNTIME_DISPATCH
+
+static void sgemm_rm_ntt_10_default(const int M, const int N, const int K, const float* A, const int lda,
+                                    const float* B, const int ldb, float* C, const int ldc) {
+    cblas_sgemm_rm_ntt_10(M, N, K, A, lda, B, ldb, C, ldc);
+}
+
+static void sgemm_rm_nn_default(const int M, const int N, const int K, const float alpha, const float* A,
+                                const int lda, const float* B, const int ldb, const float beta, float* C,
+                                const int ldc) {
+    sgemm_rm_nn_body(M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
+}
+
+static void sgemm_cm_nt_default(const int M, const int N, const int K, const float alpha, const float* A,
+                                const int lda, const float* B, const int ldb, const float beta, float* C,
+                                const int ldc) {
+    sgemm_cm_nt_body(M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
+}
+
+// the kernels used by cblas_sgemm for its optimized cases, null for the naive implementation
+struct SgemmKernels {
+    sgemm_rm_ntt_10_kernel rm_ntt_10;
+    sgemm_general_kernel rm_nn;
+    sgemm_general_kernel cm_nt;
+};
+
+bool vpunn_sgemm_kernels_supported(const VPUNN_SGEMM_KERNELS kernels) {
+    switch (kernels) {
+    case VpunnSgemmNaive:
+    case VpunnSgemmDefault:
+        return true;
+#ifdef VPUNN_BLAS_RUNTIME_DISPATCH
+    case VpunnSgemmAVX2:
+        return cpu_has_avx2_fma();
+    case VpunnSgemmAVX512:
+        return cpu_has_avx512();
+#endif
+    default:
+        return false;
+    }
+}
+
+static SgemmKernels sgemm_kernels_of(const VPUNN_SGEMM_KERNELS kernels) {
+    switch (kernels) {
+#ifdef VPUNN_BLAS_RUNTIME_DISPATCH
+    case VpunnSgemmAVX512:
+        return {sgemm_rm_ntt_10_avx512, sgemm_rm_nn_avx512, sgemm_cm_nt_avx512};
+    case VpunnSgemmAVX2:
+        return {sgemm_rm_ntt_10_avx2, sgemm_rm_nn_avx2, sgemm_cm_nt_avx2};
+#endif
+    case VpunnSgemmDefault:
+        return {sgemm_rm_ntt_10_default, sgemm_rm_nn_default, sgemm_cm_nt_default};
+    default:
+        return {nullptr, nullptr, nullptr};
+    }
+}
+
+// best kernels for the running CPU, selected once
+static const SgemmKernels& best_sgemm_kernels() {
+    static const SgemmKernels best{[]() {
+        for (const auto kernels : {VpunnSgemmAVX512, VpunnSgemmAVX2}) {
+            if (vpunn_sgemm_kernels_supported(kernels)) {
+                return sgemm_kernels_of(kernels);
+            }
+        }
+        return sgemm_kernels_of(VpunnSgemmDefault);
+    }()};
+    return best;
+}
+
+static void sgemm_with(const SgemmKernels& kernels, const CBLAS_LAYOUT layout, const CBLAS_TRANSPOSE TransA,
+                       const CBLAS_TRANSPOSE TransB, const int M, const int N, const int K, const float alpha,
+                       const float* A, const int lda, const float* B, const int ldb, const float beta, float* C,
+                       const int ldc) {
+    if (kernels.rm_ntt_10 && layout == CblasRowMajor && TransA == CblasNoTrans && TransB == CblasTrans && alpha == 1 &&
+        beta == 0) {
         // Highly optimized GEMM for our specific use case
-        cblas_sgemm_rm_ntt_10(M, N, K, A, lda, B, ldb, C, ldc);
+        kernels.rm_ntt_10(M, N, K, A, lda, B, ldb, C, ldc);
+        return;
+    }
+    if (kernels.rm_nn && layout == CblasRowMajor && TransA == CblasNoTrans && TransB == CblasNoTrans) {
+        kernels.rm_nn(M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
+        return;
+    }
+    if (kernels.cm_nt && layout == CblasColMajor && TransA == CblasNoTrans && TransB == CblasTrans) {
+        kernels.cm_nt(M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
         return;
     }
     // naive implementation
@@ -146,4 +501,16 @@ void cblas_sgemm(const CBLAS_LAYOUT layout, const CBLAS_TRANSPOSE TransA, const
         }
     }
     return;
-}
\ No newline at end of file
+}
+
+void vpunn_sgemm(const VPUNN_SGEMM_KERNELS kernels, const CBLAS_LAYOUT layout, const CBLAS_TRANSPOSE TransA,
+                 const CBLAS_TRANSPOSE TransB, const int M, const int N, const int K, const float alpha, const float* A,
+                 const int lda, const float* B, const int ldb, const float beta, float* C, const int ldc) {
+    sgemm_with(sgemm_kernels_of(kernels), layout, TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
+}
+
+void cblas_sgemm(const CBLAS_LAYOUT layout, const CBLAS_TRANSPOSE TransA, const CBLAS_TRANSPOSE TransB, const int M,
+                 const int N, const int K, const float alpha, const float* A, const int lda, const float* B,
+                 const int ldb, const float beta, float* C, const int ldc) {
+    sgemm_with(best_sgemm_kernels(), layout, TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
+}
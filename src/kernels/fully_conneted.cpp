@@ -10,6 +10,9 @@
 #include "kernels/fully_connected.h"
 #include "kernels/vpunn_blas.h"
 
+#include <algorithm>
+#include <array>
+
 void VPUNN::Dense(const VPUNN::Tensor<float>* weights, const VPUNN::Tensor<float>* activations,
                   VPUNN::Tensor<float>* output) {
     // Use cblas_sgemm to compute C <- alpha A * B + beta C
@@ -22,3 +25,68 @@ void VPUNN::Dense(const VPUNN::Tensor<float>* weights, const VPUNN::Tensor<float
                 activations->c_ptr(), input_channels, weights->c_ptr(), input_channels, 0.0F, output->data(),
                 output_channels);
 }
+
+namespace {
+// above these the sgemm kernels are faster: the weights are read in rows, gathered by scalar loads
+constexpr int sparse_input_max_nonzero{32};  ///< gathered on the stack
+constexpr int sparse_input_min_ratio{8};     ///< at most one activation of this many is non zero
+}  // namespace
+
+bool VPUNN::DenseSparseInput(const VPUNN::Tensor<float>* weights, const VPUNN::Tensor<float>* activations,
+                             VPUNN::Tensor<float>* output) {
+    const int output_channels = output->shape()[1];
+    const int input_channels = activations->shape()[1];
+    const int batch_size = activations->shape()[0];
+    if (batch_size != 1) {
+        return false;
+    }
+
+    // gather the non zero activations, give up as soon as there are too many
+    const int max_nonzero{std::min(sparse_input_max_nonzero, input_channels / sparse_input_min_ratio)};
+    std::array<int, sparse_input_max_nonzero> nonzero_index;
+    std::array<float, sparse_input_max_nonzero> nonzero_value;
+    int nonzero{0};
+    const float* const input = activations->c_ptr();
+    for (int k = 0; k < input_channels; ++k) {
+        if (input[k] != 0.0F) {
+            if (nonzero == max_nonzero) {
+                return false;
+            }
+            nonzero_index[nonzero] = k;
+            nonzero_value[nonzero] = input[k];
+            ++nonzero;
+        }
+    }
+
+    const float* const weights_data = weights->c_ptr();
+    float* const result = output->data();
+    int o{0};
+    for (; o + 4 <= output_channels; o += 4) {  // four rows share the gathered activations
+        const float* const row0 = weights_data + o * input_channels;
+        const float* const row1 = row0 + input_channels;
+        const float* const row2 = row1 + input_channels;
+        const float* const row3 = row2 + input_channels;
+        float sum0{0.0F}, sum1{0.0F}, sum2{0.0F}, sum3{0.0F};
+        for (int i = 0; i < nonzero; ++i) {
+            const int k{nonzero_index[i]};
+            const float activation{nonzero_value[i]};
+            sum0 += activation * row0[k];
+            sum1 += activation * row1[k];
+            sum2 += activation * row2[k];
+            sum3 += activation * row3[k];
+        }
+        result[o] = sum0;
+        result[o + 1] = sum1;
+        result[o + 2] = sum2;
+        result[o + 3] = sum3;
+    }
+    for (; o < output_channels; ++o) {
+        const float* const weights_row = weights_data + o * input_channels;
+        float sum{0.0F};
+        for (int i = 0; i < nonzero; ++i) {
+            sum += nonzero_value[i] * weights_row[nonzero_index[i]];
+        }
+        result[o] = sum;
+    }
+    return true;
+}
@@ -0,0 +1,32 @@
+// Copyright © 2025 Intel Corporation
+// SPDX-License-Identifier: Apache 2.0
+// LEGAL NOTICE: Your use of this software and any required dependent software (the “Software Package”)
+// is subject to the terms and conditions of the software license agreements for the Software Package,
+// which may also include notices, disclaimers, or license terms for third party or open source software
+// included in or with the Software Package, and your use indicates your acceptance of all such terms.
+// Please refer to the “third-party-programs.txt” or other similarly-named text file included with the
+// Software Package for additional details.
+
+#ifndef VPUNN_SGEMM_KERNELS_H
+#define VPUNN_SGEMM_KERNELS_H
+
+// Internal header of the internal BLAS, not installed: lets the tests run every kernel set of cblas_sgemm
+
+#include "kernels/vpunn_blas.h"
+
+// The kernel sets of the internal cblas_sgemm, cblas_sgemm uses the best one the CPU supports
+typedef enum VPUNN_SGEMM_KERNELS {
+    VpunnSgemmNaive = 0,    // generic loops only, any layout
+    VpunnSgemmDefault = 1,  // portable kernels for the optimized layouts
+    VpunnSgemmAVX2 = 2,     // AVX2/FMA kernels, needs runtime dispatch in the build
+    VpunnSgemmAVX512 = 3    // AVX-512 kernels, needs runtime dispatch in the build
+} VPUNN_SGEMM_KERNELS;
+
+// Tells if this build and the running CPU can use a kernel set
+bool vpunn_sgemm_kernels_supported(const VPUNN_SGEMM_KERNELS kernels);
+// cblas_sgemm with a given kernel set, for testing. The set must be supported
+void vpunn_sgemm(const VPUNN_SGEMM_KERNELS kernels, const CBLAS_LAYOUT layout, const CBLAS_TRANSPOSE TransA,
+                 const CBLAS_TRANSPOSE TransB, const int M, const int N, const int K, const float alpha, const float* A,
+                 const int lda, const float* B, const int ldb, const float beta, float* C, const int ldc);
+
+#endif  // VPUNN_SGEMM_KERNELS_H
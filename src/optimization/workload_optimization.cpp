@@ -7,7 +7,11 @@
 // Please refer to the “third-party-programs.txt” or other similarly-named text file included with the
 // Software Package for additional details.
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
+#include <numeric>
+#include <optional>
 
 #include "core/profiling.h"
 #include "vpu/optimization/tiler.h"
@@ -45,6 +49,203 @@ private:
         return device;
     }
 
+    /// one split variant and where it comes from (for reporting)
+    struct SplitCandidate {
+        DPUWorkloadsWithCyclesSplit split;
+        ExecutionMode mode;
+        unsigned int nWorkloads;
+        const ITilerAlgorithm* algo;
+    };
+
+    /// @brief adds the cost of a split to splits_costs, or the error, with a warning for errors
+    /// @param measure computes the PnPEstimates of the candidate's split, may throw
+    template <class Measure>
+    void add_split_cost(std::list<DPUWorkloadsWithCycleCost>& splits_costs, SplitCandidate& candidate,
+                        const unsigned int runtimeOverhead, Measure&& measure) const {
+        auto& workloads{candidate.split};
+        const auto mode{candidate.mode};
+        const auto nWorkloads{candidate.nWorkloads};
+        const auto& algo{candidate.algo};
+        // measure  this variant. try catch , and check its output for errors
+        try {
+            const PnPEstimates pnp = measure(workloads, runtimeOverhead);  // may throw
+
+            const CyclesInterfaceType wl_cost{pnp.cycles <= 0 ? Cycles::ERROR_TILE_SPLIT_ZERO_CYC_OUTPUT  // no zero
+                                                              : pnp.cycles};
+
+            if (Cycles::isErrorCode(wl_cost)) {
+                Logger::warning() << "\n Error result (or zero cycles) while computing the performance "
+                                  << "of workloads split variants! "
+                                  << "ERROR code: " << wl_cost << " : " << Cycles::toErrorText(wl_cost)
+                                  << "\n Execution mode: " << (int)mode << " : "
+                                  << ExecutionMode_ToText.at(static_cast<int>(mode)) << "\n nWorkloads: " << nWorkloads
+                                  << "\n Algo : " << algo->name()
+                                  << " \n Result: ignoring the cost of this workloads split \n";
+            }
+
+            // good or bad we keep the result
+            splits_costs.push_back({wl_cost, workloads});
+
+        } catch (const std::exception& e) {
+            Logger::warning() << "\n Exception thrown while computing the performance of workloads "
+                              << "split variants! "
+                              << "\n Execution mode: " << (int)mode << " : "
+                              << ExecutionMode_ToText.at(static_cast<int>(mode)) << "\n nWorkloads: " << nWorkloads
+                              << "\n Algo : " << algo->name() << "\n Exception: " << e.what() << "\n "
+                              << "\nResult: ignoring the cost of this workloads split \n";
+
+            // add the error result
+            splits_costs.push_back({(CyclesInterfaceType)Cycles::ERROR_TILE_SPLIT_EXCEPTION, workloads});
+        }
+    }
+
+    /**
+     * @brief costs the candidates together: the distinct workloads of all candidates are evaluated once, in one list
+     * (spread over the model's batch threads), then each candidate is scheduled from these cycles.
+     *
+     * @returns false if the list evaluation threw, nothing added then, the candidates must be costed one by one
+     */
+    bool cost_candidates_together(std::vector<SplitCandidate>& candidates,
+                                  std::list<DPUWorkloadsWithCycleCost>& splits_costs,
+                                  const unsigned int runtimeOverhead) const {
+        // most candidates share workloads
+        MapTypeSelector<DPUWorkload>::type<size_t> position_of_workload;
+        std::vector<DPUWorkload> distinct_workloads;
+        std::vector<std::vector<size_t>> candidate_positions(candidates.size());
+        for (size_t c = 0; c < candidates.size(); ++c) {
+            const auto& wls{candidates[c].split.workloads};
+            candidate_positions[c].reserve(wls.size());
+            for (const auto& wl : wls) {
+                const auto inserted{position_of_workload.emplace(wl, distinct_workloads.size())};
+                if (inserted.second) {
+                    distinct_workloads.push_back(wl);
+                }
+                candidate_positions[c].push_back(inserted.first->second);
+            }
+        }
+
+        std::vector<CyclesInterfaceType> distinct_cycles;
+        try {
+            distinct_cycles = model.DPU_each(distinct_workloads);
+        } catch (const std::exception&) {
+            return false;  // the candidate(s) owning the faulty workload(s) must get their individual error
+        }
+
+        for (size_t c = 0; c < candidates.size(); ++c) {
+            add_split_cost(splits_costs, candidates[c], runtimeOverhead,
+                           [&](DPUWorkloadsWithCyclesSplit& split, const unsigned int overhead) {
+                               for (size_t idx = 0; idx < split.workloads.size(); ++idx) {
+                                   split.cycles[idx] = distinct_cycles[candidate_positions[c][idx]];
+                               }
+                               return scheduledPerformance(split, overhead);
+                           });
+        }
+        return true;
+    }
+
+    /// how many candidates are costed together in one step of the pruned search
+    static constexpr size_t pruning_wave_size{16};
+
+    /// the part of its ideal MAC cycles a workload is assumed to last at least, in percents. The NN is not bound by
+    /// the ideal cycles, on sweeps of layers of VPU2.0, VPU2.7 and VPU4.0 it predicted down to 77% of them.
+    static constexpr unsigned long long bound_ideal_cycles_percent{70};
+
+    mutable std::atomic<size_t> pruned_candidates{0};  ///< not costed because of their lower bound
+
+    /**
+     * @brief a cycles value that the cost of this split is not expected to go below.
+     * Each workload lasts at least bound_ideal_cycles_percent of its ideal MAC cycles (sparsity considered) plus the
+     * runtime overhead, and a dpu_schedule lasts at least as much as its longest workload and as the total spread
+     * evenly on the DPUs. Not a guarantee: a NN predicting below that part of the ideal cycles can go under it.
+     *
+     * @returns the bound, zero if it cannot be computed
+     */
+    CyclesInterfaceType lowerBound(const DPUWorkloadsWithCyclesSplit& split, const unsigned int runtimeOverhead) const {
+        if (split.workloads.size() == 0) {
+            return 0;
+        }
+        try {
+            const HWPerformanceModel& performance{get_HWPerformance()};
+            const unsigned long long nDPU{
+                    std::max(1U, performance.get_hw_info(getWorkloadsDevice(split)).nDPU_per_tile())};
+            unsigned long long longest{0};
+            unsigned long long total{0};
+            for (const auto& wl : split.workloads) {
+                const unsigned long long ideal{performance.DPU_Power_IdealCycles(wl)};
+                const unsigned long long wl_cycles{(ideal * bound_ideal_cycles_percent) / 100 + runtimeOverhead};
+                longest = std::max(longest, wl_cycles);
+                total += wl_cycles;
+            }
+            const unsigned long long bound{std::max(longest, (total + nDPU - 1) / nDPU)};
+            return static_cast<CyclesInterfaceType>(
+                    std::min<unsigned long long>(bound, Cycles::START_ERROR_RANGE - 1));
+        } catch (const std::exception&) {
+            return 0;  // never pruned
+        }
+    }
+
+    /**
+     * @brief costs the candidates in the order of their lower bound, in waves of pruning_wave_size, and skips the
+     * ones whose bound is above the best cost found so far (they are not expected to be the minimum).
+     * The costed candidates are added in their original order, so the minimum selected is the same as for a full
+     * costing when no skipped candidate costs less than its bound. A candidate as good as the best is never skipped.
+     */
+    template <class Measure>
+    void cost_candidates_pruned(std::vector<SplitCandidate>& candidates,
+                                std::list<DPUWorkloadsWithCycleCost>& splits_costs,
+                                const unsigned int runtimeOverhead, Measure&& cost_one_by_one) const {
+        std::vector<CyclesInterfaceType> bounds;
+        bounds.reserve(candidates.size());
+        for (const auto& candidate : candidates) {
+            bounds.push_back(lowerBound(candidate.split, runtimeOverhead));
+        }
+        std::vector<size_t> order(candidates.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&bounds](size_t a, size_t b) {
+            return bounds[a] < bounds[b];
+        });
+
+        std::vector<std::optional<DPUWorkloadsWithCycleCost>> results(candidates.size());  // original order
+        std::optional<CyclesInterfaceType> best;  // best valid cost so far
+        size_t next{0};
+        while (next < order.size()) {
+            std::vector<size_t> wave;
+            std::vector<SplitCandidate> wave_candidates;
+            for (; (next < order.size()) && (wave.size() < pruning_wave_size); ++next) {
+                if (best.has_value() && (bounds[order[next]] > *best)) {
+                    // bounds are ascending and the best only decreases: none of the remaining can win
+                    pruned_candidates += order.size() - next;
+                    next = order.size();
+                    break;
+                }
+                wave.push_back(order[next]);
+                wave_candidates.push_back(std::move(candidates[order[next]]));
+            }
+
+            std::list<DPUWorkloadsWithCycleCost> wave_costs;
+            if (!wave_candidates.empty() && !cost_candidates_together(wave_candidates, wave_costs, runtimeOverhead)) {
+                for (auto& candidate : wave_candidates) {
+                    add_split_cost(wave_costs, candidate, runtimeOverhead, cost_one_by_one);
+                }
+            }
+
+            size_t position{0};  // wave_costs is in the order of the wave
+            for (auto& cost : wave_costs) {
+                const CyclesInterfaceType cycles{cost.first};
+                if (!Cycles::isErrorCode(cycles) && (cycles > 0) && (!best.has_value() || (cycles < *best))) {
+                    best = cycles;
+                }
+                results[wave[position++]] = std::move(cost);
+            }
+        }
+
+        for (auto& result : results) {
+            if (result.has_value()) {
+                splits_costs.push_back(std::move(*result));
+            }
+        }
+    }
+
     std::list<DPUWorkloadsWithCycleCost> generateSplits(const TilingAlgorithmsContainer& algorithms,
                                                         const std::vector<ExecutionMode>& valid_execution_modes,
                                                         const SplitOptions& options) const {
@@ -58,6 +259,13 @@ private:
             throw_error<std::runtime_error>("generateSplits: not Handling VPUOptimizationTarget::POWER");
         }
 
+        // with a latency budget each candidate is costed as soon as generated, so that the budget limits the costing
+        const bool cost_immediately{options.maxLatencyUs > 0};
+        const auto cost_one_by_one = [this](DPUWorkloadsWithCyclesSplit& split, const unsigned int overhead) {
+            return getLayerPerformance(split, overhead);
+        };
+
+        std::vector<SplitCandidate> candidates;
         for (auto& algo : algorithms) {
             for (auto& mode : valid_execution_modes) {
                 // in how many pieces to be tried to be split
@@ -72,45 +280,27 @@ private:
                     std::list<DPUWorkloadsWithCyclesSplit> splitVariants{
                             algo->split_tile_in_workloads(mode, nWorkloads)};
                     for (auto& workloads : splitVariants) {
-                        // measure  this variant. try catch , and check its output for errors
-                        try {
-                            const auto pnp = getLayerPerformance(workloads, options.runtimeOverhead);  // may throw
-
-                            const CyclesInterfaceType wl_cost{
-                                    pnp.cycles <= 0 ? Cycles::ERROR_TILE_SPLIT_ZERO_CYC_OUTPUT  // no zero allowed
-                                                    : pnp.cycles};
-
-                            if (Cycles::isErrorCode(wl_cost)) {
-                                Logger::warning() << "\n Error result (or zero cycles) while computing the performance "
-                                                  << "of workloads split variants! "
-                                                  << "ERROR code: " << wl_cost << " : " << Cycles::toErrorText(wl_cost)
-                                                  << "\n Execution mode: " << (int)mode << " : "
-                                                  << ExecutionMode_ToText.at(static_cast<int>(mode))
-                                                  << "\n nWorkloads: " << nWorkloads << "\n Algo : " << algo->name()
-                                                  << " \n Result: ignoring the cost of this workloads split \n";
-                            }
-
-                            // good or bad we keep the result
-                            splits_costs.push_back({wl_cost, workloads});
-
-                        } catch (const std::exception& e) {
-                            Logger::warning() << "\n Exception thrown while computing the performance of workloads "
-                                              << "split variants! "
-                                              << "\n Execution mode: " << (int)mode << " : "
-                                              << ExecutionMode_ToText.at(static_cast<int>(mode))
-                                              << "\n nWorkloads: " << nWorkloads << "\n Algo : " << algo->name()
-                                              << "\n Exception: " << e.what() << "\n "
-                                              << "\nResult: ignoring the cost of this workloads split \n";
-
-                            // add the error result
-                            splits_costs.push_back(
-                                    {(CyclesInterfaceType)Cycles::ERROR_TILE_SPLIT_EXCEPTION, workloads});
+                        SplitCandidate candidate{std::move(workloads), mode, nWorkloads, algo.get()};
+                        if (cost_immediately) {
+                            add_split_cost(splits_costs, candidate, options.runtimeOverhead, cost_one_by_one);
+                        } else {
+                            candidates.push_back(std::move(candidate));
                         }
-
                     }  // cost of workloads
                 }
             }
         }
+
+        if (candidates.empty()) {
+            return splits_costs;
+        }
+        if (options.pruneByLowerBound) {
+            cost_candidates_pruned(candidates, splits_costs, options.runtimeOverhead, cost_one_by_one);
+        } else if (!cost_candidates_together(candidates, splits_costs, options.runtimeOverhead)) {
+            for (auto& candidate : candidates) {
+                add_split_cost(splits_costs, candidate, options.runtimeOverhead, cost_one_by_one);
+            }
+        }
         return splits_costs;
     }
 
@@ -170,6 +360,10 @@ public:
         return {minimum_split->first, minimum_split->second.workloads};  // DPUWorkloadsCost pair
     }
 
+    size_t get_pruned_candidates_count() const override {
+        return pruned_candidates;
+    }
+
     PnPEstimates getLayerPerformance(DPUWorkloadsWithCyclesSplit& workloads_split,
                                      const unsigned int runtimeOverhead = 0,
                                      const bool skip_power = true) const override {
@@ -187,6 +381,18 @@ public:
             workloads_split.cycles[idx] = model.DPU(workloads_split.workloads[idx], info);
         }
 
+        return scheduledPerformance(workloads_split, runtimeOverhead, skip_power);
+    }
+
+private:
+    /// @brief the cycles and power of a split whose workloads already have their cycles
+    /// @see getLayerPerformance
+    PnPEstimates scheduledPerformance(const DPUWorkloadsWithCyclesSplit& workloads_split,
+                                      const unsigned int runtimeOverhead = 0, const bool skip_power = true) const {
+        // For an empty list of workloads immediately return 0
+        if (workloads_split.workloads.size() == 0)
+            return {0, 0.0f};  // no runtime to execute nothing
+
         const auto how_many_errors{countErrors(workloads_split.cycles)};
 
         if (how_many_errors > 0) {  // errors
@@ -225,7 +431,6 @@ public:
         return {total_cycles, average_power};
     }
 
-private:
     /// @brief Checks a list of cycle times for errors. counts the errors
     ///
     /// @param workloads_cycles the cycles list
@@ -13,28 +13,35 @@
 namespace VPUNN {
 
 /// Helper function to hash a single uint32_t value using FNV-1a
-/// TODO: should this be moved to core/utils.h to be used also in vpu/dpu_workload.cpp ?
-static inline uint32_t hash_uint32(uint32_t h, uint32_t value) {
-    h = (h ^ (value & 0xFF)) * fnv_prime;
-    h = (h ^ ((value >> 8) & 0xFF)) * fnv_prime;
-    h = (h ^ ((value >> 16) & 0xFF)) * fnv_prime;
-    h = (h ^ (value >> 24)) * fnv_prime;
-    return h;
+/// The helpers are templated on the hash type H: uint32_t for hash(), uint64_t for hash64()
+template <typename H>
+static inline H hash_uint32(H h, uint32_t value) {
+    return fnv1a_add_uint32(h, value);
 }
 
 /// Helper function to hash an int value (handles negative values properly)
-static inline uint32_t hash_int(uint32_t h, int value) {
+template <typename H>
+static inline H hash_int(H h, int value) {
     return hash_uint32(h, static_cast<uint32_t>(value));
 }
 
 /// Helper function to hash an enum value
-template<typename T>
-static inline uint32_t hash_enum(uint32_t h, T value) {
+template <typename H, typename T>
+static inline H hash_enum(H h, T value) {
     return hash_uint32(h, static_cast<uint32_t>(value));
 }
 
 uint32_t DMANNWorkload_NPU27::hash() const {
-    uint32_t h = fnv_offset_basis;
+    return hash_fields<uint32_t>();
+}
+
+uint64_t DMANNWorkload_NPU27::hash64() const {
+    return hash_fields<uint64_t>();
+}
+
+template <typename H>
+H DMANNWorkload_NPU27::hash_fields() const {
+    H h = FNV1aParams<H>::offset_basis;
     
     // Hash device
     h = hash_enum(h, device);
@@ -58,7 +65,16 @@ uint32_t DMANNWorkload_NPU27::hash() const {
 }
 
 uint32_t DMANNWorkload_NPU40_50::hash() const {
-    uint32_t h = fnv_offset_basis;
+    return hash_fields<uint32_t>();
+}
+
+uint64_t DMANNWorkload_NPU40_50::hash64() const {
+    return hash_fields<uint64_t>();
+}
+
+template <typename H>
+H DMANNWorkload_NPU40_50::hash_fields() const {
+    H h = FNV1aParams<H>::offset_basis;
     
     // Hash device
     h = hash_enum(h, device);
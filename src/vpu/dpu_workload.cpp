@@ -13,16 +13,15 @@
 namespace VPUNN {
 
 /// Helper function to hash a single uint32_t value using FNV-1a
-static inline uint32_t hash_uint32(uint32_t h, uint32_t value) {
-    h = (h ^ (value & 0xFF)) * fnv_prime;
-    h = (h ^ ((value >> 8) & 0xFF)) * fnv_prime;
-    h = (h ^ ((value >> 16) & 0xFF)) * fnv_prime;
-    h = (h ^ (value >> 24)) * fnv_prime;
-    return h;
+/// The helpers are templated on the hash type H: uint32_t for hash(), uint64_t for hash64()
+template <typename H>
+static inline H hash_uint32(H h, uint32_t value) {
+    return fnv1a_add_uint32(h, value);
 }
 
 /// Helper function to hash a float value with fractional rescaling
-static inline uint32_t hash_float(uint32_t h, float c) {
+template <typename H>
+static inline H hash_float(H h, float c) {
     float scaled_value = c * 100.0f;
     uint32_t value =
             (c < 1.0f && c > -1.0f && c != 0.0f) ? static_cast<uint32_t>(scaled_value) : static_cast<uint32_t>(c);
@@ -30,18 +29,20 @@ static inline uint32_t hash_float(uint32_t h, float c) {
 }
 
 /// Helper function to hash an enum value
-template <typename T>
-static inline uint32_t hash_enum(uint32_t h, T value) {
+template <typename H, typename T>
+static inline H hash_enum(H h, T value) {
     return hash_uint32(h, static_cast<uint32_t>(value));
 }
 
 /// Helper function to hash a boolean value
-static inline uint32_t hash_bool(uint32_t h, bool value) {
+template <typename H>
+static inline H hash_bool(H h, bool value) {
     return hash_uint32(h, value ? 1 : 0);
 }
 
 /// Helper function to hash a VPUTensor
-static inline uint32_t hash_tensor(uint32_t h, const VPUTensor& tensor) {
+template <typename H>
+static inline H hash_tensor(H h, const VPUTensor& tensor) {
     // Hash shape array
     const auto& shape = tensor.get_shape();
     for (const auto& dim : shape) {
@@ -55,7 +56,8 @@ static inline uint32_t hash_tensor(uint32_t h, const VPUTensor& tensor) {
 }
 
 /// Helper function to hash a HaloWorkload
-static inline uint32_t hash_halo(uint32_t h, const HaloWorkload& halo) {
+template <typename H>
+static inline H hash_halo(H h, const HaloWorkload& halo) {
     // Hash input_0_halo info
     h = hash_uint32(h, halo.input_0_halo.top);
     h = hash_uint32(h, halo.input_0_halo.bottom);
@@ -92,7 +94,8 @@ static inline uint32_t hash_halo(uint32_t h, const HaloWorkload& halo) {
 }
 
 /// Helper function to hash a SEPModeInfo
-static inline uint32_t hash_sep(uint32_t h, const SEPModeInfo& sep) {
+template <typename H>
+static inline H hash_sep(H h, const SEPModeInfo& sep) {
     // Hash SEP activators flag
     h = hash_bool(h, sep.sep_activators);
     // Hash SEP storage_elements_pointers shape
@@ -111,8 +114,8 @@ static inline uint32_t hash_sep(uint32_t h, const SEPModeInfo& sep) {
 }
 
 /// Helper function to hash an optional value
-template <typename T>
-static inline uint32_t hash_optional(uint32_t h, const std::optional<T>& opt) {
+template <typename H, typename T>
+static inline H hash_optional(H h, const std::optional<T>& opt) {
     if (opt.has_value()) {
         h = hash_bool(h, true);
         if constexpr (std::is_enum_v<T>) {
@@ -129,7 +132,16 @@ static inline uint32_t hash_optional(uint32_t h, const std::optional<T>& opt) {
 }
 
 uint32_t DPUWorkload::hash() const {
-    uint32_t h = fnv_offset_basis;
+    return hash_fields<uint32_t>();
+}
+
+uint64_t DPUWorkload::hash64() const {
+    return hash_fields<uint64_t>();
+}
+
+template <typename H>
+H DPUWorkload::hash_fields() const {
+    H h = FNV1aParams<H>::offset_basis;
 
     // Hash basic enums
     h = hash_enum(h, device);
@@ -0,0 +1,55 @@
+// Copyright © 2025 Intel Corporation
+// SPDX-License-Identifier: Apache 2.0
+// LEGAL NOTICE: Your use of this software and any required dependent software (the "Software Package")
+// is subject to the terms and conditions of the software license agreements for the Software Package,
+// which may also include notices, disclaimers, or license terms for third party or open source software
+// included in or with the Software Package, and your use indicates your acceptance of all such terms.
+// Please refer to the "third-party-programs.txt" or other similarly-named text file included with the
+// Software Package for additional details.
+
+#include "vpu/shave_op_id.h"
+
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace VPUNN {
+
+namespace {
+/// the process wide table of interned names
+struct ShaveOpIdTable {
+    std::unordered_map<std::string, ShaveOpId> ids;
+    std::shared_mutex mtx;
+};
+
+ShaveOpIdTable& id_table() {
+    static ShaveOpIdTable table;
+    return table;
+}
+}  // namespace
+
+ShaveOpId ShaveOpIds::intern(const std::string& name) {
+    const ShaveOpId known{find(name)};  // the usual case
+    if (known != unknown) {
+        return known;
+    }
+    ShaveOpIdTable& table{id_table()};
+    std::unique_lock<std::shared_mutex> lock(table.mtx);
+    const auto new_id{static_cast<ShaveOpId>(table.ids.size())};
+    return table.ids.emplace(name, new_id).first->second;  // another thread might have added it meanwhile
+}
+
+ShaveOpId ShaveOpIds::find(const std::string& name) {
+    ShaveOpIdTable& table{id_table()};
+    std::shared_lock<std::shared_mutex> lock(table.mtx);
+    const auto it{table.ids.find(name)};
+    return (it != table.ids.cend()) ? it->second : unknown;
+}
+
+ShaveOpId ShaveOpIds::count() {
+    ShaveOpIdTable& table{id_table()};
+    std::shared_lock<std::shared_mutex> lock(table.mtx);
+    return static_cast<ShaveOpId>(table.ids.size());
+}
+
+}  // namespace VPUNN
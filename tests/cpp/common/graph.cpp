@@ -106,6 +106,108 @@ TEST_F(TestVPUCompute, ComputationDAGBasicAssertions) {
     EXPECT_EQ(dag.sources().size(), 1);
 }
 
+TEST_F(TestVPUCompute, ComputationDAGIdsAndTopologicalOrder) {
+    std::vector<std::shared_ptr<VPUNN::VPUComputeNode>> layers;
+    for (int i = 0; i < 5; i++) {
+        layers.push_back(std::make_shared<VPUNN::VPUComputeNode>(generate_helper_shv_layer(32, 64)));
+    }
+
+    // 4 -> 2 -> {1, 3} -> 0, edges added before the nodes they target are known
+    auto dag = VPUNN::VPUComputationDAG();
+    dag.addEdge(layers[4], layers[2]);
+    dag.addEdge(layers[2], layers[3]);
+    dag.addEdge(layers[2], layers[1]);
+    dag.addEdge(layers[3], layers[0]);
+    dag.addEdge(layers[1], layers[0]);
+
+    ASSERT_EQ(dag.nodes(), 5);
+    EXPECT_EQ(dag.edges(), 5);
+    // ids are the insertion order
+    EXPECT_EQ(dag.node_id(layers[4]), 0);
+    EXPECT_EQ(dag.node_id(layers[2]), 1);
+    EXPECT_EQ(dag.node_id(layers[3]), 2);
+    EXPECT_EQ(dag.node_id(layers[1]), 3);
+    EXPECT_EQ(dag.node_id(layers[0]), 4);
+    for (std::size_t id = 0; id < dag.nodes(); id++) {
+        EXPECT_EQ(dag.node_id(dag.node(id)), id);
+    }
+
+    const auto succ = dag.successors(dag.node_id(layers[2]));
+    EXPECT_EQ(std::vector<std::size_t>(succ.begin(), succ.end()), (std::vector<std::size_t>{2, 3}));
+    const auto pred = dag.predecessors(dag.node_id(layers[0]));
+    EXPECT_EQ(std::vector<std::size_t>(pred.begin(), pred.end()), (std::vector<std::size_t>{2, 3}));
+    EXPECT_EQ(dag.get_successors(layers[2]),
+              (std::vector<std::shared_ptr<VPUNN::VPUComputeNode>>{layers[3], layers[1]}));
+    EXPECT_EQ(dag.get_predecessors(layers[4]).size(), 0);
+    ASSERT_EQ(dag.sources().size(), 1);
+    EXPECT_EQ(dag.sources().front(), layers[4]);
+
+    const auto order = dag.topological_order();
+    EXPECT_EQ(std::vector<std::size_t>(order.begin(), order.end()), (std::vector<std::size_t>{0, 1, 2, 3, 4}));
+    std::vector<std::shared_ptr<VPUNN::VPUComputeNode>> visited;
+    for (auto layer : dag) {
+        visited.push_back(layer);
+    }
+    EXPECT_EQ(visited, (std::vector<std::shared_ptr<VPUNN::VPUComputeNode>>{layers[4], layers[2], layers[3], layers[1],
+                                                                             layers[0]}));
+
+    // a change of the graph is seen by the next traversal
+    auto extra = std::make_shared<VPUNN::VPUComputeNode>(generate_helper_shv_layer(32, 64));
+    dag.addEdge(extra, layers[4]);
+    EXPECT_EQ(dag.topological_order().size(), 6);
+    EXPECT_EQ(*dag.begin(), extra);
+    EXPECT_FALSE(dag.has(std::make_shared<VPUNN::VPUComputeNode>(generate_helper_shv_layer(32, 64))));
+}
+
+TEST_F(TestVPUCompute, NetworkCostModelStrategyById) {
+    auto dag = generate_helper_dag();
+    const VPUNN::VPULayerStrategy basic_strategy{1, 1, 1, VPUNN::VPUTilingStrategy::NONE, false, false};
+
+    VPUNN::VPUNetworkStrategy strategy;
+    for (auto layer : dag) {
+        strategy[layer] = basic_strategy;
+    }
+    std::vector<VPUNN::VPULayerStrategy> strategy_by_id(dag.nodes(), basic_strategy);
+
+    EXPECT_EQ(model.Network(dag, strategy_by_id), model.Network(dag, strategy));
+
+    std::vector<VPUNN::VPULayerStrategy> too_short(dag.nodes() - 1, basic_strategy);
+    EXPECT_THROW(model.Network(dag, too_short), std::runtime_error);
+}
+
+TEST_F(TestVPUCompute, NetworkCostModelParallelSameAsSequential) {
+    // a wide network: 4 branches of mixed DPU and SHAVE layers between a source and a sink
+    auto dag = VPUNN::VPUComputationDAG();
+    auto source = std::make_shared<VPUNN::VPUComputeNode>(generate_helper_shv_layer(32, 64));
+    auto sink = std::make_shared<VPUNN::VPUComputeNode>(generate_helper_shv_layer(32, 64));
+    for (unsigned int branch = 0; branch < 4; branch++) {
+        auto dpu = std::make_shared<VPUNN::VPUComputeNode>(generate_helper_dpu_layer(16 + 8 * branch, 64));
+        auto shv = std::make_shared<VPUNN::VPUComputeNode>(generate_helper_shv_layer(16 + 8 * branch, 64));
+        dag.addEdge(source, dpu).addEdge(dpu, shv).addEdge(shv, sink);
+    }
+    const VPUNN::VPULayerStrategy basic_strategy{1, 1, 1, VPUNN::VPUTilingStrategy::NONE, false, false};
+    std::vector<VPUNN::VPULayerStrategy> strategy(dag.nodes(), basic_strategy);
+
+    EXPECT_EQ(model_2_0.get_network_threads(), 1u);
+    const unsigned long int sequential_cost = model_2_0.Network(dag, strategy);
+    EXPECT_GT(sequential_cost, 0u);
+
+    model_2_0.set_network_threads(4);
+    EXPECT_EQ(model_2_0.get_network_threads(), 4u);
+    for (int repeat = 0; repeat < 5; repeat++) {
+        EXPECT_EQ(model_2_0.Network(dag, strategy), sequential_cost) << repeat;
+    }
+
+    VPUNN::VPUNetworkStrategy strategy_map;
+    for (auto layer : dag) {
+        strategy_map[layer] = basic_strategy;
+    }
+    EXPECT_EQ(model_2_0.Network(dag, strategy_map), sequential_cost);
+
+    model_2_0.set_network_threads(0);
+    EXPECT_EQ(model_2_0.get_network_threads(), 1u);
+}
+
 TEST_F(TestVPUCompute, SmokeTestNetworkCostModelFail) {
     // Generate a random DAG
     auto dag = generate_helper_dag();
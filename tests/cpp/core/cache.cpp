@@ -7,6 +7,7 @@
 // Please refer to the “third-party-programs.txt” or other similarly-named text file included with the
 // Software Package for additional details.
 
+#include "core/bounded_sharded_memo.h"
 #include "core/cache.h"
 #include "core/persistent_cache.h"
 
@@ -15,6 +16,9 @@
 #include <ctime>
 #include <filesystem>
 #include <random>
+#include <set>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 #include "core/serializer.h"
 #include "vpu/compatibility/types11.h"
@@ -121,6 +125,228 @@ TEST_F(VPUNNCacheTest, CacheBasicTest_ext) {
     //}
 }
 
+TEST_F(VPUNNCacheTest, ShardedCacheTest) {
+    constexpr size_t cache_size{64};
+    constexpr size_t shards_count{8};
+    DPU_LRU_Cache cache(cache_size, "", "", shards_count);
+    EXPECT_EQ(cache.get_shards_count(), shards_count);
+    EXPECT_EQ(DPU_LRU_Cache(3, "", "", shards_count).get_shards_count(), 3u);  // not more shards than elements
+    EXPECT_EQ(DPU_LRU_Cache(0, "", "", shards_count).get_shards_count(), 1u);
+
+    // the shard of a key is known, the checks below do not depend on how the keys happen to spread
+    constexpr size_t shard_capacity{cache_size / shards_count};
+    auto shard_of = [](const std::vector<float>& key) {
+        return shard_index(NNDescriptor<float>(key).hash(), shards_count);
+    };
+
+    // keys grouped by the shard they land in, same count for every shard so each one is overfilled
+    constexpr size_t keys_per_shard{3 * shard_capacity};
+    std::vector<std::vector<std::vector<float>>> shard_keys(shards_count);
+    {
+        size_t complete_shards{0};
+        for (size_t i = 0; complete_shards < shards_count; ++i) {
+            std::vector<float> key(10, static_cast<float>(i));
+            auto& keys{shard_keys[shard_of(key)]};
+            if (keys.size() < keys_per_shard) {
+                keys.push_back(std::move(key));
+                complete_shards += (keys.size() == keys_per_shard) ? 1 : 0;
+            }
+        }
+    }
+
+    {  // one shard overflows alone, the others are not touched
+        DPU_LRU_Cache single(cache_size, "", "", shards_count);
+        for (size_t i = 0; i < shard_capacity; ++i) {
+            single.add(shard_keys[0][i], static_cast<float>(i));
+        }
+        EXPECT_EQ(single.size(), shard_capacity);
+        for (size_t i = 0; i < shard_capacity; ++i) {
+            EXPECT_TRUE(single.get(shard_keys[0][i])) << i;
+        }
+        single.add(shard_keys[0][shard_capacity], -1.0f);
+        EXPECT_EQ(single.size(), shard_capacity);  // an entry of the same shard was evicted
+        EXPECT_EQ(*single.get(shard_keys[0][shard_capacity]), -1.0f);
+        single.add(shard_keys[1][0], -2.0f);
+        EXPECT_EQ(single.size(), shard_capacity + 1);  // another shard has its own room
+    }
+
+    auto value_of = [](const std::vector<float>& key) {
+        return key[0];
+    };
+
+    constexpr size_t n_threads{4};
+    static_assert(shards_count % n_threads == 0, "every thread fills whole shards");
+    std::atomic<size_t> wrong_values{0};
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < n_threads; ++t) {
+        threads.emplace_back([&, t]() {
+            for (size_t i = 0; i < keys_per_shard; ++i) {
+                for (size_t s = t; s < shards_count; s += n_threads) {  // interleaved with the other threads
+                    const auto& key{shard_keys[(s + i) % shards_count][i]};
+                    cache.add(key, value_of(key));
+                    const auto found{cache.get(key)};
+                    if (found && (*found != value_of(key))) {  // can be already evicted by other threads
+                        ++wrong_values;
+                    }
+                }
+            }
+        });
+    }
+    for (auto& th : threads) {
+        th.join();
+    }
+
+    EXPECT_EQ(wrong_values.load(), 0u);
+    EXPECT_EQ(cache.size(), cache_size);  // every shard got more keys than its capacity, never above the limit
+
+    for (size_t s = 0; s < shards_count; ++s) {
+        size_t present{0};
+        for (const auto& key : shard_keys[s]) {
+            const auto found{cache.get(key)};
+            if (found) {
+                EXPECT_EQ(*found, value_of(key));
+                ++present;
+            }
+        }
+        EXPECT_EQ(present, shard_capacity) << "shard " << s;
+    }
+}
+
+TEST_F(VPUNNCacheTest, ShardIndexTest) {
+    constexpr size_t shards_count{DEFAULT_CACHE_SHARDS};
+    std::set<size_t> from_high_bits;   // hashes that differ only in the high bits
+    std::set<size_t> from_upper_word;  // 64 bit hashes that differ only in the upper 32 bits
+    for (uint64_t i = 0; i < 256; ++i) {
+        const size_t a{shard_index(i << 24, shards_count)};
+        const size_t b{shard_index(i << 32, shards_count)};
+        EXPECT_LT(a, shards_count);
+        EXPECT_LT(b, shards_count);
+        from_high_bits.insert(a);
+        from_upper_word.insert(b);
+    }
+    EXPECT_EQ(from_high_bits.size(), shards_count);
+    EXPECT_EQ(from_upper_word.size(), shards_count);
+    EXPECT_EQ(shard_index(0xFFFFFFFFu, 1), 0u);
+}
+
+TEST_F(VPUNNCacheTest, BoundedShardedMemoTest) {
+    struct IdentityHash {
+        uint32_t operator()(uint32_t key) const {
+            return key;
+        }
+    };
+    using Memo = BoundedShardedMemo<std::unordered_map<uint32_t, int>, IdentityHash>;
+
+    Memo memo(8, 4);
+    EXPECT_TRUE(memo.is_enabled());
+    memo.add(1, 10);
+    memo.add(1, 11);  // replaces
+    int value{0};
+    EXPECT_TRUE(memo.visit(1, [&value](int v) {
+        value = v;
+    }));
+    EXPECT_EQ(value, 11);
+    EXPECT_FALSE(memo.visit(2, [](int) {}));
+    EXPECT_EQ(memo.size(), 1u);
+
+    for (uint32_t key = 0; key < 1000; ++key) {
+        memo.add(key << 20, static_cast<int>(key));
+        EXPECT_LE(memo.size(), 8u);  // a full shard is emptied, never above the limit
+    }
+
+    Memo disabled(0);
+    EXPECT_FALSE(disabled.is_enabled());
+    disabled.add(1, 10);
+    EXPECT_EQ(disabled.size(), 0u);
+    EXPECT_FALSE(disabled.visit(1, [](int) {}));
+}
+
+TEST_F(VPUNNCacheTest, BatchedInferenceUsesCacheTest) {
+    const VPUNN::NNCostProvider provider{VPU_2_7_MODEL_PATH, 3 /*batch*/};
+    ASSERT_TRUE(provider.is_initialized());
+
+    auto make_wl = [](unsigned int channels) {
+        return VPUNN::DPUWorkload{VPUNN::VPUDevice::VPU_2_7,
+                                  VPUNN::Operation::CONVOLUTION,
+                                  {VPUNN::VPUTensor(56, 56, channels, 1, VPUNN::DataType::UINT8)},
+                                  {VPUNN::VPUTensor(56, 56, 16, 1, VPUNN::DataType::UINT8)},
+                                  {3, 3},
+                                  {1, 1},
+                                  {1, 1},
+                                  VPUNN::ExecutionMode::CUBOID_16x16};
+    };
+
+    const std::vector<VPUNN::DPUWorkload> first_batch{make_wl(16), make_wl(32), make_wl(48), make_wl(64)};
+    for (const auto& wl : first_batch) {
+        EXPECT_EQ(provider.get_cached(wl), Cycles::ERROR_CACHE_MISS);
+    }
+
+    const auto cold{provider.get_cost(first_batch)};  // fills the cache
+    ASSERT_EQ(cold.size(), first_batch.size());
+    for (size_t i = 0; i < first_batch.size(); ++i) {
+        EXPECT_EQ(provider.get_cached(first_batch[i]), cold[i]) << i;
+        EXPECT_EQ(provider.get_cost(first_batch[i]), cold[i]) << "single and batched must match " << i;
+    }
+
+    // mixed: some known, some new, some duplicates
+    const std::vector<VPUNN::DPUWorkload> mixed{make_wl(80), make_wl(16), make_wl(96), make_wl(80), make_wl(64)};
+    const auto warm{provider.get_cost(mixed)};
+    ASSERT_EQ(warm.size(), mixed.size());
+    EXPECT_EQ(warm[1], cold[0]);
+    EXPECT_EQ(warm[4], cold[3]);
+    EXPECT_EQ(warm[0], warm[3]);
+    for (size_t i = 0; i < mixed.size(); ++i) {
+        EXPECT_EQ(provider.get_cost(mixed[i]), warm[i]) << i;
+    }
+}
+
+/// lookup-or-compute with one cache probe: miss, inference through the probe, then hits with the same cost
+TEST_F(VPUNNCacheTest, CacheProbeLookupOrComputeTest) {
+    const VPUNN::NNCostProvider provider{VPU_2_7_MODEL_PATH};
+    ASSERT_TRUE(provider.is_initialized());
+    const VPUNN::NNCostProvider reference{VPU_2_7_MODEL_PATH};
+
+    const VPUNN::DPUWorkload wl{VPUNN::VPUDevice::VPU_2_7,
+                                VPUNN::Operation::CONVOLUTION,
+                                {VPUNN::VPUTensor(28, 28, 32, 1, VPUNN::DataType::UINT8)},
+                                {VPUNN::VPUTensor(28, 28, 64, 1, VPUNN::DataType::UINT8)},
+                                {3, 3},
+                                {1, 1},
+                                {1, 1},
+                                VPUNN::ExecutionMode::CUBOID_16x16};
+
+    auto probe{provider.probe_cache(wl)};
+    EXPECT_FALSE(probe.has_cached_value());
+    EXPECT_EQ(provider.get_cached(probe), Cycles::ERROR_CACHE_MISS);
+
+    const auto cycles{provider.get_cost(probe)};  // inferred and cached, no new lookup
+    EXPECT_EQ(cycles, reference.get_cost(wl));
+    EXPECT_TRUE(probe.has_cached_value());
+    EXPECT_EQ(provider.get_cached(probe), cycles);
+
+    provider.add_to_cache(probe, 1.0F);  // already cached, not replaced
+    std::string source;
+    const auto again{provider.probe_cache(wl, &source)};
+    EXPECT_TRUE(again.has_cached_value());
+    EXPECT_EQ(provider.get_cached(again), cycles);
+    EXPECT_EQ(source, "dyn_cache");
+}
+
+TEST_F(VPUNNCacheTest, ClockEvictionTest) {
+    DPU_LRU_Cache cache(2, "");  // one shard
+    const std::vector<float> v1(10, 1.0f), v2(10, 2.0f), v3(10, 3.0f);
+
+    cache.add(v1, 1.0f);
+    cache.add(v2, 2.0f);
+    ASSERT_TRUE(cache.get(v1));  // v1 recently used
+
+    cache.add(v3, 3.0f);  // evicts v2, not referenced since inserted
+    EXPECT_TRUE(cache.get(v1));
+    EXPECT_FALSE(cache.get(v2));
+    EXPECT_EQ(*cache.get(v3), 3.0f);
+    EXPECT_EQ(cache.size(), 2u);
+}
+
 //------
 
 class VPUNNCachePreloadedTest : public testing::Test {
@@ -477,6 +703,422 @@ TEST_F(VPUNNCachePreloadedTest, SmokeBasicTest) {
     // EXPECT_TRUE(false);
 }
 
+TEST_F(VPUNNCachePreloadedTest, FlatStorageWriteReadTest) {
+    FixedCache the_cache{""};
+    const std::string test_cache_file{"test_flat_cache.bin"};
+    const std::string test_cache_file_no_legacy{"test_flat_cache_no_legacy.bin"};
+
+    const std::vector<std::pair<uint32_t, float>> content{{700, 7.0f}, {5, 0.5f}, {0xFFFFFFFF, 42.0f}, {0, 1.0f}};
+    for (const auto& [key, value] : content) {
+        the_cache.insert(key, value);
+    }
+    ASSERT_TRUE(the_cache.write_cache(test_cache_file));
+    ASSERT_TRUE(the_cache.write_cache(test_cache_file_no_legacy, false));
+
+    const auto check = [&content](const FixedCache& cache, const std::string& info) {
+        EXPECT_EQ(cache.getCacheSize(), content.size()) << info;
+        for (const auto& [key, value] : content) {
+            ASSERT_TRUE(cache.get(key).has_value()) << info << " key: " << key;
+            EXPECT_EQ(*cache.get(key), value) << info << " key: " << key;
+        }
+        EXPECT_FALSE(cache.contains(6)) << info;
+        EXPECT_FALSE(cache.get(701).has_value()) << info;
+        EXPECT_FALSE(cache.get(0xFFFFFFFE).has_value()) << info;
+    };
+
+    {
+        const FixedCache flat{test_cache_file, FixedCacheStorage::FLAT};
+        EXPECT_TRUE(flat.is_memory_mapped());
+        EXPECT_EQ(flat.getMap().size(), 0);
+        check(flat, "FLAT, mapped");
+    }
+    {
+        const FixedCache flat{test_cache_file_no_legacy, FixedCacheStorage::FLAT};
+        EXPECT_TRUE(flat.is_memory_mapped());
+        check(flat, "FLAT, mapped, no legacy entries");
+    }
+    {
+        const FixedCache map{test_cache_file_no_legacy};
+        EXPECT_FALSE(map.is_memory_mapped());
+        EXPECT_EQ(map.getMap().size(), content.size());
+        check(map, "MAP, no legacy entries");
+    }
+    {  // from memory buffer, a sorted copy is kept
+        std::ifstream file(test_cache_file, std::ios::binary);
+        ASSERT_TRUE(file.is_open()) << test_cache_file;
+        std::vector<char> buffer(std::istreambuf_iterator<char>(file), {});
+        file.close();
+
+        const FixedCache flat{buffer.data(), buffer.size(), FixedCacheStorage::FLAT};
+        buffer.assign(buffer.size(), 0);  // not referenced after construction
+        EXPECT_FALSE(flat.is_memory_mapped());
+        check(flat, "FLAT, from buffer");
+    }
+    {  // preloaded values are read only, new keys go to the dynamic part
+        FixedCache flat{test_cache_file, FixedCacheStorage::FLAT};
+        flat.insert(700, 1000.0f);
+        flat.insert(6, 6.0f);
+        EXPECT_EQ(*flat.get(700), 7.0f);
+        EXPECT_EQ(*flat.get(6), 6.0f);
+        EXPECT_EQ(flat.getCacheSize(), content.size() + 1);
+    }
+    {  // missing file
+        const FixedCache flat{"not_existing_file.cachebin", FixedCacheStorage::FLAT};
+        EXPECT_FALSE(flat.is_memory_mapped());
+        EXPECT_EQ(flat.getCacheSize(), 0);
+        EXPECT_FALSE(flat.get(5).has_value());
+    }
+
+    std::filesystem::remove(test_cache_file);
+    std::filesystem::remove(test_cache_file_no_legacy);
+}
+
+TEST_F(VPUNNCachePreloadedTest, WarmSnapshotMergeTest) {
+    const std::string snapshot_file{"test_warm_snapshot.cachebin"};
+    const std::string snapshot_file_2{"test_warm_snapshot_2.cachebin"};
+    const std::string preloaded_file{"test_warm_preloaded.cachebin"};
+    const std::vector<std::vector<float>> wls{{1.0f, 2.0f}, {3.0f, 4.0f}, {5.0f, 6.0f}};
+
+    {  // dynamic content of a run
+        LRUCache<std::vector<float>, float> run_cache(100, "", "", 4);
+        for (size_t i = 0; i < wls.size(); ++i) {
+            run_cache.add(wls[i], static_cast<float>(i + 10));
+        }
+        ASSERT_TRUE(run_cache.save_snapshot(snapshot_file, "sim_model_a"));
+    }
+    {  // a preloaded cache that knows already the first workload, with another value
+        FixedCache preloaded{""};
+        preloaded.insert(NNDescriptor<float>(wls[0]).hash(), 99.0f);
+        ASSERT_TRUE(preloaded.write_cache(preloaded_file, false));
+    }
+
+    {  // same model: merged in the preloaded tier, the preloaded values win
+        LRUCache<std::vector<float>, float> next_run(100, preloaded_file, "", 4);
+        EXPECT_EQ(next_run.load_snapshot(snapshot_file, "sim_model_a"), wls.size() - 1);
+        std::string source;
+        EXPECT_EQ(next_run.get(wls[0], &source).value_or(0.0f), 99.0f);
+        EXPECT_EQ(next_run.get(wls[1], &source).value_or(0.0f), 11.0f);
+        EXPECT_EQ(source, "fixed_cache");
+        EXPECT_EQ(next_run.get(wls[2], &source).value_or(0.0f), 12.0f);
+        EXPECT_EQ(next_run.size(), 0u);
+
+        // the new dynamic entries are added to the ones already in the snapshot file
+        next_run.add({7.0f, 8.0f}, 13.0f);
+        ASSERT_TRUE(next_run.save_snapshot(snapshot_file, "sim_model_a"));
+        // a new file has only the dynamic entries
+        ASSERT_TRUE(next_run.save_snapshot(snapshot_file_2, "sim_model_a"));
+    }
+    {
+        LRUCache<std::vector<float>, float> third_run(100);
+        EXPECT_EQ(third_run.load_snapshot(snapshot_file, "sim_model_a"), wls.size() + 1);
+        EXPECT_EQ(third_run.get(wls[0]).value_or(0.0f), 10.0f);
+        EXPECT_EQ(third_run.get(wls[1]).value_or(0.0f), 11.0f);
+        EXPECT_EQ(third_run.get({7.0f, 8.0f}).value_or(0.0f), 13.0f);
+
+        LRUCache<std::vector<float>, float> only_dynamic(100);
+        EXPECT_EQ(only_dynamic.load_snapshot(snapshot_file_2, "sim_model_a"), 1u);
+        EXPECT_FALSE(only_dynamic.get(wls[1]).has_value());
+    }
+    {  // another model: rejected
+        LRUCache<std::vector<float>, float> other_model(100);
+        EXPECT_EQ(other_model.load_snapshot(snapshot_file, "sim_model_b"), 0u);
+        EXPECT_FALSE(other_model.get(wls[1]).has_value());
+    }
+    {  // same model, other descriptors: rejected
+        LRUCache<std::vector<float>, float> other_descriptors(100);
+        EXPECT_EQ(other_descriptors.load_snapshot(snapshot_file, "sim_model_a", 12), 0u);
+    }
+    {  // missing file
+        LRUCache<std::vector<float>, float> no_snapshot(100);
+        EXPECT_EQ(no_snapshot.load_snapshot("not_existing_file.cachebin", "sim_model_a"), 0u);
+    }
+
+    std::filesystem::remove(snapshot_file);
+    std::filesystem::remove(snapshot_file_2);
+    std::filesystem::remove(preloaded_file);
+}
+
+TEST_F(VPUNNCachePreloadedTest, ConcurrentSnapshotSaveTest) {
+    const std::string snapshot_file{"test_concurrent_snapshot.cachebin"};
+    LRUCache<std::vector<float>, float> run_cache(100);
+    for (size_t i = 0; i < 50; ++i) {
+        run_cache.add({static_cast<float>(i), 1.0f}, static_cast<float>(i));
+    }
+
+    // like several processes saving to the same warm cache directory at exit
+    std::atomic<size_t> failed{0};
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < 4; ++t) {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < 20; ++i) {
+                if (!run_cache.save_snapshot(snapshot_file, "sim_model_a")) {
+                    ++failed;
+                }
+            }
+        });
+    }
+    for (auto& th : threads) {
+        th.join();
+    }
+    EXPECT_EQ(failed.load(), 0u);
+
+    LRUCache<std::vector<float>, float> next_run(100);
+    EXPECT_EQ(next_run.load_snapshot(snapshot_file, "sim_model_a"), 50u);
+    EXPECT_EQ(next_run.get({7.0f, 1.0f}).value_or(0.0f), 7.0f);
+
+    for (const auto& entry : std::filesystem::directory_iterator(".")) {
+        EXPECT_NE(entry.path().filename().string().rfind(snapshot_file + ".tmp", 0), 0u)
+                << "temporary file left: " << entry.path();
+    }
+    std::filesystem::remove(snapshot_file);
+}
+
+TEST_F(VPUNNCachePreloadedTest, WideKeysWriteReadTest) {
+    const std::string test_cache_file{"test_wide_cache.cachebin"};
+    const std::vector<float> wl{1.0f, 2.0f, 3.0f};
+    const std::vector<float> other_wl{4.0f, 5.0f, 6.0f};
+    const uint64_t key64{NNDescriptor<float>(wl).hash64()};
+    const uint32_t fingerprint{NNDescriptor<float>(wl).hash()};
+    ASSERT_NE(key64, static_cast<uint64_t>(fingerprint));
+
+    {
+        FixedCache the_cache{""};
+        the_cache.set_file_info("sim_model", 11);
+        the_cache.insert(key64, fingerprint, 1.5f);
+        the_cache.insert(uint64_t{0xFFFFFFFFFFFFFFFFULL}, 8u, 2.5f);
+        the_cache.insert(NNDescriptor<float>(other_wl).hash(), 0.5f);  // 32 bit entry, in the same file
+        EXPECT_EQ(the_cache.getCacheSize(), 3u);
+        ASSERT_TRUE(the_cache.write_cache(test_cache_file, false));
+    }
+
+    const auto check = [&](const FixedCache& cache, const std::string& info) {
+        const auto& file_info{cache.get_file_info()};
+        EXPECT_EQ(file_info.format_version, 2u) << info;
+        EXPECT_EQ(file_info.model_nickname, "sim_model") << info;
+        EXPECT_EQ(file_info.descriptor_version, 11) << info;
+        EXPECT_TRUE(file_info.has_fingerprints) << info;
+        EXPECT_TRUE(cache.has_wide_keys()) << info;
+        EXPECT_EQ(cache.getCacheSize(), 3u) << info;
+
+        EXPECT_EQ(cache.get(key64, fingerprint).value_or(0.0f), 1.5f) << info;
+        EXPECT_FALSE(cache.get(key64, fingerprint + 1).has_value()) << info << " the fingerprint detects a collision";
+        EXPECT_EQ(cache.get(uint64_t{0xFFFFFFFFFFFFFFFFULL}, 8u).value_or(0.0f), 2.5f) << info;
+        EXPECT_FALSE(cache.get(uint64_t{0xFFFFFFFFFFFFFFFEULL}, 8u).has_value()) << info;
+        // not among the 64 bit entries, found as a 32 bit one
+        EXPECT_EQ(cache.get(uint64_t{1}, NNDescriptor<float>(other_wl).hash()).value_or(0.0f), 0.5f) << info;
+        EXPECT_FALSE(cache.get(fingerprint).has_value()) << info << " 64 bit entries are not found by the 32 bit key";
+    };
+
+    {
+        const FixedCache flat{test_cache_file, FixedCacheStorage::FLAT};
+        EXPECT_TRUE(flat.is_memory_mapped());
+        check(flat, "FLAT, mapped");
+    }
+    {
+        const FixedCache map{test_cache_file};
+        check(map, "MAP");
+    }
+    {  // the workload caches use both keys
+        LRUCache<std::vector<float>, float> lru(100, test_cache_file);
+        std::string source;
+        EXPECT_EQ(lru.get(wl, &source).value_or(0.0f), 1.5f);
+        EXPECT_EQ(source, "fixed_cache");
+        EXPECT_EQ(lru.get(other_wl).value_or(0.0f), 0.5f);
+        lru.add(wl, 100.0f);  // preloaded, not added
+        EXPECT_EQ(lru.size(), 0u);
+    }
+
+    std::filesystem::remove(test_cache_file);
+}
+
+TEST_F(VPUNNCachePreloadedTest, CompactEncodingWriteReadTest) {
+    const std::string plain_file{"test_plain_cache.cachebin"};
+    const std::string compact_file{"test_compact_cache.cachebin"};
+    const size_t entries_count{2000};
+    const auto key32_of = [](size_t i) {
+        return static_cast<uint32_t>(i * 2654435761u);
+    };
+    const auto key64_of = [](size_t i) {
+        return static_cast<uint64_t>(i + 1) * 0x9E3779B97F4A7C15ULL;
+    };
+    const auto value_of = [](size_t i) {
+        return 5.0f + static_cast<float>((i * i) % 100000) * 3.0f;  // cycles, up to 3e5
+    };
+
+    FixedCache the_cache{""};
+    the_cache.set_file_info("sim_model", 11);
+    for (size_t i = 0; i < entries_count; ++i) {
+        the_cache.insert(key32_of(i), value_of(i));
+        the_cache.insert(key64_of(i), static_cast<uint32_t>(i), value_of(i));
+    }
+    ASSERT_TRUE(the_cache.write_cache(plain_file, false));
+    ASSERT_TRUE(the_cache.write_cache_compact(compact_file));  // Log16, 0.1%
+    EXPECT_LT(std::filesystem::file_size(compact_file), std::filesystem::file_size(plain_file));
+
+    const float bound{CompactEncoding{}.max_relative_error};
+    const auto check = [&](const FixedCache& cache, const std::string& info, float max_error) {
+        EXPECT_EQ(cache.get_file_info().format_version, 3u) << info;
+        EXPECT_EQ(cache.get_file_info().model_nickname, "sim_model") << info;
+        EXPECT_TRUE(cache.get_file_info().has_fingerprints) << info;
+        EXPECT_EQ(cache.getCacheSize(), 2 * entries_count) << info;
+        for (size_t i = 0; i < entries_count; ++i) {
+            const auto value{cache.get(key32_of(i))};
+            ASSERT_TRUE(value.has_value()) << info << " " << i;
+            ASSERT_LE(std::fabs(*value - value_of(i)), max_error * value_of(i)) << info << " " << i;
+            const auto value64{cache.get(key64_of(i), static_cast<uint32_t>(i))};
+            ASSERT_TRUE(value64.has_value()) << info << " " << i;
+            ASSERT_LE(std::fabs(*value64 - value_of(i)), max_error * value_of(i)) << info << " " << i;
+        }
+        EXPECT_FALSE(cache.get(key32_of(entries_count)).has_value()) << info;
+        EXPECT_FALSE(cache.get(key64_of(0) + 1, key32_of(entries_count)).has_value()) << info;
+        EXPECT_FALSE(cache.get(key64_of(3), 4u).has_value()) << info << " the fingerprint detects a collision";
+    };
+    {
+        FixedCache flat{compact_file, FixedCacheStorage::FLAT};
+        EXPECT_TRUE(flat.is_memory_mapped());
+        EXPECT_EQ(flat.getMap().size(), 0);
+        check(flat, "FLAT, mapped", bound);
+
+        // rewritten with the decoded values
+        ASSERT_TRUE(flat.write_cache(plain_file, false));
+        const FixedCache decoded{plain_file, FixedCacheStorage::FLAT};
+        EXPECT_EQ(decoded.getCacheSize(), 2 * entries_count);
+        for (size_t i = 0; i < entries_count; i += 97) {
+            EXPECT_EQ(decoded.get(key32_of(i)).value_or(-1.0f), flat.get(key32_of(i)).value_or(0.0f)) << i;
+        }
+    }
+    {
+        const FixedCache map{compact_file};
+        check(map, "MAP", bound);
+    }
+
+    // Float16 cannot represent values above 65504, written exactly
+    {
+        ASSERT_TRUE(the_cache.write_cache_compact(
+                compact_file, CompactEncoding{VPUNN_SCHEMA::CompactValueEncoding::Float16, 0.001f, 16}));
+        const FixedCache flat{compact_file, FixedCacheStorage::FLAT};
+        check(flat, "Float16 fallback", 0.0f);
+    }
+    // small values fit in Float16, half an ULP is below 0.05%
+    {
+        FixedCache small_values{""};
+        for (size_t i = 0; i < entries_count; ++i) {
+            small_values.insert(key32_of(i), 1.0f + static_cast<float>(i) * 0.37f);
+        }
+        ASSERT_TRUE(small_values.write_cache_compact(
+                compact_file, CompactEncoding{VPUNN_SCHEMA::CompactValueEncoding::Float16, 0.0005f, 64}));
+        const FixedCache flat{compact_file, FixedCacheStorage::FLAT};
+        EXPECT_EQ(flat.getCacheSize(), entries_count);
+        size_t inexact{0};
+        for (size_t i = 0; i < entries_count; ++i) {
+            const float expected{1.0f + static_cast<float>(i) * 0.37f};
+            const auto value{flat.get(key32_of(i))};
+            ASSERT_TRUE(value.has_value()) << i;
+            ASSERT_LE(std::fabs(*value - expected), 0.0005f * expected) << i;
+            inexact += (*value != expected) ? 1 : 0;
+        }
+        EXPECT_GT(inexact, 0u) << "the values are approximated";
+    }
+
+    EXPECT_EQ(CompactCacheTable::half_to_float(CompactCacheTable::float_to_half(1.5f)), 1.5f);
+    EXPECT_EQ(CompactCacheTable::half_to_float(CompactCacheTable::float_to_half(-65504.0f)), -65504.0f);
+    EXPECT_EQ(CompactCacheTable::half_to_float(CompactCacheTable::float_to_half(std::ldexp(1.0f, -24))),
+              std::ldexp(1.0f, -24));  // smallest subnormal
+    EXPECT_TRUE(std::isinf(CompactCacheTable::half_to_float(CompactCacheTable::float_to_half(70000.0f))));
+
+    std::filesystem::remove(plain_file);
+    std::filesystem::remove(compact_file);
+}
+
+TEST_F(VPUNNCachePreloadedTest, FlatStorageSameAsMapTest) {
+    ASSERT_TRUE(std::filesystem::exists(cache_file_51)) << cache_file_51;
+    const FixedCache map_cache{cache_file_51};
+    const FixedCache flat_cache{cache_file_51, FixedCacheStorage::FLAT};
+
+    const auto& the_map{map_cache.getMap()};
+    ASSERT_GT(the_map.size(), 0);
+    EXPECT_EQ(flat_cache.getCacheSize(), the_map.size());
+    EXPECT_EQ(flat_cache.getMap().size(), 0);
+    EXPECT_TRUE(flat_cache.is_memory_mapped());  // the shipped files have the sorted section, no copy is made
+
+    for (const auto& [key, value] : the_map) {
+        const auto flat_value{flat_cache.get(key)};
+        ASSERT_TRUE(flat_value.has_value()) << key;
+        ASSERT_EQ(*flat_value, value) << key;
+    }
+    EXPECT_EQ(flat_cache.getCounter().getHits(), the_map.size());
+
+    // rewritten with the sorted section, it is served in place from the memory mapped file
+    const std::string rewritten_file{"test_flat_rewritten.cachebin"};
+    {
+        FixedCache to_write{cache_file_51, FixedCacheStorage::FLAT};
+        ASSERT_TRUE(to_write.write_cache(rewritten_file, false));
+    }
+    {
+        const FixedCache rewritten{rewritten_file, FixedCacheStorage::FLAT};
+        EXPECT_TRUE(rewritten.is_memory_mapped());
+        EXPECT_EQ(rewritten.getCacheSize(), the_map.size());
+        for (const auto& [key, value] : the_map) {
+            ASSERT_EQ(*rewritten.get(key), value) << key;
+        }
+
+        // the mapped file is replaced by a shorter one, the mapping in use keeps its content
+        FixedCache shorter{""};
+        shorter.insert(the_map.cbegin()->first, the_map.cbegin()->second + 1.0f);
+        ASSERT_TRUE(shorter.write_cache(rewritten_file, false));
+        for (const auto& [key, value] : the_map) {
+            ASSERT_EQ(*rewritten.get(key), value) << key;
+        }
+        const FixedCache reloaded{rewritten_file, FixedCacheStorage::FLAT};
+        EXPECT_EQ(reloaded.getCacheSize(), 1u);
+    }
+    std::filesystem::remove(rewritten_file);
+}
+
+TEST_F(VPUNNCachePreloadedTest, FlatStorageMultithreadCounterTest) {
+    ASSERT_TRUE(std::filesystem::exists(cache_file_51)) << cache_file_51;
+    const FixedCache flat_cache{cache_file_51, FixedCacheStorage::FLAT};
+    const FixedCache map_cache{cache_file_51};
+    const auto& the_map{map_cache.getMap()};
+    ASSERT_GT(the_map.size(), 100);
+    ASSERT_FALSE(flat_cache.contains(0xFFFFFFFF));
+
+    std::vector<std::pair<uint32_t, float>> samples;
+    for (auto it = the_map.cbegin(); samples.size() < 100; ++it) {
+        samples.emplace_back(it->first, it->second);
+    }
+
+    constexpr size_t n_threads{8};
+    constexpr size_t n_rounds{100};
+    std::atomic<int> wrong_values{0};
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < n_threads; ++t) {
+        threads.emplace_back([&]() {
+            for (size_t r = 0; r < n_rounds; ++r) {
+                for (const auto& [key, value] : samples) {
+                    const auto found{flat_cache.get(key)};
+                    if ((!found) || (*found != value)) {
+                        ++wrong_values;
+                    }
+                }
+                flat_cache.get(0xFFFFFFFF);  // a miss (not in this cache)
+            }
+        });
+    }
+    for (auto& th : threads) {
+        th.join();
+    }
+
+    EXPECT_EQ(wrong_values.load(), 0);
+    const auto& counter{flat_cache.getCounter()};
+    EXPECT_EQ(counter.getHits(), n_threads * n_rounds * samples.size());
+    EXPECT_EQ(counter.getMisses(), n_threads * n_rounds);
+    EXPECT_EQ(counter.getAccesses(), counter.getHits() + counter.getMisses());
+
+    counter.reset();
+    EXPECT_EQ(counter.getAccesses(), 0u);
+}
+
 TEST_F(VPUNNCachePreloadedTest, DISABLED_SearchTimeTest) {
     auto& preprop_now = pp_5014;
     FixedCache the_cache(cache_file_51);
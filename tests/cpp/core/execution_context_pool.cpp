@@ -0,0 +1,159 @@
+// Copyright © 2025 Intel Corporation
+// SPDX-License-Identifier: Apache 2.0
+// LEGAL NOTICE: Your use of this software and any required dependent software (the “Software Package”)
+// is subject to the terms and conditions of the software license agreements for the Software Package,
+// which may also include notices, disclaimers, or license terms for third party or open source software
+// included in or with the Software Package, and your use indicates your acceptance of all such terms.
+// Please refer to the “third-party-programs.txt” or other similarly-named text file included with the
+// Software Package for additional details.
+
+#include "core/execution_context_pool.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace VPUNN_unit_tests {
+using namespace VPUNN;
+
+class ExecutionContextPoolTest : public ::testing::Test {
+protected:
+    struct Context {
+        int owner_mark{0};
+    };
+    using Pool = ExecutionContextPool<Context>;
+
+    std::atomic<int> created{0};
+
+    auto factory() {
+        return [this]() {
+            ++created;
+            return std::make_unique<Context>();
+        };
+    }
+};
+
+TEST_F(ExecutionContextPoolTest, SameContextInSameThread) {
+    Pool pool;
+    Context& first{pool.get(factory())};
+    Context& second{pool.get(factory())};
+    EXPECT_EQ(&first, &second);
+    EXPECT_EQ(created.load(), 1);
+    EXPECT_EQ(pool.in_use_count(), 1u);
+    EXPECT_EQ(pool.idle_count(), 0u);
+
+    Pool other_pool;  // a different pool gives a different context to the same thread
+    EXPECT_NE(&other_pool.get(factory()), &first);
+    EXPECT_EQ(created.load(), 2);
+}
+
+TEST_F(ExecutionContextPoolTest, ContextsReusedAfterThreadExit) {
+    Pool pool;
+    for (int i = 0; i < 10; ++i) {  // sequential short lived threads
+        std::thread th([&]() {
+            pool.get(factory()).owner_mark = i;
+        });
+        th.join();
+    }
+    EXPECT_EQ(created.load(), 1) << "returned context must be reused";
+    EXPECT_EQ(pool.in_use_count(), 0u);
+    EXPECT_EQ(pool.idle_count(), 1u);
+}
+
+TEST_F(ExecutionContextPoolTest, IdleContextsAreBounded) {
+    Pool pool{2};
+    constexpr int n_threads{6};
+    std::atomic<int> ready{0};
+    std::atomic<bool> go{false};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < n_threads; ++i) {
+        threads.emplace_back([&]() {
+            pool.get(factory());
+            ++ready;
+            while (!go.load()) {
+                std::this_thread::yield();
+            }
+        });
+    }
+    while (ready.load() < n_threads) {
+        std::this_thread::yield();
+    }
+    EXPECT_EQ(pool.in_use_count(), static_cast<size_t>(n_threads));
+    EXPECT_EQ(created.load(), n_threads);
+
+    go = true;
+    for (auto& th : threads) {
+        th.join();
+    }
+    EXPECT_EQ(pool.in_use_count(), 0u);
+    EXPECT_EQ(pool.idle_count(), 2u);
+
+    pool.set_max_idle(0);
+    EXPECT_EQ(pool.idle_count(), 0u);
+}
+
+/// the contexts held are the ones of the live threads plus at most max_idle, new ones are created only above the idle
+TEST_F(ExecutionContextPoolTest, TotalContextsBoundedByLiveThreadsPlusIdle) {
+    constexpr size_t max_idle{2};
+    Pool pool{max_idle};
+    int expected_created{0};
+    size_t idle{0};
+    for (const size_t live_threads : {4u, 3u, 1u, 5u, 2u}) {
+        std::atomic<size_t> ready{0};
+        std::atomic<bool> go{false};
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < live_threads; ++i) {
+            threads.emplace_back([&]() {
+                pool.get(factory());
+                ++ready;
+                while (!go.load()) {
+                    std::this_thread::yield();
+                }
+            });
+        }
+        while (ready.load() < live_threads) {
+            std::this_thread::yield();
+        }
+        const size_t reused{std::min(live_threads, idle)};  // idle ones are taken first
+        expected_created += static_cast<int>(live_threads - reused);
+        EXPECT_EQ(created.load(), expected_created) << live_threads;
+        EXPECT_EQ(pool.in_use_count(), live_threads);
+        EXPECT_LE(pool.in_use_count() + pool.idle_count(), live_threads + max_idle);
+
+        go = true;
+        for (auto& th : threads) {
+            th.join();
+        }
+        idle = std::min(idle - reused + live_threads, max_idle);
+        EXPECT_EQ(pool.in_use_count(), 0u);
+        EXPECT_EQ(pool.idle_count(), idle);
+    }
+}
+
+TEST_F(ExecutionContextPoolTest, ThreadOutlivesPool) {
+    std::atomic<bool> pool_destroyed{false};
+    std::atomic<bool> used{false};
+    auto pool{std::make_unique<Pool>()};
+    std::thread th([&]() {
+        pool->get(factory());
+        used = true;
+        while (!pool_destroyed.load()) {
+            std::this_thread::yield();
+        }
+    });  // at exit the binding to the destroyed pool is ignored
+    while (!used.load()) {
+        std::this_thread::yield();
+    }
+    pool.reset();
+    pool_destroyed = true;
+    th.join();
+
+    Pool new_pool;  // the old bindings of this thread are not confused with the new pool
+    new_pool.get(factory());
+    EXPECT_EQ(new_pool.in_use_count(), 1u);
+}
+
+}  // namespace VPUNN_unit_tests
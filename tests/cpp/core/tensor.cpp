@@ -13,8 +13,10 @@
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <cstdint>
 #include <iostream>
 #include <numeric>
+#include <utility>
 #include <vector>
 
 namespace VPUNN_unit_tests {
@@ -384,4 +386,68 @@ TEST_F(TestTensor, MoveAssignement) {
     }  // td is destroyed, no throw here
 }
 
+TEST_F(TestTensor, ViewOverExternalMemory) {
+    const std::vector<unsigned int> dims{2U, 3U};
+    const std::vector<float> external{1.F, 2.F, 3.F, 4.F, 5.F, 6.F};
+
+    {
+        const auto view{VPUNN::Tensor<float>::view(external.data(), dims)};
+        EXPECT_TRUE(view.is_view());
+        EXPECT_EQ(view.c_ptr(), external.data()) << "no copy";
+        EXPECT_EQ(view.size(), 6);
+        EXPECT_EQ(view.shape(), dims);
+        EXPECT_EQ(view[5], 6.F);
+
+        VPUNN::Tensor<float> copy{view};  // a copy owns its data
+        EXPECT_FALSE(copy.is_view());
+        EXPECT_NE(copy.c_ptr(), external.data());
+        EXPECT_EQ(copy.data_vector(), external);
+        EXPECT_NO_THROW(copy.fill(0.F));  // the copy is writable
+
+        auto writable_view{VPUNN::Tensor<float>::view(external.data(), dims)};  // not const, still read only
+        EXPECT_THROW(writable_view.data(), std::runtime_error);
+        EXPECT_THROW(writable_view.fill(0.F), std::runtime_error);
+        EXPECT_THROW(writable_view.assign(external.data(), sizeof(float) * 6), std::runtime_error);
+        EXPECT_THROW(writable_view[0], std::runtime_error);
+        EXPECT_EQ(std::as_const(writable_view)[0], 1.F);
+
+        VPUNN::Tensor<float> moved{VPUNN::Tensor<float>::view(external.data(), dims)};
+        EXPECT_TRUE(moved.is_view());
+
+        VPUNN::Tensor<float> assigned{dims, 0.F};
+        assigned = std::move(moved);  // the previously owned memory is released by moved
+        EXPECT_TRUE(assigned.is_view());
+        EXPECT_EQ(assigned.c_ptr(), external.data());
+        EXPECT_FALSE(moved.is_view());
+    }  // views do not release the external memory
+
+    EXPECT_EQ(external[0], 1.F);
+
+    // the memory must be aligned for the element type
+    alignas(8) const unsigned char bytes[32]{};
+    EXPECT_TRUE(VPUNN::Tensor<float>::can_view(bytes + 4));
+    EXPECT_FALSE(VPUNN::Tensor<float>::can_view(bytes + 2));
+    EXPECT_FALSE(VPUNN::Tensor<double>::can_view(bytes + 4));
+    EXPECT_THROW(VPUNN::Tensor<float>::view(reinterpret_cast<const float*>(bytes + 2), {2U}), std::runtime_error);
+}
+
+
+/// Memory allocated by tensors is aligned for the widest vector loads, also for copies and odd sizes
+TEST_F(TestTensor, AllocatedDataIsAligned) {
+    const auto is_aligned = [](const float* p) {
+        return reinterpret_cast<std::uintptr_t>(p) % VPUNN::Tensor<float>::data_alignment == 0;
+    };
+    for (const auto& dims : std::vector<std::vector<unsigned int>>{{1U}, {3U, 7U}, {5U, 13U, 2U}}) {
+        VPUNN::Tensor<float> t{dims, 1.F};
+        EXPECT_TRUE(is_aligned(t.c_ptr()));
+
+        VPUNN::Tensor<float> copy{t};
+        EXPECT_TRUE(is_aligned(copy.c_ptr()));
+
+        VPUNN::Tensor<float> assigned{{2U}};
+        assigned = t;
+        EXPECT_TRUE(is_aligned(assigned.c_ptr()));
+        EXPECT_EQ(assigned.data_vector(), t.data_vector());
+    }
+}
 }  // namespace VPUNN_unit_tests
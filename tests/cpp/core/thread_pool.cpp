@@ -0,0 +1,66 @@
+// Copyright © 2025 Intel Corporation
+// SPDX-License-Identifier: Apache 2.0
+// LEGAL NOTICE: Your use of this software and any required dependent software (the “Software Package”)
+// is subject to the terms and conditions of the software license agreements for the Software Package,
+// which may also include notices, disclaimers, or license terms for third party or open source software
+// included in or with the Software Package, and your use indicates your acceptance of all such terms.
+// Please refer to the “third-party-programs.txt” or other similarly-named text file included with the
+// Software Package for additional details.
+
+#include "core/thread_pool.h"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+namespace VPUNN_unit_tests {
+using namespace VPUNN;
+
+TEST(ThreadPoolTest, AllItemsRunOnce) {
+    for (size_t workers : {0u, 1u, 3u}) {
+        ThreadPool pool{workers};
+        EXPECT_EQ(pool.workers_count(), workers);
+        for (size_t items : {0u, 1u, 2u, 7u, 100u}) {
+            std::vector<std::atomic<int>> runs(items);
+            pool.parallel_for(items, [&](size_t i) {
+                ++runs[i];
+            });
+            for (size_t i = 0; i < items; ++i) {
+                EXPECT_EQ(runs[i].load(), 1) << "item: " << i << ", items: " << items << ", workers: " << workers;
+            }
+        }
+    }
+}
+
+TEST(ThreadPoolTest, NestedUseDoesNotDeadlock) {
+    ThreadPool pool{2};
+    std::atomic<int> runs{0};
+    pool.parallel_for(4, [&](size_t) {
+        pool.parallel_for(5, [&](size_t) {
+            ++runs;
+        });
+    });
+    EXPECT_EQ(runs.load(), 20);
+}
+
+TEST(ThreadPoolTest, ExceptionIsRethrownAfterAllItems) {
+    ThreadPool pool{2};
+    std::atomic<int> runs{0};
+    EXPECT_THROW(pool.parallel_for(10,
+                                   [&](size_t i) {
+                                       ++runs;
+                                       if (i == 3) {
+                                           throw std::runtime_error("item failed");
+                                       }
+                                   }),
+                 std::runtime_error);
+    EXPECT_EQ(runs.load(), 10);
+
+    pool.parallel_for(3, [&](size_t) {  // still usable
+        ++runs;
+    });
+    EXPECT_EQ(runs.load(), 13);
+}
+
+}  // namespace VPUNN_unit_tests
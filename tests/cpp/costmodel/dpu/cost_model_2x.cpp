@@ -507,6 +507,29 @@ TEST_F(TestCostModelVPU2x, BatchTestVPUNNCostModel_VPUNN_2_7F_Particular1) {
     }
 }
 
+/// Parallel evaluation of a workload list gives the same values, in the same order, as the sequential one
+TEST_F(TestCostModelVPU2x, BatchTestVPUNNCostModel_ParallelSameAsSequential) {
+    const std::string model_path = the_NN_models.fast_model_paths[1].first;
+    const VPUNN::VPUDevice device_version = the_NN_models.fast_model_paths[1].second;
+    const unsigned int batch_size{3};
+    const size_t n_workloads{500};
+
+    VPUNN::VPUCostModel parallel_model{model_path, false, 0, batch_size, "", "", false, false, 4};
+    VPUNN::VPUCostModel sequential_model{model_path, false, 0, batch_size};
+
+    auto workloads = std::vector<VPUNN::DPUWorkload>(n_workloads);
+    std::generate_n(workloads.begin(), n_workloads, VPUNN::randDPUWorkload(device_version));
+
+    const std::vector<VPUNN::CyclesInterfaceType> sequential_cycles = sequential_model.DPU(workloads);
+    for (int run = 0; run < 3; ++run) {
+        const std::vector<VPUNN::CyclesInterfaceType> parallel_cycles = parallel_model.DPU(workloads);
+        ASSERT_EQ(parallel_cycles.size(), n_workloads);
+        for (size_t idx = 0; idx < n_workloads; ++idx) {
+            EXPECT_EQ(parallel_cycles[idx], sequential_cycles[idx]) << "idx: " << idx << ", run: " << run;
+        }
+    }
+}
+
 // Demonstrate some basic assertions.
 TEST_F(TestCostModelVPU2x, BatchTest_SanitizedWorkloadsEquivalence) {
     // Dummy WL
@@ -1364,6 +1387,61 @@ TEST_F(TestCostModelVPU2x, TestDPUVPU27ModelIC_4_16_32) {
     }
 }
 
+/// A repeated sanitization gives the remembered outcome, same as the first one, also for invalid workloads
+TEST_F(TestCostModelVPU2x, Sanitization_Memoized_SameOutcome_VPU27) {
+    const DPUWorkload wl_changed{
+            device27,
+            Operation::CONVOLUTION,
+            {VPUTensor(16, 16, 4, 1, DataType::INT8)},   // input dimensions, becomes CM_CONVOLUTION UINT8
+            {VPUTensor(16, 16, 64, 1, DataType::INT8)},  // output dimensions
+            {3, 3},                                      // kernels
+            {1, 1},                                      // strides
+            {1, 1, 1, 1},                                // padding
+            ExecutionMode::CUBOID_16x16,                 // execution mode
+    };
+    const DPUWorkload wl_invalid{
+            device27,
+            Operation::CONVOLUTION,
+            {VPUTensor(1000, 1000, 2048, 1, DataType::UINT8)},  // input dimensions, too big for CMX
+            {VPUTensor(1000, 1000, 2048, 1, DataType::UINT8)},  // output dimensions
+            {3, 3},                                             // kernels
+            {1, 1},                                             // strides
+            {1, 1, 1, 1},                                       // padding
+            ExecutionMode::CUBOID_16x16,                        // execution mode
+    };
+
+    VPUCostModel model{model27_path};
+    for (const auto& raw_wl : {wl_changed, wl_invalid}) {
+        DPUWorkload first_wl{raw_wl};
+        SanityReport first_report{};
+        const bool first_usable{model.sanitize_workload(first_wl, first_report)};
+
+        DPUWorkload repeated_wl{raw_wl};
+        repeated_wl.offsets = {1, 2, 3, 4};  // not part of the workload identity, must be kept
+        SanityReport repeated_report{};
+        const bool repeated_usable{model.sanitize_workload(repeated_wl, repeated_report)};
+
+        EXPECT_EQ(first_usable, repeated_usable) << raw_wl;
+        EXPECT_EQ(first_report.value(), repeated_report.value()) << raw_wl;
+        EXPECT_EQ(first_report.info, repeated_report.info) << raw_wl;
+        EXPECT_EQ(first_wl, repeated_wl) << raw_wl;
+        EXPECT_EQ(repeated_wl.offsets, (std::array<unsigned int, 4>{1, 2, 3, 4}));
+    }
+
+    {
+        DPUWorkload wl{wl_changed};
+        SanityReport report{};
+        EXPECT_TRUE(model.sanitize_workload(wl, report)) << report.info;
+        EXPECT_EQ(wl.op, Operation::CM_CONVOLUTION);
+    }
+    {
+        DPUWorkload wl{wl_invalid};
+        SanityReport report{};
+        EXPECT_FALSE(model.sanitize_workload(wl, report));
+        EXPECT_EQ(report.value(), Cycles::ERROR_INPUT_TOO_BIG) << report.info;
+    }
+}
+
 ///@todo: continue from here
 TEST_F(TestCostModelVPU2x, Compressed_CONV_Sanity_test_VPU27) {
     const VPUNN::DPUWorkload wl_ref = {
@@ -413,7 +413,7 @@ TEST_F(TestCostModel, Acceptance_DataTypes_Test) {
     using DataTypePairs = std::vector<std::pair<DataType, DataType>>;
     struct TestIn {
         VPUDevice device;
-        const std::string& model_path;
+        std::string model_path;
         DataTypePairs invalid_dtypes;
         DataTypePairs valid_dtypes;
 
@@ -198,6 +198,38 @@ TEST_F(TestSHAVE, SHAVE_v2_Cache_Smoke) {
     }
 }
 
+/// the streamed hash keeps the values of the text based one, preloaded caches stay valid
+TEST_F(TestSHAVE, SHAVEWorkload_Hash_SameAsTextHash) {
+    const SHAVEWorkload swl{
+            "softmax",
+            VPUDevice::VPU_4_0,
+            {VPUTensor(10, 100, 5, 1, DataType::FLOAT16)},
+            {VPUTensor(10, 100, 5, 1, DataType::UINT8)},
+            {{-3}, {0.25f}, {true}, {std::string("axis")}},
+            {{"k", 1.5f}, {"m", 7}, {"s", std::string("v")}, {"z", false}},
+    };
+
+    const std::string dev{std::to_string(static_cast<int>(VPUDevice::VPU_4_0))};
+    const std::string f16{std::to_string(static_cast<int>(DataType::FLOAT16))};
+    const std::string u8{std::to_string(static_cast<int>(DataType::UINT8))};
+    const std::string layout{std::to_string(static_cast<int>(VPUTensor(10, 100, 5, 1, DataType::UINT8).get_layout()))};
+    const std::string text{dev + ",softmax," + "1,5,100,10," + f16 + "," + layout + "," + "1,5,100,10," + u8 + "," +
+                           layout + "," + "-3,0.25,1,axis," + "k/1.500000,m/7,s/v,z/0,"};
+    EXPECT_EQ(swl.hash(), fnv1a_hash(text)) << text;
+
+    const SHAVEWorkload other_loc{"softmax",        swl.get_device(),       swl.get_inputs(), swl.get_outputs(),
+                                  swl.get_params(), swl.get_extra_params(), "another location"};
+    EXPECT_EQ(swl, other_loc);
+    EXPECT_EQ(swl.hash(), other_loc.hash());
+
+    SHAVEWorkload::ExtraParameters changed_extra{swl.get_extra_params()};
+    changed_extra["m"] = 8;
+    const SHAVEWorkload other_extra{"softmax",        swl.get_device(), swl.get_inputs(), swl.get_outputs(),
+                                    swl.get_params(), changed_extra};
+    EXPECT_FALSE(swl == other_extra);
+    EXPECT_NE(swl.hash(), other_extra.hash());
+}
+
 TEST_F(TestSHAVE, SHAVE_v2_ListOfOperators) {
     // EXPECT_TRUE(false);
     {
@@ -2,11 +2,15 @@
 
 #ifdef VPUNN_BUILD_HTTP_CLIENT
 #include "http_client/http_cost_provider.h"
+#include "vpu_cost_model.h"
 #include <httplib.h>
 #include <nlohmann/json.hpp>
 #endif
 
 #include <gtest/gtest.h>
+#include <atomic>
+#include <cstdlib>
+#include <deque>
 #include <thread>
 
 namespace VPUNN_unit_tests {
@@ -589,6 +593,345 @@ TEST_F(HTTPClientTest, GetCostWithTrace) {
     EXPECT_TRUE(Cycles::isErrorCode(cycles));
 }
 
+/**
+ * @brief Tests HttpDPUCostProvider's getCosts method with a service that has the batch endpoint.
+ *
+ * Verifies that the operations are sent in batches of the configured size and that each operation gets its own cost.
+ */
+TEST_F(HTTPClientTest, GetCostsBatched) {
+    std::atomic<int> batch_requests{0};
+    std::atomic<int> single_requests{0};
+    _mock_server.Post("/generate_workload_batch", [&](const httplib::Request& req, httplib::Response& res) {
+        ++batch_requests;
+        nlohmann::json request = nlohmann::json::parse(req.body);
+        EXPECT_EQ(request["params"]["backend"], "silicon");
+        EXPECT_LE(request["dpu_workloads"].size(), 2u);
+        nlohmann::json response;
+        response["results"] = nlohmann::json::array();
+        for (const auto& wl : request["dpu_workloads"]) {
+            nlohmann::json result;
+            result["info"] = "success";
+            result["latencies"] = std::vector<CyclesInterfaceType>{1000 + wl["output_write_tiles"].get<unsigned>()};
+            response["results"].push_back(result);
+        }
+        res.set_content(response.dump(), "application/json");
+        res.status = 200;
+    });
+    _mock_server.Post("/generate_workload", [&](const httplib::Request& req, httplib::Response& res) {
+        (void)req;
+        ++single_requests;
+        res.status = 500;
+    });
+
+    HttpDPUCostProvider cost_provider("localhost", srv_port);
+    cost_provider.setBatchOptions({2, 2});
+
+    std::deque<DPUOperation> ops(5);
+    std::vector<const DPUOperation*> ops_ptr;
+    for (size_t i = 0; i < ops.size(); ++i) {
+        ops[i].output_write_tiles = static_cast<unsigned int>(i + 1);
+        ops_ptr.push_back(&ops[i]);
+    }
+
+    const auto costs = cost_provider.getCosts(ops_ptr, "silicon");
+
+    ASSERT_EQ(costs.size(), ops.size());
+    for (size_t i = 0; i < costs.size(); ++i) {
+        EXPECT_EQ(costs[i].cycles, 1001 + i) << i;
+    }
+    EXPECT_EQ(batch_requests.load(), 3);
+    EXPECT_EQ(single_requests.load(), 0);
+}
+
+/**
+ * @brief Tests HttpDPUCostProvider's getCosts method with a service that has no batch endpoint.
+ *
+ * Verifies that the operations are then sent one per request and still get their costs, and that the batch endpoint
+ * is not tried again.
+ */
+TEST_F(HTTPClientTest, GetCostsWithoutBatchEndpoint) {
+    std::atomic<int> batch_requests{0};
+    _mock_server.Post("/generate_workload_batch", [&](const httplib::Request& req, httplib::Response& res) {
+        (void)req;
+        ++batch_requests;
+        res.status = 404;
+    });
+    _mock_server.Post("/generate_workload", [&](const httplib::Request& req, httplib::Response& res) {
+        nlohmann::json request = nlohmann::json::parse(req.body);
+        nlohmann::json response;
+        response["info"] = "success";
+        response["latencies"] =
+                std::vector<CyclesInterfaceType>{1000 + request["dpu_workload"]["output_write_tiles"].get<unsigned>()};
+        res.set_content(response.dump(), "application/json");
+        res.status = 200;
+    });
+
+    HttpDPUCostProvider cost_provider("localhost", srv_port);
+
+    std::deque<DPUOperation> ops(3);
+    std::vector<const DPUOperation*> ops_ptr;
+    for (size_t i = 0; i < ops.size(); ++i) {
+        ops[i].output_write_tiles = static_cast<unsigned int>(i + 1);
+        ops_ptr.push_back(&ops[i]);
+    }
+
+    for (int call = 0; call < 2; ++call) {
+        const auto costs = cost_provider.getCosts(ops_ptr, "silicon");
+
+        ASSERT_EQ(costs.size(), ops.size());
+        for (size_t i = 0; i < costs.size(); ++i) {
+            EXPECT_EQ(costs[i].cycles, 1001 + i) << i;
+        }
+    }
+    EXPECT_EQ(batch_requests.load(), 1);
+}
+
+/**
+ * @brief Tests HttpDPUCostProvider's getCosts method when a batch request fails once.
+ *
+ * Verifies that the operations of the failed batch are sent one per request, and that the next call uses the batch
+ * endpoint again.
+ */
+TEST_F(HTTPClientTest, GetCostsBatchTriedAgainAfterFailure) {
+    std::atomic<int> batch_requests{0};
+    std::atomic<int> single_requests{0};
+    _mock_server.Post("/generate_workload_batch", [&](const httplib::Request& req, httplib::Response& res) {
+        if (++batch_requests == 1) {
+            res.status = 503;  // temporarily overloaded
+            return;
+        }
+        nlohmann::json request = nlohmann::json::parse(req.body);
+        nlohmann::json response;
+        response["results"] = nlohmann::json::array();
+        for (size_t i = 0; i < request["dpu_workloads"].size(); ++i) {
+            nlohmann::json result;
+            result["info"] = "success";
+            result["latencies"] = std::vector<CyclesInterfaceType>{1234};
+            response["results"].push_back(result);
+        }
+        res.set_content(response.dump(), "application/json");
+        res.status = 200;
+    });
+    _mock_server.Post("/generate_workload", [&](const httplib::Request& req, httplib::Response& res) {
+        (void)req;
+        ++single_requests;
+        nlohmann::json response;
+        response["info"] = "success";
+        response["latencies"] = std::vector<CyclesInterfaceType>{1234};
+        res.set_content(response.dump(), "application/json");
+        res.status = 200;
+    });
+
+    HttpDPUCostProvider cost_provider("localhost", srv_port);
+    cost_provider.setBatchOptions({8, 1});
+
+    std::deque<DPUOperation> ops(3);
+    std::vector<const DPUOperation*> ops_ptr;
+    for (size_t i = 0; i < ops.size(); ++i) {
+        ops[i].output_write_tiles = static_cast<unsigned int>(i + 1);
+        ops_ptr.push_back(&ops[i]);
+    }
+
+    for (int call = 0; call < 2; ++call) {
+        const auto costs = cost_provider.getCosts(ops_ptr, "silicon");
+        ASSERT_EQ(costs.size(), ops.size());
+        for (const auto& cost : costs) {
+            EXPECT_EQ(cost.cycles, 1234);
+        }
+    }
+    EXPECT_EQ(batch_requests.load(), 2);
+    EXPECT_EQ(single_requests.load(), 3);  // only for the failed batch
+}
+
+/**
+ * @brief Tests that getCost uses the costs kept by prefetchCosts.
+ *
+ * Verifies that a prefetched operation is answered without a new request and an unknown one is still requested.
+ */
+TEST_F(HTTPClientTest, GetCostUsesPrefetchedCosts) {
+    std::atomic<int> requests{0};
+    _mock_server.Post("/generate_workload_batch", [&](const httplib::Request& req, httplib::Response& res) {
+        ++requests;
+        nlohmann::json request = nlohmann::json::parse(req.body);
+        nlohmann::json response;
+        response["results"] = nlohmann::json::array();
+        for (size_t i = 0; i < request["dpu_workloads"].size(); ++i) {
+            nlohmann::json result;
+            result["info"] = "success";
+            result["latencies"] = std::vector<CyclesInterfaceType>{1234};
+            response["results"].push_back(result);
+        }
+        res.set_content(response.dump(), "application/json");
+        res.status = 200;
+    });
+    _mock_server.Post("/generate_workload", [&](const httplib::Request& req, httplib::Response& res) {
+        (void)req;
+        ++requests;
+        nlohmann::json response;
+        response["info"] = "success";
+        response["latencies"] = std::vector<CyclesInterfaceType>{4321};
+        res.set_content(response.dump(), "application/json");
+        res.status = 200;
+    });
+
+    HttpDPUCostProvider cost_provider("localhost", srv_port);
+
+    DPUOperation op;
+    DPUOperation other_op;
+    other_op.output_write_tiles = 2;
+    cost_provider.prefetchCosts({&op, &op}, "silicon");
+    EXPECT_EQ(requests.load(), 1);
+
+    std::string info;
+    EXPECT_EQ(cost_provider.getCost(op, info, "silicon"), 1234);
+    EXPECT_EQ(requests.load(), 1);
+
+    EXPECT_EQ(cost_provider.getCost(op, info, "vpuem"), 4321);  // other backend, not prefetched
+    EXPECT_EQ(cost_provider.getCost(other_op, info, "silicon"), 4321);
+    EXPECT_EQ(requests.load(), 3);
+}
+
+/**
+ * @brief Tests that prefetchCosts adds to the costs kept before, and keeps only the valid ones.
+ *
+ * Verifies that the costs prefetched for two backends are both used, that an operation with an error is asked again
+ * by getCost, and that clearPrefetched forgets the kept costs.
+ */
+TEST_F(HTTPClientTest, PrefetchedCostsOfSeveralBackends) {
+    std::atomic<int> requests{0};
+    _mock_server.Post("/generate_workload_batch", [&](const httplib::Request& req, httplib::Response& res) {
+        ++requests;
+        nlohmann::json request = nlohmann::json::parse(req.body);
+        const bool silicon{request["params"]["backend"] == "silicon"};
+        nlohmann::json response;
+        response["results"] = nlohmann::json::array();
+        for (const auto& wl : request["dpu_workloads"]) {
+            nlohmann::json result;
+            if (wl["output_write_tiles"].get<unsigned>() == 2) {
+                result["info"] = "profiling_error";
+                result["msg"] = "Profiling failed";
+            } else {
+                result["info"] = "success";
+                result["latencies"] = std::vector<CyclesInterfaceType>{silicon ? 1000u : 2000u};
+            }
+            response["results"].push_back(result);
+        }
+        res.set_content(response.dump(), "application/json");
+        res.status = 200;
+    });
+    _mock_server.Post("/generate_workload", [&](const httplib::Request& req, httplib::Response& res) {
+        (void)req;
+        ++requests;
+        nlohmann::json response;
+        response["info"] = "success";
+        response["latencies"] = std::vector<CyclesInterfaceType>{4321};
+        res.set_content(response.dump(), "application/json");
+        res.status = 200;
+    });
+
+    HttpDPUCostProvider cost_provider("localhost", srv_port);
+
+    DPUOperation op;
+    DPUOperation failing_op;
+    failing_op.output_write_tiles = 2;
+    cost_provider.prefetchCosts({&op, &failing_op}, "silicon");
+    cost_provider.prefetchCosts({&op, &failing_op}, "vpuem");
+    EXPECT_EQ(requests.load(), 2);
+
+    std::string info;
+    EXPECT_EQ(cost_provider.getCost(op, info, "silicon"), 1000);
+    EXPECT_EQ(cost_provider.getCost(op, info, "vpuem"), 2000);
+    EXPECT_EQ(requests.load(), 2);
+
+    EXPECT_EQ(cost_provider.getCost(failing_op, info, "silicon"), 4321);  // the error was not kept
+    EXPECT_EQ(requests.load(), 3);
+
+    cost_provider.clearPrefetched();
+    EXPECT_EQ(cost_provider.getCost(op, info, "silicon"), 4321);
+    EXPECT_EQ(requests.load(), 4);
+}
+
+/**
+ * @brief Tests that VPUCostModel::DPU_each asks the profiling service the costs of a list in one batch request.
+ *
+ * Verifies that the workloads needing the service (its hint, or a cache miss in AUTO mode) get the costs of the batch
+ * answer, with no single request.
+ */
+TEST_F(HTTPClientTest, CostModelListCostedInOneBatchRequest) {
+    std::atomic<int> batch_requests{0};
+    std::atomic<int> single_requests{0};
+    _mock_server.Post("/generate_workload", [&](const httplib::Request& req, httplib::Response& res) {
+        nlohmann::json request = nlohmann::json::parse(req.body);
+        nlohmann::json response;
+        if (request["params"].contains("status")) {
+            response["info"] = "status";
+            response["profiling"] = true;
+        } else {
+            ++single_requests;
+            response["info"] = "success";
+            response["latencies"] = std::vector<CyclesInterfaceType>{4321};
+        }
+        res.set_content(response.dump(), "application/json");
+        res.status = 200;
+    });
+    _mock_server.Post("/generate_workload_batch", [&](const httplib::Request& req, httplib::Response& res) {
+        ++batch_requests;
+        nlohmann::json request = nlohmann::json::parse(req.body);
+        nlohmann::json response;
+        response["results"] = nlohmann::json::array();
+        for (const auto& wl : request["dpu_workloads"]) {
+            nlohmann::json result;
+            result["info"] = "success";
+            result["latencies"] = std::vector<CyclesInterfaceType>{1000 + wl["output_0_channels"].get<unsigned>()};
+            response["results"].push_back(result);
+        }
+        res.set_content(response.dump(), "application/json");
+        res.status = 200;
+    });
+
+    const auto set_env = [](const char* name, const std::string& value) {
+#ifdef _WIN32
+        _putenv_s(name, value.c_str());
+#else
+        if (value.empty()) {
+            unsetenv(name);
+        } else {
+            setenv(name, value.c_str(), 1);
+        }
+#endif
+    };
+    set_env("ENABLE_VPUNN_PROFILING_SERVICE", "TRUE");
+    set_env("VPUNN_PROFILING_SERVICE_HOST", "localhost");
+    set_env("VPUNN_PROFILING_SERVICE_PORT", std::to_string(srv_port));
+    VPUCostModel model{VPU_2_7_MODEL_PATH};
+    set_env("ENABLE_VPUNN_PROFILING_SERVICE", "");
+    set_env("VPUNN_PROFILING_SERVICE_HOST", "");
+    set_env("VPUNN_PROFILING_SERVICE_PORT", "");
+
+    std::vector<DPUWorkload> workloads;
+    for (unsigned int channels : {16u, 32u, 48u, 64u}) {
+        DPUWorkload wl{VPUDevice::VPU_2_7,
+                       Operation::CONVOLUTION,
+                       {VPUTensor(28, 28, channels, 1, DataType::UINT8)},  // input dimensions
+                       {VPUTensor(28, 28, channels, 1, DataType::UINT8)},  // output dimensions
+                       {3, 3},                                             // kernels
+                       {1, 1},                                             // strides
+                       {1, 1, 1, 1},                                       // padding
+                       ExecutionMode::CUBOID_16x16};
+        wl.cost_source_hint = (channels == 48) ? CostSourceHint::AUTO : CostSourceHint::PROFILING_SERVICE;
+        workloads.push_back(wl);
+    }
+
+    const auto costs = model.DPU_each(workloads);
+
+    ASSERT_EQ(costs.size(), workloads.size());
+    for (size_t i = 0; i < costs.size(); ++i) {
+        EXPECT_EQ(costs[i], 1000 + workloads[i].outputs[0].channels()) << i;
+    }
+    EXPECT_EQ(batch_requests.load(), 1);
+    EXPECT_EQ(single_requests.load(), 0);
+}
+
 // Additional tests can be added here to cover more scenarios as needed
 
 #endif
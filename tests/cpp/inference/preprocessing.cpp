@@ -1137,6 +1137,31 @@ TEST_F(TestPreprocessing_Interface13, SingleWLTestPreprocessing) {
     std::vector<float> result = pp.transformSingle(wl);
     EXPECT_EQ(result.size(), descriptor_expected_size);
 }
+// The in place transformations write the same descriptors as the ones returning vectors
+TEST_F(TestPreprocessing_Interface13, TransformInPlaceSameAsVector) {
+    auto pp = Preprocessing_Interface13<float>();
+    const size_t size{pp.output_size()};
+    DPUWorkload wl_2{wl};
+    wl_2.op = Operation::ELTWISE;
+    wl_2.kernels = {1, 1};
+    const std::vector<DPUWorkload> wls{wl, wl_2};
+
+    std::vector<float> single(size, 7.0F);  // dirty memory is overwritten
+    pp.transformSingleInto(wl_2, single.data());
+    EXPECT_EQ(single, pp.transformSingle(wl_2));
+
+    const unsigned int pad{4};
+    std::vector<float> batch(pad * size, 7.0F);
+    pp.transformBatchInto(wls, batch.data(), pad);
+    const std::vector<float> expected_batch{pp.transformBatch(wls, pad)};
+    ASSERT_EQ(expected_batch.size(), batch.size());
+    EXPECT_EQ(batch, expected_batch);
+    EXPECT_EQ(std::vector<float>(batch.cbegin(), batch.cbegin() + size), pp.transformSingle(wl));
+    EXPECT_TRUE(std::all_of(batch.cbegin() + 2 * size, batch.cend(), [](float v) {
+        return v == 0.0F;
+    }));
+}
+
 // Demonstrate basic creation and size
 TEST_F(TestPreprocessing_Interface13, CreationAndSize) {
     auto pp = Preprocessing_Interface13<float>();
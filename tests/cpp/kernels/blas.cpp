@@ -0,0 +1,115 @@
+// Copyright © 2025 Intel Corporation
+// SPDX-License-Identifier: Apache 2.0
+// LEGAL NOTICE: Your use of this software and any required dependent software (the “Software Package”)
+// is subject to the terms and conditions of the software license agreements for the Software Package,
+// which may also include notices, disclaimers, or license terms for third party or open source software
+// included in or with the Software Package, and your use indicates your acceptance of all such terms.
+// Please refer to the “third-party-programs.txt” or other similarly-named text file included with the
+// Software Package for additional details.
+
+#ifdef VPUNN_INTERNAL_BLAS
+#include "kernels/sgemm_kernels.h"
+#endif
+
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+/// @brief namespace for Unit tests of the C++ library
+namespace VPUNN_unit_tests {
+
+#ifdef VPUNN_INTERNAL_BLAS
+class TestSgemmKernels : public testing::Test {
+protected:
+    /// one call of cblas_sgemm, in a layout that has its own kernels
+    struct Layout {
+        CBLAS_LAYOUT layout;
+        CBLAS_TRANSPOSE trans_a;
+        CBLAS_TRANSPOSE trans_b;
+        float alpha;
+        float beta;
+    };
+
+    /// sizes with odd M, N not a multiple of 4, K not a multiple of 16 (vector tails in every direction)
+    struct Sizes {
+        int M;
+        int N;
+        int K;
+    };
+
+    std::mt19937 gen{42};
+
+    /// a matrix of rows x cols with leading dimension ld, the last row is not padded so overreads are out of bounds
+    std::vector<float> random_matrix(const int rows, const int cols, const int ld) {
+        std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+        std::vector<float> m(static_cast<size_t>((rows - 1) * ld + cols));
+        for (auto& v : m) {
+            v = dist(gen);
+        }
+        return m;
+    }
+
+    /// compares a kernel set with the naive implementation, also on the padding of C that must be left untouched
+    void compare_with_naive(const VPUNN_SGEMM_KERNELS kernels, const Layout& l, const Sizes& s, const int pad) {
+        const int M{s.M}, N{s.N}, K{s.K};
+        const bool row_major{l.layout == CblasRowMajor};
+        // stored shapes of A, B and C (rows x cols, in the storage order of the layout)
+        const int a_rows{row_major ? M : K}, a_cols{row_major ? K : M};
+        const int b_rows{row_major ? ((l.trans_b == CblasTrans) ? N : K) : K};
+        const int b_cols{row_major ? ((l.trans_b == CblasTrans) ? K : N) : N};
+        const int c_rows{row_major ? M : N}, c_cols{row_major ? N : M};
+        const int lda{a_cols + pad}, ldb{b_cols + pad}, ldc{c_cols + pad};
+
+        const auto A{random_matrix(a_rows, a_cols, lda)};
+        const auto B{random_matrix(b_rows, b_cols, ldb)};
+        const auto C_init{random_matrix(c_rows, c_cols, ldc)};
+
+        auto C_naive{C_init};
+        vpunn_sgemm(VpunnSgemmNaive, l.layout, l.trans_a, l.trans_b, M, N, K, l.alpha, A.data(), lda, B.data(), ldb,
+                    l.beta, C_naive.data(), ldc);
+        auto C{C_init};
+        vpunn_sgemm(kernels, l.layout, l.trans_a, l.trans_b, M, N, K, l.alpha, A.data(), lda, B.data(), ldb, l.beta,
+                    C.data(), ldc);
+        auto C_best{C_init};
+        cblas_sgemm(l.layout, l.trans_a, l.trans_b, M, N, K, l.alpha, A.data(), lda, B.data(), ldb, l.beta,
+                    C_best.data(), ldc);
+
+        for (size_t i = 0; i < C.size(); ++i) {
+            EXPECT_NEAR(C[i], C_naive[i], 1e-4f * static_cast<float>(K))
+                    << "kernels " << kernels << ", layout " << l.layout << ", M " << M << " N " << N << " K " << K
+                    << " pad " << pad << ", index " << i;
+            EXPECT_NEAR(C_best[i], C_naive[i], 1e-4f * static_cast<float>(K)) << "cblas_sgemm, index " << i;
+        }
+    }
+};
+
+TEST_F(TestSgemmKernels, EveryKernelSameAsNaive) {
+    const std::vector<Layout> layouts{
+            {CblasRowMajor, CblasNoTrans, CblasTrans, 1.0f, 0.0f},    // rm_ntt_10 kernels (fully connected)
+            {CblasRowMajor, CblasNoTrans, CblasNoTrans, 1.0f, 0.0f},  // rm_nn kernels (bias)
+            {CblasRowMajor, CblasNoTrans, CblasNoTrans, 0.5f, 2.0f},
+            {CblasColMajor, CblasNoTrans, CblasTrans, 1.0f, 0.0f},  // cm_nt kernels (kNN)
+            {CblasColMajor, CblasNoTrans, CblasTrans, -1.5f, 0.5f},
+            {CblasRowMajor, CblasNoTrans, CblasTrans, 1.0f, 1.0f},  // not optimized, always naive
+    };
+    const std::vector<Sizes> sizes{{1, 1, 1}, {3, 5, 7}, {7, 13, 33}, {17, 9, 47}, {5, 31, 77}, {9, 7, 129}};
+
+    int tested_kernels{0};
+    for (const auto kernels : {VpunnSgemmDefault, VpunnSgemmAVX2, VpunnSgemmAVX512}) {
+        if (!vpunn_sgemm_kernels_supported(kernels)) {
+            continue;
+        }
+        ++tested_kernels;
+        for (const auto& l : layouts) {
+            for (const auto& s : sizes) {
+                for (const int pad : {0, 3}) {
+                    compare_with_naive(kernels, l, s, pad);
+                }
+            }
+        }
+    }
+    EXPECT_GE(tested_kernels, 1);
+}
+#endif  // VPUNN_INTERNAL_BLAS
+
+}  // namespace VPUNN_unit_tests
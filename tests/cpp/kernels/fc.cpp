@@ -59,4 +59,36 @@ TEST_F(TestFCLayer, BasicAssertions) {
         }
     }
 }
+
+/// The sparse input FC gives the same result as the dense one for one-hot like inputs, and declines the other inputs
+TEST_F(TestFCLayer, SparseInputSameAsDense) {
+    for (unsigned int batch_size : {1u, 3u}) {
+        for (unsigned int output_channels : {1u, 20u, 250u}) {
+            for (unsigned int input_channels : {1u, 10u, 71u, 500u}) {
+                for (unsigned int nonzero_step : {1u, 3u, 7u, 11u, 16u}) {
+                    auto weights = VPUNN::random_uniform<float>({output_channels, input_channels}, -10.0f, 10.0f);
+                    auto input = VPUNN::zeros<float>({batch_size, input_channels});
+                    unsigned int nonzero{0};
+                    for (unsigned int i = 1; i < batch_size * input_channels; i += nonzero_step) {
+                        input[i] = (i % 2) ? 1.0f : 2.5f;
+                        ++nonzero;
+                    }
+                    auto output = VPUNN::zeros<float>({batch_size, output_channels});
+                    auto expected_output = VPUNN::zeros<float>({batch_size, output_channels});
+                    output.fill(123.0f);  // previous content is not relevant
+
+                    VPUNN::Dense(&weights, &input, &expected_output);
+                    const bool computed{VPUNN::DenseSparseInput(&weights, &input, &output)};
+
+                    const bool sparse{(nonzero * 8 <= input_channels) && (nonzero <= 32)};
+                    EXPECT_EQ(computed, (batch_size == 1) && sparse)
+                            << "batch: " << batch_size << ", input: " << input_channels << ", nonzero: " << nonzero;
+                    for (int idx = 0; computed && (idx < output.size()); idx++) {
+                        EXPECT_NEAR(output[idx], expected_output[idx], 1e-3f) << "idx: " << idx;
+                    }
+                }
+            }
+        }
+    }
+}
 }  // namespace VPUNN_unit_tests
@@ -28,6 +28,91 @@ TEST_F(VPULayerCostModelTestVPU2x, LayerCostModelVPU_2_0) {
     EXPECT_GT(vpu20_layer_cost, 0u);
 }
 
+TEST_F(VPULayerCostModelTestVPU2x, LayerCostModelVPU_2_7_ParallelStrategies) {
+    VPULayerCostModel& model{model_2_7_no_dma};
+    std::vector<DPULayer> layers;
+    for (unsigned int dim : {16u, 28u, 56u}) {
+        auto layer = generate_helper_layer(dim, 64);
+        layer.device = VPUDevice::VPU_2_7;
+        layers.push_back(layer);
+    }
+
+    std::vector<CyclesInterfaceType> sequential_costs;
+    std::vector<DPULayer> sequential_layers{layers};
+    for (auto& layer : sequential_layers) {
+        sequential_costs.push_back(model.Layer(layer, 2, 2));
+    }
+
+    model.set_strategy_threads(4);
+    EXPECT_EQ(model.get_strategy_threads(), 4u);
+    for (size_t i = 0; i < layers.size(); i++) {
+        DPULayer layer{layers[i]};
+        EXPECT_EQ(model.Layer(layer, 2, 2), sequential_costs[i]) << layer;
+        EXPECT_EQ(layer, sequential_layers[i]) << "same adjustments of the layer as sequential";
+    }
+
+    model.set_strategy_threads(1);
+    EXPECT_EQ(model.get_strategy_threads(), 1u);
+}
+
+TEST_F(VPULayerCostModelTestVPU2x, LayerCostModelVPU_2_7_IntraTileSplitMemo) {
+    VPULayerCostModel& model{model_2_7_no_dma};
+    auto layer = generate_helper_layer(56, 64);
+    layer.device = VPUDevice::VPU_2_7;
+    const VPULayerStrategy strategy{2, 1, 2, VPUTilingStrategy::SOH_Overlapped, false, false, true};
+
+    EXPECT_EQ(model.get_intraTileSplitMemo_size(), 0u);
+    DPULayer first_layer{layer};
+    LayerSplitInfo first_split;
+    const auto first_cost = model.Layer(first_layer, strategy, first_split);
+    const auto remembered = model.get_intraTileSplitMemo_size();
+    EXPECT_GT(remembered, 0u);
+    EXPECT_LE(remembered, first_split.size());
+
+    // identical query: all tiles are found, same detailed result
+    DPULayer second_layer{layer};
+    LayerSplitInfo second_split;
+    EXPECT_EQ(model.Layer(second_layer, strategy, second_split), first_cost);
+    EXPECT_EQ(model.get_intraTileSplitMemo_size(), remembered);
+    ASSERT_EQ(second_split.size(), first_split.size());
+    for (size_t i = 0; i < first_split.size(); i++) {
+        EXPECT_EQ(second_split[i].inter_tile_split_layer, first_split[i].inter_tile_split_layer) << i;
+        EXPECT_EQ(second_split[i].best_intra_tile_split, first_split[i].best_intra_tile_split) << i;
+        EXPECT_EQ(second_split[i].all_intra_tile_splits.size(), first_split[i].all_intra_tile_splits.size()) << i;
+    }
+
+    // without the details, the remembered best split is used
+    DPULayer third_layer{layer};
+    EXPECT_EQ(model.Layer(third_layer, strategy), first_cost);
+    EXPECT_EQ(model.get_intraTileSplitMemo_size(), remembered);
+}
+
+/// tiles equal but for the cost source hints are costed by different providers, they are different memo entries
+TEST_F(VPULayerCostModelTestVPU2x, IntraTileSplitMemo_CostSourceHintsInKey) {
+    IntraTileSplitMemo memo{16};
+    DPULayer tile{generate_helper_layer(56, 64)};
+    tile.device = VPUDevice::VPU_2_7;
+    SplitOptions options;
+    options.nDPU = 2;
+
+    DPULayer profiled{tile};
+    profiled.cost_source_hint = CostSourceHint::PROFILING_SERVICE;
+    DPULayer on_silicon{profiled};
+    on_silicon.profiling_service_backend_hint = ProfilingServiceBackend::SILICON;
+    ASSERT_TRUE((profiled == tile) && (on_silicon == tile)) << "the hints are outside of the layer equality";
+
+    memo.add(tile, options, {1000, {}}, nullptr);
+    EXPECT_FALSE(memo.get(profiled, options, nullptr).has_value());
+    EXPECT_FALSE(memo.get(on_silicon, options, nullptr).has_value());
+
+    memo.add(profiled, options, {2000, {}}, nullptr);
+    memo.add(on_silicon, options, {3000, {}}, nullptr);
+    EXPECT_EQ(memo.size(), 3u);
+    EXPECT_EQ(memo.get(tile, options, nullptr)->first, 1000u);
+    EXPECT_EQ(memo.get(profiled, options, nullptr)->first, 2000u);
+    EXPECT_EQ(memo.get(on_silicon, options, nullptr)->first, 3000u);
+}
+
 TEST_F(VPULayerCostModelTestVPU2x, LayerCostModelVPU_2_7_shv_workload) {
     auto layer = generate_helper_shave_wl_layer(VPUNN::VPUDevice::VPU_2_7, 16, 64);
     auto vpu20_layer_cost = layer_models.getModel(VPUDevice::VPU_2_7).Layer(layer, 5, 4);
@@ -1135,6 +1135,32 @@ TEST_F(ShaveCollectionTest, instanceHolder27_Classic_Smoke) {
     }
 }
 
+TEST_F(ShaveCollectionTest, FindByOpId_SameAsByName_NPU40) {
+    ShaveInstanceHolder_NPU40 ih;
+    const DeviceShaveContainer& list = ih.getContainer();
+
+    for (const auto& name : list.getShaveList()) {
+        const ShaveOpExecutor* by_id{list.findShaveExecutor(ShaveOpIds::intern(name))};
+        ASSERT_NE(by_id, nullptr) << name;
+        EXPECT_EQ(by_id, &list.getShaveExecutor(name)) << name;
+    }
+
+    const ShaveOpId interned_names{ShaveOpIds::count()};
+    const SHAVEWorkload unknown{"NoSuchOperatorXX", VPUDevice::VPU_4_0, ref_shv_wrkld.get_inputs(),
+                                ref_shv_wrkld.get_outputs()};
+    EXPECT_EQ(unknown.get_op_id(), ShaveOpIds::unknown);
+    EXPECT_EQ(list.findShaveExecutor(unknown.get_op_id()), nullptr);
+    EXPECT_EQ(list.findShaveExecutor(ShaveOpIds::count() + 10), nullptr);
+    EXPECT_EQ(ShaveOpIds::count(), interned_names) << "workloads with unknown names must not grow the table";
+
+    const ShaveCostProvider shaves{};
+    EXPECT_EQ(shaves.get_cost(unknown), Cycles::ERROR_SHAVE_OPERATOR_MISSING);
+    const SHAVEWorkload known{"default", VPUDevice::VPU_4_0, ref_shv_wrkld.get_inputs(),
+                              ref_shv_wrkld.get_outputs()};
+    EXPECT_EQ(known.get_op_id(), ShaveOpIds::intern("default"));
+    EXPECT_EQ(shaves.get_cost(known), list.getShaveExecutor("default").dpuCycles(known));
+}
+
 class ShaveDevicesTest : public ::testing::Test {
 protected:
     void SetUp() override {
@@ -0,0 +1,225 @@
+// Copyright © 2025 Intel Corporation
+// SPDX-License-Identifier: Apache 2.0
+// LEGAL NOTICE: Your use of this software and any required dependent software (the “Software Package”)
+// is subject to the terms and conditions of the software license agreements for the Software Package,
+// which may also include notices, disclaimers, or license terms for third party or open source software
+// included in or with the Software Package, and your use indicates your acceptance of all such terms.
+// Please refer to the “third-party-programs.txt” or other similarly-named text file included with the
+// Software Package for additional details.
+
+#include "vpu/profiling_result_store.h"
+#include "vpu_cost_model.h"
+
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+
+namespace VPUNN_unit_tests {
+using namespace VPUNN;
+
+class ProfilingResultStoreTest : public ::testing::Test {
+protected:
+    const std::string store_file{"profiling_result_store_test.bin"};
+
+    void SetUp() override {
+        std::filesystem::remove(store_file);
+    }
+    void TearDown() override {
+        std::filesystem::remove(store_file);
+    }
+
+    /// sets an environment variable, removes it if the value is empty
+    static void set_env(const char* name, const std::string& value) {
+#ifdef _WIN32
+        _putenv_s(name, value.c_str());
+#else
+        if (value.empty()) {
+            unsetenv(name);
+        } else {
+            setenv(name, value.c_str(), 1);
+        }
+#endif
+    }
+};
+
+TEST_F(ProfilingResultStoreTest, ResultsSurviveReopen) {
+    const uint64_t wl_a{0x123456789ABCDEF0ULL};
+    const uint64_t wl_b{0x5678ULL};
+    {
+        ProfilingResultStore store{store_file};
+        EXPECT_TRUE(store.is_writable());
+        EXPECT_EQ(store.loaded_count(), 0u);
+
+        store.add(wl_a, 1234u, ProfilingServiceBackend::SILICON, 100u);
+        store.add(wl_a, 1234u, ProfilingServiceBackend::VPUEM, 200u);  // same workload, other backend
+        store.add(wl_b, 5678u, ProfilingServiceBackend::SILICON, 300u);
+        store.add(wl_b, 5678u, ProfilingServiceBackend::SILICON, 301u);                             // replaces
+        store.add(9999u, 9999u, ProfilingServiceBackend::SILICON, Cycles::ERROR_PROFILING_SERVICE);  // not stored
+        store.add(9999u, 9999u, ProfilingServiceBackend::__size, 10u);                               // not stored
+
+        EXPECT_EQ(store.get(wl_a, 1234u, ProfilingServiceBackend::SILICON).value_or(0), 100u);
+        EXPECT_EQ(store.get(wl_b, 5678u, ProfilingServiceBackend::SILICON).value_or(0), 301u);
+        EXPECT_EQ(store.size(), 3u);
+    }  // written at destruction at the latest
+
+    ProfilingResultStore reopened{store_file};
+    EXPECT_EQ(reopened.loaded_count(), 3u);
+    EXPECT_EQ(reopened.skipped_count(), 0u);
+    EXPECT_EQ(reopened.get(wl_a, 1234u, ProfilingServiceBackend::SILICON).value_or(0), 100u);
+    EXPECT_EQ(reopened.get(wl_a, 1234u, ProfilingServiceBackend::VPUEM).value_or(0), 200u);
+    EXPECT_EQ(reopened.get(wl_b, 5678u, ProfilingServiceBackend::SILICON).value_or(0), 301u);
+    EXPECT_FALSE(reopened.get(wl_b, 5678u, ProfilingServiceBackend::VPUEM).has_value());
+    EXPECT_FALSE(reopened.get(9999u, 9999u, ProfilingServiceBackend::SILICON).has_value());
+}
+
+TEST_F(ProfilingResultStoreTest, FingerprintDetectsCollision) {
+    ProfilingResultStore store{store_file};
+    store.add(42u, 1u, ProfilingServiceBackend::SILICON, 100u);
+    EXPECT_EQ(store.get(42u, 1u, ProfilingServiceBackend::SILICON).value_or(0), 100u);
+    EXPECT_FALSE(store.get(42u, 2u, ProfilingServiceBackend::SILICON).has_value())
+            << "same 64 bit hash, other workload";
+}
+
+TEST_F(ProfilingResultStoreTest, FlushWritesAppendOnly) {
+    ProfilingResultStore store{store_file};
+    store.add(1u, 1u, ProfilingServiceBackend::SILICON, 10u);
+    store.add(1u, 1u, ProfilingServiceBackend::SILICON, 10u);  // same value, not written again
+    store.add(2u, 2u, ProfilingServiceBackend::SILICON, 20u);
+    store.flush();
+    EXPECT_EQ(std::filesystem::file_size(store_file),
+              ProfilingResultStore::file_magic.size() + 2 * ProfilingResultStore::record_size);
+
+    store.add(2u, 2u, ProfilingServiceBackend::SILICON, 21u);
+    store.flush();
+    EXPECT_EQ(std::filesystem::file_size(store_file),
+              ProfilingResultStore::file_magic.size() + 3 * ProfilingResultStore::record_size);
+}
+
+TEST_F(ProfilingResultStoreTest, InterruptedRecordIsSkipped) {
+    {
+        ProfilingResultStore store{store_file};
+        store.add(1u, 1u, ProfilingServiceBackend::SILICON, 10u);
+    }
+    {
+        std::ofstream file(store_file, std::ios::binary | std::ios::app);
+        file.write("\x02\x00\x00", 3);  // a record cut by a crash
+    }
+    const auto size_with_cut_record{std::filesystem::file_size(store_file)};
+    {
+        ProfilingResultStore store{store_file};
+        EXPECT_TRUE(store.is_writable());
+        EXPECT_EQ(store.loaded_count(), 1u);
+        EXPECT_EQ(std::filesystem::file_size(store_file), size_with_cut_record) << "never truncated";
+        store.add(3u, 3u, ProfilingServiceBackend::VPUEM, 30u);  // appended after the cut record
+    }
+    ProfilingResultStore store{store_file};
+    EXPECT_EQ(store.loaded_count(), 2u);
+    EXPECT_EQ(store.skipped_count(), 1u);
+    EXPECT_EQ(store.get(1u, 1u, ProfilingServiceBackend::SILICON).value_or(0), 10u);
+    EXPECT_EQ(store.get(3u, 3u, ProfilingServiceBackend::VPUEM).value_or(0), 30u);
+}
+
+TEST_F(ProfilingResultStoreTest, DamagedRecordIsSkipped) {
+    {
+        ProfilingResultStore store{store_file};
+        for (uint32_t i = 0; i < 3; ++i) {
+            store.add(i, i, ProfilingServiceBackend::SILICON, 100u + i);
+        }
+    }
+    {  // one bit changed in the cycles of the middle record
+        std::fstream file(store_file, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(static_cast<std::streamoff>(ProfilingResultStore::file_magic.size() +
+                                               ProfilingResultStore::record_size + 16));
+        file.put('\x7F');
+    }
+    ProfilingResultStore store{store_file};
+    EXPECT_EQ(store.loaded_count(), 2u);
+    EXPECT_EQ(store.skipped_count(), 1u);
+    EXPECT_EQ(store.get(0u, 0u, ProfilingServiceBackend::SILICON).value_or(0), 100u);
+    EXPECT_FALSE(store.get(1u, 1u, ProfilingServiceBackend::SILICON).has_value());
+    EXPECT_EQ(store.get(2u, 2u, ProfilingServiceBackend::SILICON).value_or(0), 102u);
+}
+
+TEST_F(ProfilingResultStoreTest, ConcurrentWritersShareTheFile) {
+    constexpr uint32_t per_writer{500};
+    {
+        // like two compiler processes: each store has its own descriptor on the same file
+        ProfilingResultStore first{store_file};
+        ProfilingResultStore second{store_file};
+        ASSERT_TRUE(first.is_writable());
+        ASSERT_TRUE(second.is_writable());
+        std::thread t1([&]() {
+            for (uint32_t i = 0; i < per_writer; ++i) {
+                first.add(i, i, ProfilingServiceBackend::SILICON, 1000u + i);
+            }
+        });
+        std::thread t2([&]() {
+            for (uint32_t i = per_writer; i < 2 * per_writer; ++i) {
+                second.add(i, i, ProfilingServiceBackend::SILICON, 1000u + i);
+            }
+        });
+        t1.join();
+        t2.join();
+    }
+    ProfilingResultStore store{store_file};
+    EXPECT_EQ(store.loaded_count(), 2u * per_writer);
+    EXPECT_EQ(store.skipped_count(), 0u);
+    for (uint32_t i = 0; i < 2 * per_writer; ++i) {
+        ASSERT_EQ(store.get(i, i, ProfilingServiceBackend::SILICON).value_or(0), 1000u + i) << i;
+    }
+}
+
+TEST_F(ProfilingResultStoreTest, ForeignFileIsNotChanged) {
+    const std::string foreign_content{"this is not a store"};
+    {
+        std::ofstream file(store_file, std::ios::binary);
+        file << foreign_content;
+    }
+    {
+        ProfilingResultStore store{store_file};
+        EXPECT_FALSE(store.is_writable());
+        store.add(1u, 1u, ProfilingServiceBackend::SILICON, 10u);
+        EXPECT_EQ(store.get(1u, 1u, ProfilingServiceBackend::SILICON).value_or(0), 10u);  // still usable in memory
+    }
+    EXPECT_EQ(std::filesystem::file_size(store_file), foreign_content.size());
+}
+
+TEST_F(ProfilingResultStoreTest, CostModelUsesStoredResultsWithoutTheService) {
+    DPUWorkload wl{VPUDevice::VPU_2_7,
+                   Operation::CONVOLUTION,
+                   {VPUTensor(28, 28, 32, 1, DataType::UINT8)},  // input dimensions
+                   {VPUTensor(28, 28, 32, 1, DataType::UINT8)},  // output dimensions
+                   {3, 3},                                       // kernels
+                   {1, 1},                                       // strides
+                   {1, 1, 1, 1},                                 // padding
+                   ExecutionMode::CUBOID_16x16};
+    const CyclesInterfaceType stored_cycles{123456};
+
+    set_env("VPUNN_PROFILING_SERVICE_STORE", store_file);
+    CyclesInterfaceType nn_cycles{0};
+    {
+        VPUCostModel model{VPU_2_7_MODEL_PATH};
+        DPUWorkload sanitized{wl};
+        SanityReport report;
+        ASSERT_TRUE(model.sanitize_workload(sanitized, report));
+        nn_cycles = model.DPU(wl);  // nothing stored yet
+        ASSERT_FALSE(Cycles::isErrorCode(nn_cycles));
+        ASSERT_NE(nn_cycles, stored_cycles);
+
+        ProfilingResultStore store{store_file};  // as a previous run of the profiling service
+        store.add(sanitized.hash64(), sanitized.hash(), ProfilingServiceBackend::SILICON, stored_cycles);
+    }
+    VPUCostModel model{VPU_2_7_MODEL_PATH};  // no profiling service
+    set_env("VPUNN_PROFILING_SERVICE_STORE", "");
+
+    EXPECT_EQ(model.DPU(wl), stored_cycles);  // preferred to the NN
+    wl.cost_source_hint = CostSourceHint::PROFILING_SERVICE;
+    EXPECT_EQ(model.DPU(wl), stored_cycles);
+    wl.cost_source_hint = CostSourceHint::NN;
+    EXPECT_EQ(model.DPU(wl), nn_cycles);
+}
+
+}  // namespace VPUNN_unit_tests
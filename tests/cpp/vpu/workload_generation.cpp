@@ -259,4 +259,81 @@ TEST_F(WorkloadGeneration, WorkloadGenerationCreateTilerMultipleWLs) {
     }
 }
 
+TEST_F(WorkloadGeneration, SplitCandidatesCostedTogether_SameAsOneByOne) {
+    VPUNN::VPUCostModel model_2_7_threads{VPU_2_7_MODEL_PATH, false, 16384, 1, "", "", false, false, 4};
+
+    for (auto model : {&model_2_0, &model_2_7, &model_2_7_threads}) {
+        const auto device{(model == &model_2_0) ? VPUNN::VPUDevice::VPU_2_0 : VPUNN::VPUDevice::VPU_2_7};
+        for (unsigned int kernel : {1u, 3u}) {
+            const auto layer = generate_helper_layer(device, 56, 64, kernel);
+            std::unique_ptr<VPUNN::IDPUTiler> tiler = VPUNN::getDPUTiler(*model);
+
+            VPUNN::SplitOptions together_options;  // full search, distinct workloads costed in one list
+            together_options.nDPU = 4;
+            VPUNN::SplitOptions one_by_one_options{together_options};  // a time budget costs while generating
+            one_by_one_options.maxLatencyUs = 3600U * 1000U * 1000U;
+
+            std::vector<VPUNN::DPUWorkloadsWithCyclesSplit> together_splits;
+            std::vector<VPUNN::DPUWorkloadsWithCyclesSplit> one_by_one_splits;
+            const auto together{tiler->intraTileSplit(layer, together_options, &together_splits)};
+            const auto one_by_one{tiler->intraTileSplit(layer, one_by_one_options, &one_by_one_splits)};
+
+            EXPECT_EQ(together.first, one_by_one.first) << layer;
+            EXPECT_EQ(together.second, one_by_one.second) << layer;
+            ASSERT_EQ(together_splits.size(), one_by_one_splits.size()) << layer;
+            for (size_t i = 0; i < together_splits.size(); i++) {
+                EXPECT_EQ(together_splits[i].workloads, one_by_one_splits[i].workloads) << i;
+                EXPECT_EQ(together_splits[i].cycles, one_by_one_splits[i].cycles) << i;
+            }
+        }
+    }
+}
+
+/// the pruned search gives the same best split as the full one, on a sweep of layers and devices
+TEST_F(WorkloadGeneration, SplitCandidatesPrunedByLowerBound_SameBestSplit) {
+    for (auto model : {&model_2_0, &model_2_7}) {
+        const auto device{(model == &model_2_0) ? VPUNN::VPUDevice::VPU_2_0 : VPUNN::VPUDevice::VPU_2_7};
+        size_t pruned_count{0};
+        for (const auto op : {VPUNN::Operation::CONVOLUTION, VPUNN::Operation::DW_CONVOLUTION,
+                              VPUNN::Operation::ELTWISE, VPUNN::Operation::MAXPOOL}) {
+            for (const auto dtype : {VPUNN::DataType::FLOAT16, VPUNN::DataType::UINT8}) {
+                for (unsigned int dim : {28u, 56u}) {
+                    for (unsigned int channels : {32u, 128u}) {
+                        for (unsigned int kernel : {1u, 3u}) {
+                            if ((op == VPUNN::Operation::ELTWISE) && (kernel != 1)) {
+                                continue;
+                            }
+                            const VPUNN::DPULayer layer(device, op, {VPUNN::VPUTensor(dim, dim, channels, 1, dtype)},
+                                                        {VPUNN::VPUTensor(dim, dim, channels, 1, dtype)},
+                                                        {kernel, kernel}, {1, 1},
+                                                        {kernel / 2, kernel / 2, kernel / 2, kernel / 2});
+                            std::unique_ptr<VPUNN::IDPUTiler> tiler = VPUNN::getDPUTiler(*model);
+
+                            VPUNN::SplitOptions full_options;
+                            full_options.nDPU = 4;
+                            VPUNN::SplitOptions pruned_options{full_options};
+                            pruned_options.pruneByLowerBound = true;
+
+                            std::vector<VPUNN::DPUWorkloadsWithCyclesSplit> full_splits;
+                            std::vector<VPUNN::DPUWorkloadsWithCyclesSplit> pruned_splits;
+                            const auto full{tiler->intraTileSplit(layer, full_options, &full_splits)};
+                            EXPECT_EQ(tiler->get_pruned_candidates_count(), 0u);
+                            const auto pruned{tiler->intraTileSplit(layer, pruned_options, &pruned_splits)};
+
+                            EXPECT_EQ(full.first, pruned.first) << layer;
+                            EXPECT_EQ(full.second, pruned.second) << layer;
+                            EXPECT_EQ(full_splits.size(), pruned_splits.size() + tiler->get_pruned_candidates_count())
+                                    << layer;
+                            pruned_count += tiler->get_pruned_candidates_count();
+                        }
+                    }
+                }
+            }
+        }
+        if (model == &model_2_0) {  // the lower bound is tight enough here to skip some candidates
+            EXPECT_GT(pruned_count, 0u);
+        }
+    }
+}
+
 }  // namespace VPUNN_unit_tests